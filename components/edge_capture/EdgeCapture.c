@@ -0,0 +1,92 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	EdgeCapture.c
+
+  Abstract:
+
+	The implementation file of the MCPWM edge timestamp capture
+*/
+
+#include <EdgeCapture.h>
+#include "hal/mcpwm_ll.h"
+#include "RadarTrigger.h"
+
+
+/* MCPWM capture timer */
+static mcpwm_cap_timer_handle_t cap_timer;
+
+/* MCPWM capture channels */
+static mcpwm_cap_channel_handle_t cap_channels[3];
+
+/* The capture channel of the counted input */
+static volatile int inputChannel = EDGE_CAPTURE_ENCODER_CHANNEL;
+
+/* Create a capture channel on the given GPIO */
+static void newCaptureChannel(int channel, int gpio, bool posEdge, bool loopBack)
+{
+    mcpwm_capture_channel_config_t cap_ch_conf = {
+        .gpio_num = gpio,
+        .prescale = 1,
+        .flags.pos_edge = posEdge,
+        .flags.neg_edge = !posEdge,
+        .flags.io_loop_back = loopBack,
+    };
+    ESP_ERROR_CHECK(mcpwm_new_capture_channel(cap_timer, &cap_ch_conf, &cap_channels[channel]));
+}
+
+/* Initialize the capture timer and channels */
+void edgeCaptureInitialize(void)
+{
+    /* Set the log level */
+    static const char *TAG = "EDGE_CAPTURE_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    /* install the capture timer */
+    mcpwm_capture_timer_config_t cap_conf = {
+        .group_id = EDGE_CAPTURE_GROUP_ID,
+        .clk_src = MCPWM_CAPTURE_CLK_SRC_DEFAULT,
+    };
+    ESP_ERROR_CHECK(mcpwm_new_capture_timer(&cap_conf, &cap_timer));
+
+    /* the counted edges (falling) and the trigger edge (rising), the output pins stay outputs */
+    newCaptureChannel(EDGE_CAPTURE_ENCODER_CHANNEL, PCNT_INPUT_EDGE_IO, false, false);
+    newCaptureChannel(EDGE_CAPTURE_TRIGGER_CHANNEL, RADAR_TRIGGER_OUTPUT_IO, true, true);
+    newCaptureChannel(EDGE_CAPTURE_STEP_CHANNEL, PCNT_INPUT_STEP_IO, false, true);
+
+    /* Enable and start the capture timer */
+    ESP_ERROR_CHECK(mcpwm_capture_timer_enable(cap_timer));
+    ESP_ERROR_CHECK(mcpwm_capture_timer_start(cap_timer));
+    ESP_LOGI(TAG, "Edge capture is running at %d Hz", EDGE_CAPTURE_RESOLUTION_HZ);
+}
+
+/* Select the pulse counter input whose edges are captured */
+void edgeCaptureSelectInput(pcnt_input_t input)
+{
+    inputChannel = (input == PCNT_INPUT_STEP) ? EDGE_CAPTURE_STEP_CHANNEL : EDGE_CAPTURE_ENCODER_CHANNEL;
+}
+
+/* Capture time of the last counted input edge (ISR safe) */
+uint32_t IRAM_ATTR edgeCaptureGetInputTicks(void)
+{
+    return mcpwm_ll_capture_get_value(MCPWM_LL_GET_HW(EDGE_CAPTURE_GROUP_ID), inputChannel);
+}
+
+/* Capture time of the last radar trigger edge */
+uint32_t edgeCaptureGetTriggerTicks(void)
+{
+    return mcpwm_ll_capture_get_value(MCPWM_LL_GET_HW(EDGE_CAPTURE_GROUP_ID), EDGE_CAPTURE_TRIGGER_CHANNEL);
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	EdgeCapture.h
+
+  Abstract:
+
+	The header file of the MCPWM edge timestamp capture
+*/
+
+#ifndef EDGE_CAPTURE_H
+#define EDGE_CAPTURE_H
+
+#include "Config.h"
+#include "PulseCounter.h"
+#include "driver/mcpwm_prelude.h"
+
+
+// The capture timer runs from the APB clock
+#define EDGE_CAPTURE_GROUP_ID			0
+#define EDGE_CAPTURE_RESOLUTION_HZ		80000000	// 12.5 ns per tick
+
+/*
+	Capture channels, created in this order on a dedicated MCPWM group.
+	The counted edges are too frequent for an interrupt per edge, so the latched
+	capture registers are read directly when a watch point is reached.
+*/
+#define EDGE_CAPTURE_ENCODER_CHANNEL	0	// falling edges of PCNT_INPUT_EDGE_IO
+#define EDGE_CAPTURE_TRIGGER_CHANNEL	1	// rising edges of the radar trigger output
+#define EDGE_CAPTURE_STEP_CHANNEL		2	// falling edges of PCNT_INPUT_STEP_IO
+
+/* Convert a capture tick difference to nanoseconds (the 32-bit counter wraps every ~53 s) */
+#define EDGE_CAPTURE_TICKS_TO_NS(ticks)	((uint32_t)(ticks) * 25ULL / 2)
+
+/* Initialize the capture timer and channels */
+void edgeCaptureInitialize(void);
+
+/* Select the pulse counter input whose edges are captured */
+void edgeCaptureSelectInput(pcnt_input_t input);
+
+/* Capture time of the last counted input edge (ISR safe) */
+uint32_t edgeCaptureGetInputTicks(void);
+
+/* Capture time of the last radar trigger edge */
+uint32_t edgeCaptureGetTriggerTicks(void);
+
+#endif
\ No newline at end of file
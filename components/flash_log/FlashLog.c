@@ -0,0 +1,473 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	FlashLog.c
+
+  Abstract:
+
+	The implementation file of the trigger log persistence on a flash partition
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include <FlashLog.h>
+#include <Health.h>
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+
+
+_Static_assert(sizeof(flash_log_block_t) == FLASH_LOG_SLOT_BYTES, "a block is one flash page");
+
+/* A task handle for the flash log */
+static TaskHandle_t xFlashLogTask;
+
+/* The task stack and control block */
+static StackType_t xFlashLogStack[FLASH_LOG_TASK_STACK_SIZE_BYTES];
+static StaticTask_t xFlashLogTaskBuffer;
+
+/* The log partition, mapped for reading (reads through the cache do not stop the other core) */
+static const esp_partition_t* pLogPartition = NULL;
+static const flash_log_block_t* pLogSlots = NULL;
+static esp_partition_mmap_handle_t logMapHandle;
+static uint32_t numSlots = 0;
+
+/* The next slot to write and its sequence number (flash log task only) */
+static uint32_t headSlot = 0;
+static uint32_t nextSequence = 0;
+
+/* Records from the radar trigger task (single producer, single consumer) */
+static trigger_record_t recordRing[FLASH_LOG_RING_LENGTH];
+static volatile uint32_t recordHead = 0;
+static volatile uint32_t recordTail = 0;
+
+/* The time of the last record and the interval to the one before it */
+static volatile int64_t lastAppend_us = 0;
+static volatile int64_t lastInterval_us = 0;
+
+/* Records lost because the ring or the pending blocks were full */
+static volatile uint32_t numDropped = 0;
+
+/* Recording state */
+static volatile bool recording = false;
+static volatile bool restartScan = false;
+static volatile bool endScan = false;
+static uint16_t scanId = 0;
+
+/* The block being filled and the blocks waiting for a write gap (flash log task only) */
+static trigger_encoder_t encoder;
+static flash_log_block_t pendingBlocks[FLASH_LOG_PENDING_BLOCKS];
+static uint32_t pendingHead = 0;
+static uint32_t pendingTail = 0;
+
+/* Requests of the host interface */
+static volatile bool eraseRequested = false;
+static volatile int32_t dumpScanId = -1;
+
+/* Send a reply or an event to the host PC */
+extern int transportSendReply(const char* data, uint32_t length);
+extern int transportSendEvent(const char* data, uint32_t length);
+
+/* The CRC of a block, over the header without the CRC and the payload */
+static uint32_t blockCrc(const flash_log_block_t* pBlock)
+{
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t*)pBlock, offsetof(flash_log_block_t, crc));
+    return esp_rom_crc32_le(crc, pBlock->data, pBlock->size);
+}
+
+/* Whether a slot holds a complete block */
+static bool isValid(const flash_log_block_t* pBlock)
+{
+    return (pBlock->magic == FLASH_LOG_BLOCK_MAGIC) && (pBlock->size <= TRIGGER_CODEC_BLOCK_BYTES) &&
+           (pBlock->crc == blockCrc(pBlock));
+}
+
+/* Whether the header of a slot is erased */
+static bool isBlank(const flash_log_block_t* pBlock)
+{
+    const uint32_t* pWords = (const uint32_t*)pBlock;
+    for (int i = 0; i < offsetof(flash_log_block_t, data) / sizeof(uint32_t); i++) {
+        if (pWords[i] != UINT32_MAX) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Whether every slot of a sector is erased */
+static bool isSectorBlank(uint32_t sector)
+{
+    for (uint32_t i = 0; i < FLASH_LOG_SLOTS_PER_SECTOR; i++) {
+        if (!isBlank(&pLogSlots[sector * FLASH_LOG_SLOTS_PER_SECTOR + i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Find the slot after the newest block, it is where the writer goes on */
+static void findHead(void)
+{
+    bool found = false;
+    uint32_t newest = 0;
+
+    for (uint32_t slot = 0; slot < numSlots; slot++) {
+        const flash_log_block_t* pBlock = &pLogSlots[slot];
+        if (isValid(pBlock) && (!found || (int32_t)(pBlock->sequence - pLogSlots[newest].sequence) > 0)) {
+            newest = slot;
+            found = true;
+        }
+    }
+
+    headSlot = 0;
+    nextSequence = 0;
+    if (found) {
+        headSlot = (newest + 1) % numSlots;
+        nextSequence = pLogSlots[newest].sequence + 1;
+        scanId = pLogSlots[newest].scanId;
+    }
+
+    /* a write cut by a reset: go on in the next sector, it is erased before it is written */
+    if (!isBlank(&pLogSlots[headSlot])) {
+        headSlot = ((headSlot / FLASH_LOG_SLOTS_PER_SECTOR + 1) * FLASH_LOG_SLOTS_PER_SECTOR) % numSlots;
+    }
+}
+
+/* Erase the sectors ahead of the writer that still hold old blocks (only at the start and the end of a scan) */
+static void eraseAhead(void)
+{
+    uint32_t numSectors = numSlots / FLASH_LOG_SLOTS_PER_SECTOR;
+    uint32_t sector = headSlot / FLASH_LOG_SLOTS_PER_SECTOR;
+
+    /* the rest of the head sector is blank unless the writer starts it */
+    if (headSlot % FLASH_LOG_SLOTS_PER_SECTOR != 0) {
+        sector = (sector + 1) % numSectors;
+    }
+    for (int i = 0; i < FLASH_LOG_ERASE_AHEAD; i++) {
+        if (!isSectorBlank(sector)) {
+            ESP_ERROR_CHECK(esp_partition_erase_range(pLogPartition, sector * FLASH_LOG_SECTOR_BYTES, FLASH_LOG_SECTOR_BYTES));
+        }
+        sector = (sector + 1) % numSectors;
+    }
+}
+
+/* Write the oldest pending block to the head slot, returns false if the slot is not erased yet */
+static bool writeBlock(void)
+{
+    if (!isBlank(&pLogSlots[headSlot])) {
+        return false;
+    }
+
+    flash_log_block_t* pBlock = &pendingBlocks[pendingTail % FLASH_LOG_PENDING_BLOCKS];
+    pBlock->sequence = nextSequence;
+    pBlock->crc = blockCrc(pBlock);
+    ESP_ERROR_CHECK(esp_partition_write(pLogPartition, headSlot * FLASH_LOG_SLOT_BYTES, pBlock, FLASH_LOG_SLOT_BYTES));
+
+    pendingTail++;
+    nextSequence++;
+    headSlot = (headSlot + 1) % numSlots;
+    return true;
+}
+
+/* Move the filled part of the encoder to the pending blocks */
+static void closeBlock(void)
+{
+    if (encoder.numRecords == 0) {
+        return;
+    }
+
+    if (pendingHead - pendingTail >= FLASH_LOG_PENDING_BLOCKS) {
+        numDropped += encoder.numRecords;
+        healthRecordDrop(HEALTH_QUEUE_FLASH_LOG);
+    }
+    else {
+        flash_log_block_t* pBlock = &pendingBlocks[pendingHead % FLASH_LOG_PENDING_BLOCKS];
+        memset(pBlock, 0xFF, sizeof(*pBlock));
+        pBlock->magic = FLASH_LOG_BLOCK_MAGIC;
+        pBlock->scanId = scanId;
+        pBlock->numRecords = (uint8_t)encoder.numRecords;
+        pBlock->size = (uint8_t)encoder.size;
+        memcpy(pBlock->data, encoder.data, encoder.size);
+        pendingHead++;
+    }
+    triggerEncoderReset(&encoder);
+}
+
+/* Stream the blocks of a scan back as $TRZ events, oldest first */
+static void dumpScan(uint32_t id)
+{
+    static char frame[TRIGGER_CODEC_FRAME_SIZE];
+    static trigger_encoder_t block;
+    uint32_t numBlocks = 0;
+    uint32_t numRecords = 0;
+
+    for (uint32_t i = 0; i < numSlots; i++) {
+        const flash_log_block_t* pBlock = &pLogSlots[(headSlot + i) % numSlots];
+        if (!isValid(pBlock) || pBlock->scanId != id) {
+            continue;
+        }
+
+        /* the block is formatted like a block of the live stream */
+        triggerEncoderReset(&block);
+        memcpy(block.data, pBlock->data, pBlock->size);
+        block.size = pBlock->size;
+        block.numRecords = pBlock->numRecords;
+        uint32_t length = triggerEncoderFormat(&block, numBlocks, 0, frame, sizeof(frame));
+        transportSendEvent(frame, length);
+        numBlocks++;
+        numRecords += pBlock->numRecords;
+    }
+
+    int length = snprintf(frame, sizeof(frame), "$FDE%lu,%lu,%lu#\r\n", id, numBlocks, numRecords);
+    transportSendEvent(frame, length);
+}
+
+/* Erase every sector that is not blank */
+static void eraseAll(void)
+{
+    uint32_t numErased = 0;
+
+    for (uint32_t sector = 0; sector < numSlots / FLASH_LOG_SLOTS_PER_SECTOR; sector++) {
+        if (!isSectorBlank(sector)) {
+            ESP_ERROR_CHECK(esp_partition_erase_range(pLogPartition, sector * FLASH_LOG_SECTOR_BYTES, FLASH_LOG_SECTOR_BYTES));
+            numErased++;
+        }
+    }
+    headSlot = 0;
+    nextSequence = 0;
+    pendingTail = pendingHead;
+
+    char reply[32];
+    int length = snprintf(reply, sizeof(reply), "$FLX%lu#\r\n", numErased);
+    transportSendEvent(reply, length);
+}
+
+/* The Flash Log Task */
+static void flashLogTask(void* params)
+{
+    /* The parameter value is expected to be NULL. */
+    configASSERT(params == NULL);
+
+    trigger_record_t record;
+
+    while (1) {
+        /* Wake up after every record, and every poll period to close the blocks of a pause */
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FLASH_LOG_POLL_MS));
+
+        if (eraseRequested) {
+            eraseRequested = false;
+            eraseAll();
+        }
+        /* the erase only runs on the $FLR commands, never while a scan may be running on its own */
+        if (endScan) {
+            endScan = false;
+            closeBlock();
+            while (pendingTail != pendingHead && writeBlock()) {
+            }
+            eraseAhead();
+        }
+        if (restartScan) {
+            restartScan = false;
+            closeBlock();
+            while (pendingTail != pendingHead && writeBlock()) {
+            }
+            scanId++;
+            eraseAhead();
+        }
+
+        /* encode the new records, full blocks wait for a write gap */
+        while (recordTail != recordHead) {
+            record = recordRing[recordTail % FLASH_LOG_RING_LENGTH];
+            recordTail++;
+            if (!triggerEncoderAdd(&encoder, &record)) {
+                closeBlock();
+                triggerEncoderAdd(&encoder, &record);
+            }
+        }
+
+        /* a pause: the last block is written into the sectors erased at the start */
+        int64_t sinceLast_us = esp_timer_get_time() - lastAppend_us;
+        if (sinceLast_us >= FLASH_LOG_IDLE_MS * 1000LL) {
+            closeBlock();
+            while (pendingTail != pendingHead && writeBlock()) {
+            }
+        }
+        else if (lastInterval_us >= FLASH_LOG_MIN_GAP_US && sinceLast_us <= lastInterval_us / 4 &&
+                 pendingTail != pendingHead) {
+            /* right after a trigger, a page fits before the next one */
+            writeBlock();
+        }
+
+        if (dumpScanId >= 0) {
+            dumpScan((uint32_t)dumpScanId);
+            dumpScanId = -1;
+        }
+    }
+}
+
+/* Initialize the flash log (not recording until enabled) */
+void flashLogInitialize(void)
+{
+    /* Set the log level */
+    static const char *TAG = "FLASH_LOG_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    pLogPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, FLASH_LOG_PARTITION_LABEL);
+    if (pLogPartition == NULL) {
+        ESP_LOGI(TAG, "There is no %s partition, the flash log is off.", FLASH_LOG_PARTITION_LABEL);
+        return;
+    }
+    const void* pMap;
+    ESP_ERROR_CHECK(esp_partition_mmap(pLogPartition, 0, pLogPartition->size, ESP_PARTITION_MMAP_DATA, &pMap, &logMapHandle));
+    pLogSlots = (const flash_log_block_t*)pMap;
+    numSlots = (pLogPartition->size / FLASH_LOG_SECTOR_BYTES) * FLASH_LOG_SLOTS_PER_SECTOR;
+
+    findHead();
+    triggerEncoderReset(&encoder);
+    healthSetQueueCapacity(HEALTH_QUEUE_FLASH_LOG, FLASH_LOG_RING_LENGTH);
+    ESP_LOGI(TAG, "Flash log: %lu slots, next block %lu at slot %lu, last scan %u",
+             numSlots, nextSequence, headSlot, scanId);
+
+    /* Create the task, store the handle. */
+    xFlashLogTask = xTaskCreateStaticPinnedToCore(
+                        flashLogTask,                       /* Function that implements the task. */
+                        "FlashLogTask",                     /* Text name for the task. */
+                        FLASH_LOG_TASK_STACK_SIZE_BYTES,    /* Stack size in bytes. */
+                        NULL,                               /* Parameter passed into the task. */
+                        1,                                  /* Priority at which the task is created. */
+                        xFlashLogStack,                     /* The task stack. */
+                        &xFlashLogTaskBuffer,               /* The task control block. */
+                        1);                                 /* Core number. */
+    if( xFlashLogTask == NULL )
+    {
+        /* The task is not created. */
+        ESP_LOGI(TAG, "The Flash Log Task could not created.");
+    }
+}
+
+/* Start a new scan or stop recording */
+esp_err_t flashLogRecord(bool enable)
+{
+    if (xFlashLogTask == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    /* the task starts the new scan before it takes the first record */
+    if (enable && !recording) {
+        restartScan = true;
+    }
+    else if (!enable && recording) {
+        endScan = true;
+    }
+    recording = enable;
+    xTaskNotifyGive(xFlashLogTask);
+    return ESP_OK;
+}
+
+/* Append a trigger record while recording (radar trigger task only) */
+void flashLogAppend(const trigger_record_t* pRecord)
+{
+    if (!recording) {
+        return;
+    }
+
+    uint32_t head = recordHead;
+    if (head - recordTail >= FLASH_LOG_RING_LENGTH) {
+        numDropped++;
+        healthRecordDrop(HEALTH_QUEUE_FLASH_LOG);
+    }
+    else {
+        recordRing[head % FLASH_LOG_RING_LENGTH] = *pRecord;
+        recordHead = head + 1;
+        healthRecordLevel(HEALTH_QUEUE_FLASH_LOG, head + 1 - recordTail);
+    }
+
+    /* the flash log task writes right after a trigger */
+    int64_t now_us = esp_timer_get_time();
+    lastInterval_us = now_us - lastAppend_us;
+    lastAppend_us = now_us;
+    xTaskNotifyGive(xFlashLogTask);
+}
+
+/* Reply the scans in the partition */
+esp_err_t flashLogSendList(void)
+{
+    char reply[64];
+    int length;
+    uint32_t numScans = 0;
+    uint32_t numUsed = 0;
+    bool inScan = false;
+    uint16_t id = 0;
+    uint32_t numBlocks = 0;
+    uint32_t numRecords = 0;
+
+    /* the blocks of a scan are consecutive, oldest first */
+    for (uint32_t i = 0; i <= numSlots; i++) {
+        const flash_log_block_t* pBlock = (i < numSlots) ? &pLogSlots[(headSlot + i) % numSlots] : NULL;
+        bool valid = (pBlock != NULL) && isValid(pBlock);
+        if (inScan && (!valid || pBlock->scanId != id)) {
+            length = snprintf(reply, sizeof(reply), "$FLI%u,%lu,%lu#\r\n", id, numBlocks, numRecords);
+            transportSendReply(reply, length);
+            numScans++;
+            inScan = false;
+        }
+        if (!valid) {
+            continue;
+        }
+        if (!inScan) {
+            inScan = true;
+            id = pBlock->scanId;
+            numBlocks = 0;
+            numRecords = 0;
+        }
+        numBlocks++;
+        numRecords += pBlock->numRecords;
+        numUsed++;
+    }
+
+    length = snprintf(reply, sizeof(reply), "$FLE%lu,%lu,%lu,%lu#\r\n", numScans, numUsed, numSlots, numDropped);
+    transportSendReply(reply, length);
+    return (pLogSlots != NULL) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+/* Stream a scan back in the background */
+esp_err_t flashLogDump(uint32_t id)
+{
+    if (xFlashLogTask == NULL || id > UINT16_MAX) {
+        /* the host waits for the end frame, an empty scan answers a dump that never starts */
+        char reply[40];
+        int length = snprintf(reply, sizeof(reply), "$FDE%lu,0,0#\r\n", id);
+        transportSendReply(reply, length);
+        return (xFlashLogTask == NULL) ? ESP_ERR_NOT_FOUND : ESP_ERR_INVALID_ARG;
+    }
+    dumpScanId = (int32_t)id;
+    xTaskNotifyGive(xFlashLogTask);
+    return ESP_OK;
+}
+
+/* Erase the partition in the background */
+esp_err_t flashLogErase(void)
+{
+    if (xFlashLogTask == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (recording) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    eraseRequested = true;
+    xTaskNotifyGive(xFlashLogTask);
+    return ESP_OK;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	FlashLog.h
+
+  Abstract:
+
+	The header file of the trigger log persistence on a flash partition
+*/
+
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include "Config.h"
+#include "esp_err.h"
+#include "TriggerCodec.h"
+
+
+// The data partition of the log (see partitions.csv)
+#define FLASH_LOG_PARTITION_LABEL	"triglog"
+
+/*
+	The partition is a ring of slots, one flash page each, written in order and erased a sector
+	at a time ahead of the writer, so every sector is erased equally often.
+	A slot holds one compressed block of records (see TriggerCodec.h) of a single scan:
+	the blocks are ordered by their sequence number, a slot with a bad CRC (a write cut by a reset) is skipped.
+*/
+#define FLASH_LOG_SECTOR_BYTES		4096
+#define FLASH_LOG_SLOT_BYTES		256
+#define FLASH_LOG_SLOTS_PER_SECTOR	(FLASH_LOG_SECTOR_BYTES / FLASH_LOG_SLOT_BYTES)
+#define FLASH_LOG_BLOCK_MAGIC		0x4B4C4654	// "TFLK"
+
+// Records waiting for the flash log task, and encoded blocks waiting for a write gap
+#define FLASH_LOG_RING_LENGTH		128
+#define FLASH_LOG_PENDING_BLOCKS	16
+
+/*
+	A flash write or erase stops the caches of both cores. The trigger pulses and the bursts do not
+	depend on them: they are sent from the PCNT and the burst timer interrupts, which run from IRAM
+	(CONFIG_PCNT_ISR_IRAM_SAFE, CONFIG_GPTIMER_ISR_IRAM_SAFE). The radar trigger task does stall, so its
+	index code, its log and, in the absolute mode, the re-arm of the next trigger point are late.
+	A page is therefore only written right after a trigger when the triggers are at least
+	FLASH_LOG_MIN_GAP_US apart (a page program takes well below a millisecond), or when no trigger
+	has come for FLASH_LOG_IDLE_MS. Sectors are only erased by $FLR: FLASH_LOG_ERASE_AHEAD sectors ahead
+	of the writer when a scan starts (for its blocks) and when it ends (for the next scan), never on a
+	timeout within the scan. A scan that outgrows them, or triggers that never pause, leave the blocks
+	waiting in RAM, and they are dropped (and counted) when it is full.
+*/
+#define FLASH_LOG_MIN_GAP_US		4000
+#define FLASH_LOG_IDLE_MS			250
+#define FLASH_LOG_ERASE_AHEAD		32
+#define FLASH_LOG_POLL_MS			50
+
+/* A slot of the log partition */
+typedef struct {
+	uint32_t magic;			// FLASH_LOG_BLOCK_MAGIC
+	uint32_t sequence;		// block number since the partition was erased
+	uint16_t scanId;		// the recording the block belongs to
+	uint8_t numRecords;
+	uint8_t size;			// payload bytes
+	uint32_t crc;			// CRC-32 of the fields above and the payload
+	uint8_t data[TRIGGER_CODEC_BLOCK_BYTES];
+} flash_log_block_t;
+
+/* Initialize the flash log (not recording until enabled) */
+void flashLogInitialize(void);
+
+/* Start a new scan or stop recording, both erase FLASH_LOG_ERASE_AHEAD sectors in the background
+ * (up to about 1.5 s, send it while the stage stands)
+ */
+esp_err_t flashLogRecord(bool enable);
+
+/* Append a trigger record while recording (radar trigger task only), returns at once */
+void flashLogAppend(const trigger_record_t* pRecord);
+
+/*
+	Reply the scans in the partition as $FLI<scanId>,<blocks>,<records># lines,
+	followed by $FLE<scans>,<usedSlots>,<totalSlots>,<dropped># (also without a partition)
+*/
+esp_err_t flashLogSendList(void);
+
+/*
+	Stream a scan back as $TRZ blocks (events, like the live stream), followed by
+	$FDE<scanId>,<blocks>,<records>#; the flash log task sends it in the background.
+	Without a partition or with a scanId above 65535 only $FDE<scanId>,0,0# is replied
+*/
+esp_err_t flashLogDump(uint32_t scanId);
+
+/* Erase the partition in the background, $FLX<erasedSectors># is sent when it is done */
+esp_err_t flashLogErase(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,220 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	Health.c
+
+  Abstract:
+
+	The implementation file of the runtime health counters
+*/
+
+#include <Health.h>
+#include "esp_heap_caps.h"
+
+
+/* A task handle for the drop reporter */
+static TaskHandle_t xHealthTask = NULL;
+
+/* The task stack and control block */
+static StackType_t xHealthStack[HEALTH_TASK_STACK_SIZE_BYTES];
+static StaticTask_t xHealthTaskBuffer;
+
+/* The queue statistics */
+static volatile health_queue_stats_t healthQueues[HEALTH_QUEUE_COUNT];
+
+/* The interrupt counts */
+static volatile uint32_t healthIsrCounts[HEALTH_ISR_COUNT];
+
+/* The task list, filled by uxTaskGetSystemState */
+static TaskStatus_t healthTaskStatus[HEALTH_MAX_TASKS];
+
+/* The task list of the floor checks */
+static TaskStatus_t healthCheckStatus[HEALTH_MAX_TASKS];
+
+/* The heap and stack floors already reported (one bit per task number) */
+static bool healthHeapReported = false;
+static uint64_t healthStackReported = 0;
+
+/* Send an event to the host PC */
+extern int transportSendEvent(const char* data, uint32_t length);
+
+/* Report the heap and the task stacks that fell below their floor */
+static void healthCheckFloors(void)
+{
+    char reply[48];
+    int length;
+
+    uint32_t minFreeBytes = (uint32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    if (!healthHeapReported && minFreeBytes < HEALTH_HEAP_FLOOR_BYTES) {
+        healthHeapReported = true;
+        length = snprintf(reply, sizeof(reply), "$HEP%lu,%lu#\r\n",
+                        (uint32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT), minFreeBytes);
+        transportSendEvent(reply, length);
+    }
+
+    UBaseType_t numTasks = uxTaskGetSystemState(healthCheckStatus, HEALTH_MAX_TASKS, NULL);
+    for (UBaseType_t i = 0; i < numTasks; i++) {
+        uint64_t taskBit = 1ULL << (healthCheckStatus[i].xTaskNumber % 64);
+        if (!(healthStackReported & taskBit) && healthCheckStatus[i].usStackHighWaterMark < HEALTH_STACK_FLOOR_BYTES) {
+            healthStackReported |= taskBit;
+            length = snprintf(reply, sizeof(reply), "$HSK%s,%lu#\r\n",
+                            healthCheckStatus[i].pcTaskName, (uint32_t)healthCheckStatus[i].usStackHighWaterMark);
+            transportSendEvent(reply, length);
+        }
+    }
+}
+
+/* The Drop Reporter Task, also checks the heap and stack floors */
+static void healthTask(void* params)
+{
+    /* The parameter value is expected to be NULL. */
+    configASSERT(params == NULL);
+
+    char reply[16];
+    uint32_t droppedQueues;
+
+    while (1) {
+        /* Block until a queue drops its first entry (one bit per queue) or the next check is due */
+        if (xTaskNotifyWait(0, UINT32_MAX, &droppedQueues, pdMS_TO_TICKS(HEALTH_CHECK_PERIOD_MS)) != pdTRUE) {
+            healthCheckFloors();
+            continue;
+        }
+
+        for (int queue = 0; queue < HEALTH_QUEUE_COUNT; queue++) {
+            if (droppedQueues & (1UL << queue)) {
+                int length = snprintf(reply, sizeof(reply), "$DRP%d#\r\n", queue);
+                transportSendEvent(reply, length);
+            }
+        }
+    }
+}
+
+/* Initialize the health counters and the drop reporter task */
+void healthInitialize(void)
+{
+    /* Set the log level */
+    static const char *TAG = "HEALTH_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    /* Create the task, store the handle. */
+    xHealthTask = xTaskCreateStaticPinnedToCore(
+                        healthTask,                     /* Function that implements the task. */
+                        "HealthTask",                   /* Text name for the task. */
+                        HEALTH_TASK_STACK_SIZE_BYTES,   /* Stack size in bytes. */
+                        NULL,                           /* Parameter passed into the task. */
+                        1,                              /* Priority at which the task is created. */
+                        xHealthStack,                   /* The task stack. */
+                        &xHealthTaskBuffer,             /* The task control block. */
+                        1);                             /* Core number. */
+    if( xHealthTask == NULL )
+    {
+        /* The task is not created. */
+        ESP_LOGI(TAG, "The Health Task could not created.");
+    }
+}
+
+/* Set the capacity of a queue */
+void healthSetQueueCapacity(health_queue_t queue, uint32_t capacity)
+{
+    healthQueues[queue].capacity = capacity;
+}
+
+/* Record the fill level of a queue */
+void IRAM_ATTR healthRecordLevel(health_queue_t queue, uint32_t level)
+{
+    if (level > healthQueues[queue].highWater) {
+        healthQueues[queue].highWater = level;
+    }
+}
+
+/* Record a dropped entry, the first one is reported to the host */
+void IRAM_ATTR healthRecordDrop(health_queue_t queue)
+{
+    uint32_t dropped = healthQueues[queue].dropped + 1;
+    healthQueues[queue].dropped = dropped;
+
+    if (dropped == 1 && xHealthTask != NULL) {
+        if (xPortInIsrContext()) {
+            BaseType_t high_task_wakeup = pdFALSE;
+            xTaskNotifyFromISR(xHealthTask, 1UL << queue, eSetBits, &high_task_wakeup);
+            portYIELD_FROM_ISR(high_task_wakeup);
+        }
+        else {
+            xTaskNotify(xHealthTask, 1UL << queue, eSetBits);
+        }
+    }
+}
+
+/* Count an interrupt */
+void IRAM_ATTR healthCountIsr(health_isr_t isr)
+{
+    healthIsrCounts[isr]++;
+}
+
+/* Get the statistics of a queue */
+void healthGetQueueStatistics(health_queue_t queue, health_queue_stats_t* pStats)
+{
+    pStats->capacity = healthQueues[queue].capacity;
+    pStats->highWater = healthQueues[queue].highWater;
+    pStats->dropped = healthQueues[queue].dropped;
+}
+
+/* Get the number of interrupts since boot */
+uint32_t healthGetIsrCount(health_isr_t isr)
+{
+    return healthIsrCounts[isr];
+}
+
+/* Get the statistics of every task (requires the FreeRTOS trace facility and run time stats) */
+uint32_t healthGetTaskStatistics(health_task_stats_t* pStats, uint32_t maxTasks)
+{
+    uint32_t totalRunTime;
+    UBaseType_t numTasks = uxTaskGetSystemState(healthTaskStatus, HEALTH_MAX_TASKS, &totalRunTime);
+
+    /* the total run time is counted per core */
+    totalRunTime /= 1000;
+    if (numTasks > maxTasks) {
+        numTasks = maxTasks;
+    }
+
+    for (UBaseType_t i = 0; i < numTasks; i++) {
+        snprintf(pStats[i].name, sizeof(pStats[i].name), "%s", healthTaskStatus[i].pcTaskName);
+        pStats[i].stackFree = healthTaskStatus[i].usStackHighWaterMark;
+        pStats[i].cpuPermille = (totalRunTime > 0) ? (uint32_t)(healthTaskStatus[i].ulRunTimeCounter / totalRunTime) : 0;
+    }
+    return numTasks;
+}
+
+/* Get the statistics of the heap */
+void healthGetHeapStatistics(health_heap_stats_t* pStats)
+{
+    pStats->freeBytes = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    pStats->minFreeBytes = (uint32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    pStats->largestBlock = (uint32_t)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+}
+
+/* Log the static task stack budget and the free heap (after every task is created) */
+void healthLogMemory(void)
+{
+    /* Set the log level */
+    static const char *TAG = "HEALTH_MEMORY";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    health_heap_stats_t heap;
+    healthGetHeapStatistics(&heap);
+    ESP_LOGI(TAG, "Task stacks: %d bytes (static), free heap: %lu bytes, largest block: %lu bytes",
+                    TASK_STACK_BUDGET_BYTES, heap.freeBytes, heap.largestBlock);
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	Health.h
+
+  Abstract:
+
+	The header file of the runtime health counters
+	(queue high-water marks, drops, interrupt counts and task statistics)
+*/
+
+#ifndef HEALTH_H
+#define HEALTH_H
+
+#include "Config.h"
+
+
+// Maximum number of tasks reported
+#define HEALTH_MAX_TASKS	24
+
+// Floors of the free heap and of the unused stack of a task, reported once when crossed
+#define HEALTH_HEAP_FLOOR_BYTES		16384
+#define HEALTH_STACK_FLOOR_BYTES	384
+
+// Period of the heap and stack checks
+#define HEALTH_CHECK_PERIOD_MS		1000
+
+/* The queues whose fill level and drops are tracked (a single writer per queue) */
+typedef enum {
+	HEALTH_QUEUE_PCNT_EVENTS = 0,	// watch point events from the PCNT interrupt to the radar trigger task
+	HEALTH_QUEUE_PENDING_TRIGGERS,	// watch points not yet handled by the radar trigger task
+	HEALTH_QUEUE_UART_EVENTS,		// commands from the host interface to the radar trigger task
+	HEALTH_QUEUE_TRIGGER_LOG,		// trigger records not yet read by the host
+	HEALTH_QUEUE_INDEX_CODE,		// index code words waiting for the RMT
+	HEALTH_QUEUE_FLASH_LOG,			// trigger records not yet written to the flash log
+	HEALTH_QUEUE_TRIGGER_POINTS,	// armed trigger points of the absolute mode (drops: points the count had passed at the re-arm)
+	HEALTH_QUEUE_COUNT,
+} health_queue_t;
+
+/* The interrupts that are counted */
+typedef enum {
+	HEALTH_ISR_PCNT_TRIGGER = 0,	// radar trigger watch point
+	HEALTH_ISR_PCNT_ENCODER,		// encoder verification counter wrap
+	HEALTH_ISR_RMT_DONE,			// pulse generator chunk transmitted
+	HEALTH_ISR_BURST_TIMER,			// radar trigger burst pulse edge
+	HEALTH_ISR_TIME_SYNC,			// sync pulse capture
+	HEALTH_ISR_PASS_BOUNDARY,		// pass boundary input edge
+	HEALTH_ISR_COUNT,
+} health_isr_t;
+
+/* Statistics of a queue */
+typedef struct {
+	uint32_t capacity;		// number of entries (0: unbounded)
+	uint32_t highWater;		// highest fill level since boot
+	uint32_t dropped;		// entries dropped since boot
+} health_queue_stats_t;
+
+/* Statistics of the heap */
+typedef struct {
+	uint32_t freeBytes;		// free heap now
+	uint32_t minFreeBytes;	// lowest free heap since boot
+	uint32_t largestBlock;	// largest block that can be allocated now
+} health_heap_stats_t;
+
+/* Statistics of a task */
+typedef struct {
+	char name[configMAX_TASK_NAME_LEN];
+	uint32_t stackFree;		// stack high-water mark (bytes never used)
+	uint32_t cpuPermille;	// CPU time since boot (per mille of one core)
+} health_task_stats_t;
+
+/*
+	The first drop of each queue is reported to the host as
+	$DRP<queue>#
+	the first time the free heap falls below HEALTH_HEAP_FLOOR_BYTES as
+	$HEP<freeBytes>,<minFreeBytes>#
+	and the first time the unused stack of a task falls below HEALTH_STACK_FLOOR_BYTES as
+	$HSK<task>,<stackFree>#
+*/
+
+/* Initialize the health counters and the drop reporter task */
+void healthInitialize(void);
+
+/* Set the capacity of a queue */
+void healthSetQueueCapacity(health_queue_t queue, uint32_t capacity);
+
+/* Record the fill level of a queue (the caller is the only writer of the queue) */
+void healthRecordLevel(health_queue_t queue, uint32_t level);
+
+/* Record a dropped entry (the caller is the only writer of the queue) */
+void healthRecordDrop(health_queue_t queue);
+
+/* Count an interrupt */
+void healthCountIsr(health_isr_t isr);
+
+/* Get the statistics of a queue */
+void healthGetQueueStatistics(health_queue_t queue, health_queue_stats_t* pStats);
+
+/* Get the number of interrupts since boot */
+uint32_t healthGetIsrCount(health_isr_t isr);
+
+/* Get the statistics of every task, returns the number of tasks */
+uint32_t healthGetTaskStatistics(health_task_stats_t* pStats, uint32_t maxTasks);
+
+/* Get the statistics of the heap */
+void healthGetHeapStatistics(health_heap_stats_t* pStats);
+
+/* Log the static task stack budget and the free heap (after every task is created) */
+void healthLogMemory(void);
+
+#endif
\ No newline at end of file
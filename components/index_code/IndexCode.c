@@ -0,0 +1,187 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	IndexCode.c
+
+  Abstract:
+
+	The implementation file of the serial trigger index code output
+*/
+
+#include <IndexCode.h>
+#include <Health.h>
+#include "driver/rmt_tx.h"
+
+
+/* RMT channel and encoder of the index code */
+static rmt_channel_handle_t index_code_channel;
+static rmt_encoder_handle_t index_code_encoder;
+
+/* Configuration */
+static volatile bool indexCodeEnabled = false;
+static uint32_t indexCodeBitTicks = INDEX_CODE_RESOLUTION_HZ / INDEX_CODE_DEFAULT_BAUD;
+
+/* The words being sent, the RMT reads them while it transmits */
+static rmt_symbol_word_t indexCodeWords[INDEX_CODE_QUEUE_DEPTH][INDEX_CODE_WORD_SYMBOLS];
+static uint32_t indexCodeNext = 0;
+
+/* Number of words queued in the RMT driver */
+static volatile uint32_t indexCodeQueued = 0;
+static portMUX_TYPE indexCodeLock = portMUX_INITIALIZER_UNLOCKED;
+
+/* RMT transmit done callback, a queued word has been sent */
+static bool index_code_on_trans_done(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *user_ctx)
+{
+    portENTER_CRITICAL_ISR(&indexCodeLock);
+    indexCodeQueued--;
+    portEXIT_CRITICAL_ISR(&indexCodeLock);
+    return false;
+}
+
+/* Reserve a place in the RMT queue, returns false if it is full (rmt_transmit would block) */
+static bool indexCodeReserve(void)
+{
+    portENTER_CRITICAL(&indexCodeLock);
+    uint32_t queued = indexCodeQueued;
+    if (queued < INDEX_CODE_QUEUE_DEPTH) {
+        indexCodeQueued = queued + 1;
+    }
+    portEXIT_CRITICAL(&indexCodeLock);
+
+    if (queued >= INDEX_CODE_QUEUE_DEPTH) {
+        return false;
+    }
+    healthRecordLevel(HEALTH_QUEUE_INDEX_CODE, queued + 1);
+    return true;
+}
+
+/* Queue symbols to the RMT (after a place is reserved) */
+static void indexCodeTransmit(const rmt_symbol_word_t* pSymbols, uint32_t numSymbols)
+{
+    /* the line idles high between the words */
+    rmt_transmit_config_t tx_config = {
+        .loop_count = 0,
+        .flags.eot_level = 1,
+    };
+    ESP_ERROR_CHECK(rmt_transmit(index_code_channel, index_code_encoder,
+                                pSymbols, numSymbols * sizeof(rmt_symbol_word_t), &tx_config));
+}
+
+/* Compute the CRC-8 of an index code word (polynomial 0x07, initial value 0) */
+uint8_t indexCodeCrc8(const uint8_t* pData, uint32_t length)
+{
+    uint8_t crc = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= pData[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/* Initialize the index code output
+ * a first transmission drives the idle level, the output is low until then
+ */
+void indexCodeInitialize(void)
+{
+    /* install RMT TX channel */
+    rmt_tx_channel_config_t tx_chan_config = {
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .gpio_num = INDEX_CODE_OUTPUT_IO,
+        .mem_block_symbols = 64,
+        .resolution_hz = INDEX_CODE_RESOLUTION_HZ,
+        .trans_queue_depth = INDEX_CODE_QUEUE_DEPTH,
+    };
+    ESP_ERROR_CHECK(rmt_new_tx_channel(&tx_chan_config, &index_code_channel));
+
+    /* the words are prepared by the radar trigger task, so a copy encoder is sufficient */
+    rmt_copy_encoder_config_t copy_encoder_config = {};
+    ESP_ERROR_CHECK(rmt_new_copy_encoder(&copy_encoder_config, &index_code_encoder));
+
+    /* register callbacks */
+    rmt_tx_event_callbacks_t cbs = {
+        .on_trans_done = index_code_on_trans_done,
+    };
+    ESP_ERROR_CHECK(rmt_tx_register_event_callbacks(index_code_channel, &cbs, NULL));
+    ESP_ERROR_CHECK(rmt_enable(index_code_channel));
+
+    /* track the words waiting for the RMT */
+    healthSetQueueCapacity(HEALTH_QUEUE_INDEX_CODE, INDEX_CODE_QUEUE_DEPTH);
+
+    /* raise the output to the idle level */
+    static const rmt_symbol_word_t idle = {
+        .level0 = 1, .duration0 = 10,
+        .level1 = 1, .duration1 = 10,
+    };
+    indexCodeReserve();
+    indexCodeTransmit(&idle, 1);
+}
+
+/* Enable or disable the index code at the given baud rate */
+esp_err_t indexCodeConfigure(bool enable, uint32_t baudRate)
+{
+    if (enable && (baudRate < INDEX_CODE_MIN_BAUD || baudRate > INDEX_CODE_MAX_BAUD)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* the bit time of the words that are queued already is kept */
+    indexCodeEnabled = false;
+    if (enable) {
+        indexCodeBitTicks = (INDEX_CODE_RESOLUTION_HZ + baudRate / 2) / baudRate;
+        indexCodeEnabled = true;
+    }
+    return ESP_OK;
+}
+
+/* Send the index of a trigger
+ * the bits are framed like a UART, a start bit (low), 8 data bits and a stop bit (high) per byte,
+ * and packed two per symbol into the next free word buffer
+ */
+void indexCodeSend(uint32_t index)
+{
+    if (!indexCodeEnabled) {
+        return;
+    }
+    if (!indexCodeReserve()) {
+        healthRecordDrop(HEALTH_QUEUE_INDEX_CODE);
+        return;
+    }
+
+    uint8_t bytes[INDEX_CODE_WORD_BYTES] = {
+        (uint8_t)index, (uint8_t)(index >> 8), (uint8_t)(index >> 16), (uint8_t)(index >> 24), 0
+    };
+    bytes[4] = indexCodeCrc8(bytes, 4);
+
+    /* fewer than INDEX_CODE_QUEUE_DEPTH words are in flight, they use the buffers before this one */
+    rmt_symbol_word_t* pWord = indexCodeWords[indexCodeNext % INDEX_CODE_QUEUE_DEPTH];
+    indexCodeNext++;
+    for (int bit = 0; bit < INDEX_CODE_WORD_BITS; bit++) {
+        int position = bit % 10;
+        int byte = bit / 10;
+        uint32_t level = (position == 0) ? 0 : (position == 9) ? 1 : (bytes[byte] >> (position - 1)) & 1;
+        if (bit & 1) {
+            pWord[bit / 2].level1 = level;
+            pWord[bit / 2].duration1 = indexCodeBitTicks;
+        }
+        else {
+            pWord[bit / 2].level0 = level;
+            pWord[bit / 2].duration0 = indexCodeBitTicks;
+        }
+    }
+
+    indexCodeTransmit(pWord, INDEX_CODE_WORD_SYMBOLS);
+}
\ No newline at end of file
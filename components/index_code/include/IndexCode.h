@@ -0,0 +1,67 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	IndexCode.h
+
+  Abstract:
+
+	The header file of the serial trigger index code output
+*/
+
+#ifndef INDEX_CODE_H
+#define INDEX_CODE_H
+
+#include "Config.h"
+#include "esp_err.h"
+
+
+// Output GPIO of the index code
+#define INDEX_CODE_OUTPUT_IO		23
+
+// RMT timing parameters
+#define INDEX_CODE_RESOLUTION_HZ	10000000	// 10 MHz, 0.1 us per tick
+#define INDEX_CODE_DEFAULT_BAUD		1000000
+#define INDEX_CODE_MIN_BAUD			9600
+#define INDEX_CODE_MAX_BAUD			2000000		// 5 ticks per bit
+
+/*
+	A word is 5 bytes in UART framing (8N1, idle high, least significant bit first):
+	the trigger index of the trigger log (uint32, little endian) followed by a CRC-8
+	(polynomial 0x07, initial value 0, no reflection) of the 4 index bytes.
+	It starts right after the trigger pulse, one word per position (a burst is not coded again),
+	and takes 50 bit times (50 us at the default 1 Mbaud), so any logic analyzer or UART
+	capture decodes it and a radar frame is matched to its trigger record by a lookup.
+*/
+#define INDEX_CODE_WORD_BYTES		5
+#define INDEX_CODE_WORD_BITS		(INDEX_CODE_WORD_BYTES * 10)
+#define INDEX_CODE_WORD_SYMBOLS		(INDEX_CODE_WORD_BITS / 2)		// two bits per RMT symbol
+
+// Words waiting for the RMT, a word that finds the queue full is dropped (and counted by the health counters)
+#define INDEX_CODE_QUEUE_DEPTH		4
+
+/* Initialize the index code output (off until enabled, the output idles high) */
+void indexCodeInitialize(void);
+
+/* Enable or disable the index code at the given baud rate */
+esp_err_t indexCodeConfigure(bool enable, uint32_t baudRate);
+
+/* Send the index of a trigger (radar trigger task only), returns at once */
+void indexCodeSend(uint32_t index);
+
+/* Compute the CRC-8 of an index code word */
+uint8_t indexCodeCrc8(const uint8_t* pData, uint32_t length);
+
+#endif
\ No newline at end of file
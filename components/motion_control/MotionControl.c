@@ -0,0 +1,201 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	MotionControl.c
+
+  Abstract:
+
+	The implementation file of the built-in step/direction motion generator
+*/
+
+#include <MotionControl.h>
+#include <EdgeCapture.h>
+#include <Health.h>
+
+
+/* The built-in step/direction motion generator */
+pulse_generator_t motionPulseGenerator;
+
+/* A task handle for the move monitor */
+static TaskHandle_t xMotionControlTask;
+
+/* The task stack and control block */
+static StackType_t xMotionControlStack[MOTION_CONTROL_TASK_STACK_SIZE_BYTES];
+static StaticTask_t xMotionControlTaskBuffer;
+
+/* PCNT unit counting the external encoder for verification */
+static pcnt_unit_handle_t encoder_pcnt_unit;
+
+/* Encoder pulses accumulated on each counter wrap */
+static volatile int32_t encoderAccumulated = 0;
+
+/* The radar trigger source */
+static pcnt_input_t triggerSource = PCNT_INPUT_ENCODER;
+
+/* Send an event to the host PC */
+extern int transportSendEvent(const char* data, uint32_t length);
+
+/* Encoder verification counter callback
+ * the counter is cleared by the hardware at the limit, keep the lost part
+ */
+static bool IRAM_ATTR encoder_pcnt_on_reach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx)
+{
+    healthCountIsr(HEALTH_ISR_PCNT_ENCODER);
+    if (edata->watch_point_value == MOTION_ENCODER_PCNT_LIMIT) {
+        encoderAccumulated += MOTION_ENCODER_PCNT_LIMIT;
+    }
+    return false;
+}
+
+/* Read the number of encoder pulses since the move started */
+static int32_t readEncoderPulses(void)
+{
+    int count;
+    ESP_ERROR_CHECK(pcnt_unit_get_count(encoder_pcnt_unit, &count));
+    return encoderAccumulated + count;
+}
+
+/* The Move Monitor Task */
+static void motionControlTask(void* params)
+{
+    /* The parameter value is expected to be NULL. */
+    configASSERT(params == NULL);
+
+    char reply[48];
+
+    while (1) {
+        /* Block until a move is started, then until it is finished */
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        pulseGeneratorWaitDone(&motionPulseGenerator, portMAX_DELAY);
+
+        /* report the commanded steps against the encoder */
+        int length = snprintf(reply, sizeof(reply), "$MVD%lu,%ld#\r\n",
+                            motionPulseGenerator.pulsesSent,
+                            readEncoderPulses());
+        transportSendEvent(reply, length);
+    }
+}
+
+/* Initialize the motion generator and the encoder verification counter */
+void motionControlInitialize(void)
+{
+    /* Set the log level */
+    static const char *TAG = "MOTION_CONTROL_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    /* the step/direction generator, without any profile */
+    pulseGeneratorCreate(&motionPulseGenerator, MOTION_STEP_OUTPUT_IO, MOTION_DIRECTION_OUTPUT_IO, "MotionControlGenTask");
+
+    /* install the encoder verification unit */
+    pcnt_unit_config_t unit_config = {
+        .high_limit = MOTION_ENCODER_PCNT_LIMIT,
+        .low_limit = -MOTION_ENCODER_PCNT_LIMIT,
+    };
+    ESP_ERROR_CHECK(pcnt_new_unit(&unit_config, &encoder_pcnt_unit));
+
+    /* use the same filter as the radar trigger counter */
+    pcnt_glitch_filter_config_t filter_config = {
+        .max_glitch_ns = PCNT_DEFAULT_GLITCH_NS,
+    };
+    ESP_ERROR_CHECK(pcnt_unit_set_glitch_filter(encoder_pcnt_unit, &filter_config));
+
+    /* count the falling edges of the external encoder */
+    pcnt_chan_config_t chan_config = {
+        .edge_gpio_num = PCNT_INPUT_EDGE_IO,
+        .level_gpio_num = -1,
+    };
+    pcnt_channel_handle_t pcnt_chan = NULL;
+    ESP_ERROR_CHECK(pcnt_new_channel(encoder_pcnt_unit, &chan_config, &pcnt_chan));
+    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(pcnt_chan, PCNT_CHANNEL_EDGE_ACTION_HOLD, PCNT_CHANNEL_EDGE_ACTION_INCREASE));
+
+    /* accumulate on each wrap */
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(encoder_pcnt_unit, MOTION_ENCODER_PCNT_LIMIT));
+    pcnt_event_callbacks_t cbs = {
+        .on_reach = encoder_pcnt_on_reach,
+    };
+    ESP_ERROR_CHECK(pcnt_unit_register_event_callbacks(encoder_pcnt_unit, &cbs, NULL));
+
+    ESP_ERROR_CHECK(pcnt_unit_enable(encoder_pcnt_unit));
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(encoder_pcnt_unit));
+    ESP_ERROR_CHECK(pcnt_unit_start(encoder_pcnt_unit));
+
+    /* Create the task, store the handle. */
+    xMotionControlTask = xTaskCreateStaticPinnedToCore(
+                        motionControlTask,                    /* Function that implements the task. */
+                        "MotionControlTask",                  /* Text name for the task. */
+                        MOTION_CONTROL_TASK_STACK_SIZE_BYTES, /* Stack size in bytes. */
+                        NULL,                                 /* Parameter passed into the task. */
+                        2,                                    /* Priority at which the task is created. */
+                        xMotionControlStack,                  /* The task stack. */
+                        &xMotionControlTaskBuffer,            /* The task control block. */
+                        1);                                   /* Core number. */
+    if( xMotionControlTask == NULL )
+    {
+        /* The task is not created. */
+        ESP_LOGI(TAG, "The Motion Control Task could not created.");
+    }
+}
+
+/* Select the radar trigger source (not while moving) */
+esp_err_t motionControlSetTriggerSource(pcnt_input_t input)
+{
+    if (motionPulseGenerator.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (input != PCNT_INPUT_ENCODER && input != PCNT_INPUT_STEP) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pcntSelectInput(input);
+    edgeCaptureSelectInput(input);
+    triggerSource = input;
+    return ESP_OK;
+}
+
+/* Get the radar trigger source */
+pcnt_input_t motionControlGetTriggerSource(void)
+{
+    return triggerSource;
+}
+
+/* Start the move */
+esp_err_t motionControlStart(void)
+{
+    if (motionPulseGenerator.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* restart the encoder verification from zero */
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(encoder_pcnt_unit));
+    encoderAccumulated = 0;
+
+    esp_err_t err = pulseGeneratorStart(&motionPulseGenerator);
+    if (err == ESP_OK) {
+        xTaskNotifyGive(xMotionControlTask);
+    }
+    return err;
+}
+
+/* Stop the move at the next chunk boundary */
+void motionControlStop(void)
+{
+    pulseGeneratorStop(&motionPulseGenerator);
+}
+
+/* Change the glitch filter of the encoder verification counter */
+esp_err_t motionControlSetGlitchFilter(uint32_t maxGlitch_ns)
+{
+    return pcntSetUnitGlitchFilter(encoder_pcnt_unit, maxGlitch_ns);
+}
\ No newline at end of file
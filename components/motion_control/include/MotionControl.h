@@ -0,0 +1,68 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	MotionControl.h
+
+  Abstract:
+
+	The header file of the built-in step/direction motion generator
+*/
+
+#ifndef MOTION_CONTROL_H
+#define MOTION_CONTROL_H
+
+#include "Config.h"
+#include "PulseCounter.h"
+#include "PulseGenerator.h"
+
+
+// Step/direction outputs to the stage driver
+#define MOTION_STEP_OUTPUT_IO			PCNT_INPUT_STEP_IO
+#define MOTION_DIRECTION_OUTPUT_IO		19
+
+// The encoder verification counter wraps at this value and is accumulated in software
+#define MOTION_ENCODER_PCNT_LIMIT		30000
+
+/*
+	The motion generator plays back a profile (see PulseGenerator.h) on the step output.
+	In the internal mode the radar trigger counts the step output itself,
+	while the external encoder keeps being counted on a separate PCNT unit for verification.
+	A finished move is reported to the host as
+	$MVD<steps>,<encoderPulses>#
+*/
+
+/* The built-in step/direction motion generator */
+extern pulse_generator_t motionPulseGenerator;
+
+/* Initialize the motion generator and the encoder verification counter */
+void motionControlInitialize(void);
+
+/* Select the radar trigger source (not while moving) */
+esp_err_t motionControlSetTriggerSource(pcnt_input_t input);
+
+/* Get the radar trigger source */
+pcnt_input_t motionControlGetTriggerSource(void);
+
+/* Start the move */
+esp_err_t motionControlStart(void);
+
+/* Stop the move at the next chunk boundary */
+void motionControlStop(void);
+
+/* Change the glitch filter of the encoder verification counter (0: no filter) */
+esp_err_t motionControlSetGlitchFilter(uint32_t maxGlitch_ns);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,195 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	Protocol.c
+
+  Abstract:
+
+	The implementation file of the simplified protocol parser
+*/
+
+#include <stddef.h>
+#include <Protocol.h>
+
+
+/* A command table entry */
+typedef struct {
+    char name[PROTOCOL_COMMAND_SIZE + 1];
+    uint8_t numParameters;		// exact number of parameters
+} protocol_command_entry_t;
+
+/* The command table, in the order of protocol_command_t */
+static const protocol_command_entry_t commandTable[PROTOCOL_COMMAND_COUNT] = {
+    [PROTOCOL_COMMAND_RADAR_TRIGGER]			= { "RTG", 0 },
+    [PROTOCOL_COMMAND_SET_DESIRED_NUM_TRIGGER]	= { "DTG", 1 },
+    [PROTOCOL_COMMAND_CLEAR_NUM_TRIGGER]		= { "CTG", 0 },
+    [PROTOCOL_COMMAND_SET_PULSE_COUNT]			= { "PLS", 1 },
+    [PROTOCOL_COMMAND_RESET_PCNT]				= { "RST", 0 },
+    [PROTOCOL_COMMAND_PAUSE_PCNT]				= { "PAU", 0 },
+    [PROTOCOL_COMMAND_RESUME_PCNT]				= { "RES", 0 },
+    [PROTOCOL_COMMAND_SET_NUM_MEASUREMENT]		= { "MSR", 1 },
+    [PROTOCOL_COMMAND_PULSE_GENERATOR]			= { "GEN", 1 },
+    [PROTOCOL_COMMAND_PULSE_GENERATOR_CONFIG]	= { "PGF", 3 },
+    [PROTOCOL_COMMAND_PULSE_GENERATOR_CLEAR]	= { "PGC", 0 },
+    [PROTOCOL_COMMAND_PULSE_GENERATOR_ADD]		= { "PGA", 4 },
+    [PROTOCOL_COMMAND_SELF_TEST]				= { "STS", 4 },
+    [PROTOCOL_COMMAND_TRIGGER_SOURCE]			= { "MOD", 1 },
+    [PROTOCOL_COMMAND_MOVE]						= { "MOV", 1 },
+    [PROTOCOL_COMMAND_MOVE_CONFIG]				= { "MVF", 3 },
+    [PROTOCOL_COMMAND_MOVE_CLEAR]				= { "MVC", 0 },
+    [PROTOCOL_COMMAND_MOVE_ADD]					= { "MVA", 4 },
+    [PROTOCOL_COMMAND_READ_TRIGGER_LOG]			= { "LOG", 0 },
+    [PROTOCOL_COMMAND_SCAN_PLAN]				= { "SCP", 5 },
+    [PROTOCOL_COMMAND_SCAN_ROW_DIRECTION]		= { "SCD", 2 },
+    [PROTOCOL_COMMAND_SCAN_START]				= { "SCS", 1 },
+    [PROTOCOL_COMMAND_READ_HEALTH]				= { "HLT", 0 },
+    [PROTOCOL_COMMAND_GLITCH_FILTER]			= { "FLT", 1 },
+    [PROTOCOL_COMMAND_ANALYZE_SIGNAL]			= { "ANA", 2 },
+    [PROTOCOL_COMMAND_COUNTER_MODE]				= { "PCM", 1 },
+    [PROTOCOL_COMMAND_DRIFT_TEST]				= { "SDT", 4 },
+    [PROTOCOL_COMMAND_TRIGGER_BURST]			= { "BST", 2 },
+    [PROTOCOL_COMMAND_TIME_SYNC]				= { "SYN", 2 },
+    [PROTOCOL_COMMAND_STREAM_TRIGGER_LOG]		= { "LGS", 1 },
+    [PROTOCOL_COMMAND_PHYSICAL_SPACING]			= { "SPU", 2 },
+    [PROTOCOL_COMMAND_INDEX_CODE]				= { "IDC", 2 },
+    [PROTOCOL_COMMAND_GATE]						= { "GAT", 2 },
+    [PROTOCOL_COMMAND_GATE_WINDOW]				= { "GWN", 2 },
+    [PROTOCOL_COMMAND_CLOCK_EXCHANGE]			= { "HCK", 1 },
+    [PROTOCOL_COMMAND_TRIGGER_GRID]				= { "GRD", 7 },
+    [PROTOCOL_COMMAND_RESET_Y]					= { "YRS", 0 },
+    [PROTOCOL_COMMAND_FLASH_LOG_RECORD]			= { "FLR", 1 },
+    [PROTOCOL_COMMAND_FLASH_LOG_LIST]			= { "FLL", 0 },
+    [PROTOCOL_COMMAND_FLASH_LOG_DUMP]			= { "FLD", 1 },
+    [PROTOCOL_COMMAND_FLASH_LOG_ERASE]			= { "FLX", 0 },
+    [PROTOCOL_COMMAND_PASS_CONFIG]				= { "MPC", 2 },
+};
+
+/* Find a command in the table, returns PROTOCOL_COMMAND_COUNT if it is unknown */
+static protocol_command_t findCommand(const uint8_t* pName)
+{
+    for (int i = 0; i < PROTOCOL_COMMAND_COUNT; i++) {
+        const char* pEntry = commandTable[i].name;
+        if ((pName[0] == (uint8_t)pEntry[0]) && (pName[1] == (uint8_t)pEntry[1]) && (pName[2] == (uint8_t)pEntry[2])) {
+            return (protocol_command_t)i;
+        }
+    }
+    return PROTOCOL_COMMAND_COUNT;
+}
+
+/*
+    Parse the comma separated decimal integers between pCursor and pEnd
+    Returns the number of parameters, or -1 if they are malformed
+*/
+static int parseParameters(const uint8_t* pCursor, const uint8_t* pEnd, int32_t* pValues)
+{
+    int numValues = 0;
+
+    while (pCursor < pEnd) {
+        if (numValues >= PROTOCOL_MAX_PARAMETERS) {
+            return -1;
+        }
+
+        /* optional sign */
+        int negative = 0;
+        if (*pCursor == '-') {
+            negative = 1;
+            pCursor++;
+        }
+
+        /* at least one digit, the magnitude must fit in an int32 */
+        const uint8_t* pDigits = pCursor;
+        int64_t magnitude = 0;
+        while ((pCursor < pEnd) && (*pCursor >= '0') && (*pCursor <= '9')) {
+            magnitude = magnitude * 10 + (*pCursor - '0');
+            if (magnitude > (int64_t)INT32_MAX + negative) {
+                return -1;
+            }
+            pCursor++;
+        }
+        if (pCursor == pDigits) {
+            return -1;
+        }
+        pValues[numValues++] = (int32_t)(negative ? -magnitude : magnitude);
+
+        /* a comma must be followed by another parameter */
+        if (pCursor < pEnd) {
+            if (*pCursor != ',') {
+                return -1;
+            }
+            pCursor++;
+            if (pCursor == pEnd) {
+                return -1;
+            }
+        }
+    }
+    return numValues;
+}
+
+/* Parse a single packet */
+protocol_status_t protocolParseFrame(const uint8_t* pBuffer, uint32_t sizeInBytes, protocol_frame_t* pFrame)
+{
+    if (sizeInBytes < PROTOCOL_MIN_PACKET_SIZE) {
+        return PROTOCOL_ERROR_TOO_SHORT;
+    }
+    if (sizeInBytes - PROTOCOL_MIN_PACKET_SIZE > PROTOCOL_MAX_PARAMETER_SIZE) {
+        return PROTOCOL_ERROR_TOO_LONG;
+    }
+    if (pBuffer[0] != PROTOCOL_START_SYMBOL) {
+        return PROTOCOL_ERROR_START_SYMBOL;
+    }
+    if (pBuffer[sizeInBytes - 1] != PROTOCOL_STOP_SYMBOL) {
+        return PROTOCOL_ERROR_STOP_SYMBOL;
+    }
+
+    protocol_command_t command = findCommand(pBuffer + 1);
+    if (command == PROTOCOL_COMMAND_COUNT) {
+        return PROTOCOL_ERROR_UNKNOWN_COMMAND;
+    }
+
+    const uint8_t* pParameters = pBuffer + 1 + PROTOCOL_COMMAND_SIZE;
+    int numParameters = parseParameters(pParameters, pBuffer + sizeInBytes - 1, pFrame->parameters);
+    if (numParameters != commandTable[command].numParameters) {
+        return PROTOCOL_ERROR_PARAMETERS;
+    }
+
+    pFrame->command = command;
+    pFrame->numParameters = numParameters;
+    return PROTOCOL_OK;
+}
+
+/* The three letter name of a command */
+const char* protocolCommandName(protocol_command_t command)
+{
+    if ((unsigned)command >= PROTOCOL_COMMAND_COUNT) {
+        return "???";
+    }
+    return commandTable[command].name;
+}
+
+/* A readable description of a parse result */
+const char* protocolStatusName(protocol_status_t status)
+{
+    switch (status) {
+        case PROTOCOL_OK:						return "OK";
+        case PROTOCOL_ERROR_TOO_SHORT:			return "packet is too short";
+        case PROTOCOL_ERROR_TOO_LONG:			return "parameters are too long";
+        case PROTOCOL_ERROR_START_SYMBOL:		return "invalid start symbol";
+        case PROTOCOL_ERROR_STOP_SYMBOL:		return "invalid stop symbol";
+        case PROTOCOL_ERROR_UNKNOWN_COMMAND:	return "invalid command";
+        case PROTOCOL_ERROR_PARAMETERS:			return "invalid parameters";
+        default:								return "unknown status";
+    }
+}
\ No newline at end of file
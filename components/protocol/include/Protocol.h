@@ -0,0 +1,129 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	Protocol.h
+
+  Abstract:
+
+	The header file of the simplified protocol parser
+	(plain C, no ESP-IDF dependency, so it also builds on the host)
+*/
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+//  Define simplified protocol variables
+//  A packet is $<command><parameters># where the parameters are comma
+//  separated decimal integers
+//-----------------------------------------------------------------------------
+#define PROTOCOL_START_SYMBOL		'$'
+#define PROTOCOL_STOP_SYMBOL		'#'
+#define PROTOCOL_COMMAND_SIZE		3   // in bytes
+#define PROTOCOL_OVERHEAD_SIZE		2   // in bytes ($ and #)
+#define PROTOCOL_MIN_PACKET_SIZE	(PROTOCOL_COMMAND_SIZE + PROTOCOL_OVERHEAD_SIZE)
+#define PROTOCOL_MAX_PARAMETER_SIZE	64  // in bytes (comma separated integers)
+#define PROTOCOL_MAX_PARAMETERS		8
+
+/* The commands of the simplified protocol */
+typedef enum {
+	PROTOCOL_COMMAND_RADAR_TRIGGER = 0,			// RTG
+	PROTOCOL_COMMAND_SET_DESIRED_NUM_TRIGGER,	// DTG<count>
+	PROTOCOL_COMMAND_CLEAR_NUM_TRIGGER,			// CTG
+	PROTOCOL_COMMAND_SET_PULSE_COUNT,			// PLS<pulses>
+	PROTOCOL_COMMAND_RESET_PCNT,				// RST
+	PROTOCOL_COMMAND_PAUSE_PCNT,				// PAU
+	PROTOCOL_COMMAND_RESUME_PCNT,				// RES
+	PROTOCOL_COMMAND_SET_NUM_MEASUREMENT,		// MSR<passes>
+	PROTOCOL_COMMAND_PULSE_GENERATOR,			// GEN<enable>
+	PROTOCOL_COMMAND_PULSE_GENERATOR_CONFIG,	// PGF<maxFreqHz>,<jitterPercent>,<repeat>
+	PROTOCOL_COMMAND_PULSE_GENERATOR_CLEAR,		// PGC
+	PROTOCOL_COMMAND_PULSE_GENERATOR_ADD,		// PGA<type>,<pulses>,<freqHz>,<param>
+	PROTOCOL_COMMAND_SELF_TEST,					// STS<startHz>,<stopHz>,<stepHz>,<pulses>
+	PROTOCOL_COMMAND_TRIGGER_SOURCE,			// MOD<source>
+	PROTOCOL_COMMAND_MOVE,						// MOV<enable>
+	PROTOCOL_COMMAND_MOVE_CONFIG,				// MVF<maxFreqHz>,<jitterPercent>,<repeat>
+	PROTOCOL_COMMAND_MOVE_CLEAR,				// MVC
+	PROTOCOL_COMMAND_MOVE_ADD,					// MVA<type>,<pulses>,<freqHz>,<param>
+	PROTOCOL_COMMAND_READ_TRIGGER_LOG,			// LOG
+	PROTOCOL_COMMAND_SCAN_PLAN,					// SCP<rows>,<columns>,<spacing>,<settle_ms>,<serpentine>
+	PROTOCOL_COMMAND_SCAN_ROW_DIRECTION,		// SCD<row>,<direction>
+	PROTOCOL_COMMAND_SCAN_START,				// SCS<enable>
+	PROTOCOL_COMMAND_READ_HEALTH,				// HLT
+	PROTOCOL_COMMAND_GLITCH_FILTER,				// FLT<max glitch ns>
+	PROTOCOL_COMMAND_ANALYZE_SIGNAL,			// ANA<edges>,<short threshold ns>
+	PROTOCOL_COMMAND_COUNTER_MODE,				// PCM<mode>
+	PROTOCOL_COMMAND_DRIFT_TEST,				// SDT<mode>,<spacing>,<triggers>,<freqHz>
+	PROTOCOL_COMMAND_TRIGGER_BURST,				// BST<pulses>,<interval us>
+	PROTOCOL_COMMAND_TIME_SYNC,					// SYN<mode>,<rate Hz>
+	PROTOCOL_COMMAND_STREAM_TRIGGER_LOG,		// LGS<enable>
+	PROTOCOL_COMMAND_PHYSICAL_SPACING,			// SPU<pulses per m>,<spacing um>
+	PROTOCOL_COMMAND_INDEX_CODE,				// IDC<enable>,<baud>
+	PROTOCOL_COMMAND_GATE,						// GAT<mode>,<active level>
+	PROTOCOL_COMMAND_GATE_WINDOW,				// GWN<start>,<end>
+	PROTOCOL_COMMAND_CLOCK_EXCHANGE,			// HCK<tag>
+	PROTOCOL_COMMAND_TRIGGER_GRID,				// GRD<origin x>,<origin y>,<pitch x>,<pitch y>,<num x>,<num y>,<tolerance y>
+	PROTOCOL_COMMAND_RESET_Y,					// YRS
+	PROTOCOL_COMMAND_FLASH_LOG_RECORD,			// FLR<enable>
+	PROTOCOL_COMMAND_FLASH_LOG_LIST,			// FLL
+	PROTOCOL_COMMAND_FLASH_LOG_DUMP,			// FLD<scan id>
+	PROTOCOL_COMMAND_FLASH_LOG_ERASE,			// FLX
+	PROTOCOL_COMMAND_PASS_CONFIG,				// MPC<boundary>,<offset>
+	PROTOCOL_COMMAND_COUNT,
+} protocol_command_t;
+
+/* The result of parsing a packet */
+typedef enum {
+	PROTOCOL_OK = 0,
+	PROTOCOL_ERROR_TOO_SHORT,			// shorter than $XXX#
+	PROTOCOL_ERROR_TOO_LONG,			// parameters longer than PROTOCOL_MAX_PARAMETER_SIZE
+	PROTOCOL_ERROR_START_SYMBOL,		// does not start with $
+	PROTOCOL_ERROR_STOP_SYMBOL,			// does not end with #
+	PROTOCOL_ERROR_UNKNOWN_COMMAND,		// not in the command table
+	PROTOCOL_ERROR_PARAMETERS,			// malformed, out of the int32 range or wrong number of parameters
+} protocol_status_t;
+
+/* A parsed packet */
+typedef struct {
+	protocol_command_t command;
+	int numParameters;
+	int32_t parameters[PROTOCOL_MAX_PARAMETERS];
+} protocol_frame_t;
+
+/*
+	Parse a single packet
+	The buffer does not need to be null terminated and is never modified
+*/
+protocol_status_t protocolParseFrame(const uint8_t* pBuffer, uint32_t sizeInBytes, protocol_frame_t* pFrame);
+
+/* The three letter name of a command ("???" if it is out of range) */
+const char* protocolCommandName(protocol_command_t command);
+
+/* A readable description of a parse result */
+const char* protocolStatusName(protocol_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
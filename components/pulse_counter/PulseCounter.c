@@ -22,37 +22,185 @@
 */
 
 #include <PulseCounter.h>
+#include <Health.h>
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "hal/gpio_ll.h"
+#include "freertos/semphr.h"
 
 
 /* PCNT unit */
 pcnt_unit_handle_t pcnt_unit;
 
-/* A queue to handle pulse counter events */
-QueueHandle_t pcnt_evt_queue;
+/* PCNT channels of the external encoder and the internal step generator */
+static pcnt_channel_handle_t pcnt_encoder_chan;
+static pcnt_channel_handle_t pcnt_step_chan;
 
-/* PCNT threshold value */
+/* Capture time of the last counted input edge */
+extern uint32_t edgeCaptureGetInputTicks(void);
+
+/* The radar trigger task, notified on every watch point */
+extern TaskHandle_t xRadarTriggerTask;
+
+/* Watch point events (single producer: the PCNT interrupt, single consumer: the radar trigger task) */
+static pcnt_evt_t pcntEventRing[PCNT_EVT_RING_LENGTH];
+static volatile uint32_t pcntEventHead = 0;
+static volatile uint32_t pcntEventTail = 0;
+
+/* Sends the trigger pulse of a watch point right in the interrupt (NULL: the task does it all) */
+static volatile pcnt_trigger_handler_t pcntTriggerHandler = NULL;
+
+/* PCNT threshold value (the active trigger spacing) */
 int pcntThreshold;
 
+/* The spacing that takes over at the next trigger boundary (0: none) */
+static volatile int pcntPendingThreshold = 0;
+
+/* The two hardware threshold points: the active spacing and the shadow of a spacing change (0: free) */
+static int pcntWatchPoints[2] = { 0, 0 };
+
+/* Guards the hand over from the pending to the active spacing */
+static portMUX_TYPE pcntThresholdLock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Guards the watch points and the trigger state against the tasks that change them:
+ * the radar trigger task re-arms the points while the Uart, scan plan and self-test tasks
+ * clear the count or change the mode and the spacing
+ */
+static SemaphoreHandle_t pcntConfigMutex;
+static StaticSemaphore_t pcntConfigMutexBuffer;
+
+/* The counting mode */
+static volatile pcnt_mode_t pcntMode = PCNT_MODE_RELATIVE;
+
+/* Whether the counter counts: $PAU, an armed scan plan or pass sequence stop it (guarded by pcntConfigMutex) */
+static bool pcntRunning = false;
+
+/* Absolute mode: trigger k is armed on pcntAbsolutePoints[k & 1], the interrupt counts the reached points
+ * and the radar trigger task re-arms them (the high limit stays armed to count the hardware wraps)
+ */
+static volatile int pcntAbsolutePoints[2];
+static volatile int pcntAbsoluteSpacing[2];
+static int64_t pcntAbsoluteTargets[2];		// the positions since the clear (radar trigger task only)
+static volatile uint32_t pcntAbsoluteReached = 0;
+static volatile uint32_t pcntAbsoluteWraps = 0;
+static uint32_t pcntAbsoluteRearmed = 0;
+
+/* Absolute mode: the fraction of a pulse added to every spacing (1/PCNT_FRACTION_ONE pulses, 0: none)
+ * and the ideal minus the armed position of the last armed trigger, kept within half a pulse
+ */
+static int64_t pcntSpacingFraction = 0;
+static int64_t pcntSpacingError = 0;
+
+/* Glitch filter of the radar trigger counter */
+uint32_t pcntGlitchFilter_ns = PCNT_DEFAULT_GLITCH_NS;
+
+/* The gate mode and the active level of the gate input */
+static volatile pcnt_gate_mode_t pcntGateMode = PCNT_GATE_OFF;
+static volatile int pcntGateActiveLevel = 1;
+
+/* The time of the last pass boundary edge, for the hold-off of a bouncing switch */
+static volatile int64_t pcntPassEdge_us = 0;
+
+/* The edges of the pass boundary input */
+static volatile pcnt_pass_boundary_t pcntPassBoundary = PCNT_PASS_BOUNDARY_OFF;
+
 /* PCNT's event callback
- * pass the event data to the main program using a queue.
+ * store the event data and bump the pending count of the radar trigger task.
+ * It runs from IRAM (CONFIG_PCNT_ISR_IRAM_SAFE) while a flash write stops the caches, so it and
+ * everything it calls, the trigger handler too, must be in IRAM: the trigger pulse then goes out on time
+ * even during a write.
  */
-static bool pcnt_handler_on_reach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx)
+static bool IRAM_ATTR pcnt_handler_on_reach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx)
 {
-    BaseType_t high_task_wakeup;
-    QueueHandle_t queue = (QueueHandle_t)user_ctx;
-    
-    /* clear the counter if threshold is reached */
-    if (edata->watch_point_value == pcntThreshold) {
+    BaseType_t high_task_wakeup = pdFALSE;
+    int spacing;
+
+    healthCountIsr(HEALTH_ISR_PCNT_TRIGGER);
+    if (pcntMode == PCNT_MODE_ABSOLUTE) {
+        /* the hardware has cleared the counter at the limit, no pulse is lost */
+        if (edata->watch_point_value == PCNT_H_LIM_VAL) {
+            pcntAbsoluteWraps++;
+        }
+
+        /* only the next trigger point counts, the task re-arms it */
+        uint32_t reached = pcntAbsoluteReached;
+        if (edata->watch_point_value != pcntAbsolutePoints[reached & 1]) {
+            return false;
+        }
+        spacing = pcntAbsoluteSpacing[reached & 1];
+        pcntAbsoluteReached = reached + 1;
+    }
+    else {
+        if (edata->watch_point_value != pcntThreshold) {
+            return false;
+        }
+        spacing = pcntThreshold;
+
+        /* clear the counter if threshold is reached */
         ESP_ERROR_CHECK(pcnt_unit_clear_count(pcnt_unit));
+
+        /* a spacing change takes effect from the cleared count on, its watch point is already armed */
+        portENTER_CRITICAL_ISR(&pcntThresholdLock);
+        if (pcntPendingThreshold != 0) {
+            pcntThreshold = pcntPendingThreshold;
+            pcntPendingThreshold = 0;
+        }
+        portEXIT_CRITICAL_ISR(&pcntThresholdLock);
     }
 
-    /* send watch point to queue, from this interrupt callback */
-    xQueueSendFromISR(queue, &(edata->watch_point_value), &high_task_wakeup);
-    
+    pcnt_evt_t evt = {
+        .watchPoint = edata->watch_point_value,
+        .spacing = spacing,
+        .time_us = esp_timer_get_time(),
+        .edgeTicks = edgeCaptureGetInputTicks(),
+        .gateClosed = !pcntGateIsOpen(),
+        .positionY = pcntYGetPosition(),
+    };
+
+    /* the trigger pulse goes out here, neither the task nor a flash write can delay it */
+    pcnt_trigger_handler_t handler = pcntTriggerHandler;
+    if (handler != NULL) {
+        handler(&evt);
+    }
+
+    /* keep the watch point for the task, unless the ring is full (the trigger is still counted) */
+    uint32_t head = pcntEventHead;
+    if (head - pcntEventTail < PCNT_EVT_RING_LENGTH) {
+        pcntEventRing[head & (PCNT_EVT_RING_LENGTH - 1)] = evt;
+        pcntEventHead = head + 1;
+        healthRecordLevel(HEALTH_QUEUE_PCNT_EVENTS, head + 1 - pcntEventTail);
+    }
+    else {
+        healthRecordDrop(HEALTH_QUEUE_PCNT_EVENTS);
+    }
+
+    /* a notification is much cheaper than a queue send, it only increments the pending count */
+    xTaskNotifyFromISR(xRadarTriggerTask, 1, eIncrement, &high_task_wakeup);
+
     /* return whether a high priority task has been waken up by this function */
     return (high_task_wakeup == pdTRUE);
 }
 
+/* Pass boundary GPIO interrupt
+ * flag the boundary to the radar trigger task, it handles the watch points pending before it first
+ */
+static void IRAM_ATTR pcnt_pass_on_edge(void* arg)
+{
+    BaseType_t high_task_wakeup = pdFALSE;
+
+    healthCountIsr(HEALTH_ISR_PASS_BOUNDARY);
+    int64_t now_us = esp_timer_get_time();
+    if (now_us - pcntPassEdge_us < PCNT_PASS_HOLDOFF_US) {
+        return;
+    }
+    pcntPassEdge_us = now_us;
+
+    xTaskNotifyFromISR(xRadarTriggerTask, RADAR_TRIGGER_NOTIFY_PASS_BIT, eSetBits, &high_task_wakeup);
+    if (high_task_wakeup == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
 
 /* Initialize PCNT functions:
  *  - configure and initialize PCNT
@@ -65,6 +213,9 @@ void pcntInitialize(void)
     static const char *TAG = "PCNT_INIT";
     esp_log_level_set(TAG, ESP_LOG_INFO);   
     
+    pcntConfigMutex = xSemaphoreCreateMutexStatic(&pcntConfigMutexBuffer);
+    configASSERT(pcntConfigMutex);
+
     /* install pcnt unit */
     pcnt_unit_config_t unit_config = {
         .high_limit = PCNT_H_LIM_VAL,
@@ -74,33 +225,606 @@ void pcntInitialize(void)
     
     /* set glitch filter, ignore pulses lasting shorter than this */
     pcnt_glitch_filter_config_t filter_config = {
-        .max_glitch_ns = 125,
+        .max_glitch_ns = pcntGlitchFilter_ns,
     };
     ESP_ERROR_CHECK(pcnt_unit_set_glitch_filter(pcnt_unit, &filter_config));
 
     /* install pcnt channel */
     pcnt_chan_config_t chan_config = {
         .edge_gpio_num = PCNT_INPUT_EDGE_IO,
-        .level_gpio_num = -1,
+        .level_gpio_num = PCNT_GATE_INPUT_IO,
     };
-    pcnt_channel_handle_t pcnt_chan = NULL;
-    ESP_ERROR_CHECK(pcnt_new_channel(pcnt_unit, &chan_config, &pcnt_chan)); 
-   
-    /* set edge action for pcnt channels: keep the counter on rising edge, increase the counter on falling edge */
-    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(pcnt_chan, PCNT_CHANNEL_EDGE_ACTION_HOLD, PCNT_CHANNEL_EDGE_ACTION_INCREASE));
+    ESP_ERROR_CHECK(pcnt_new_channel(pcnt_unit, &chan_config, &pcnt_encoder_chan)); 
+
+    /* install the step generator channel, its output is sampled through the GPIO matrix */
+    pcnt_chan_config_t step_chan_config = {
+        .edge_gpio_num = PCNT_INPUT_STEP_IO,
+        .level_gpio_num = PCNT_GATE_INPUT_IO,
+        .flags.io_loop_back = true,
+    };
+    ESP_ERROR_CHECK(pcnt_new_channel(pcnt_unit, &step_chan_config, &pcnt_step_chan));
+
+    /* count the external encoder by default, the gate is off until it is selected */
+    pcntSelectInput(PCNT_INPUT_ENCODER);
+    ESP_ERROR_CHECK(pcntSetGate(PCNT_GATE_OFF, 1));
+
+    /* the pass boundary input, its interrupt is off until a boundary is selected */
+    gpio_config_t passGpioConfig = {
+        .intr_type = GPIO_INTR_DISABLE,
+        .mode = GPIO_MODE_INPUT,
+        .pin_bit_mask = (1ULL << PCNT_PASS_INPUT_IO),
+        .pull_down_en = 0,
+        .pull_up_en = 1,
+    };
+    ESP_ERROR_CHECK(gpio_config(&passGpioConfig));
+    ESP_ERROR_CHECK(gpio_install_isr_service(0));
+    ESP_ERROR_CHECK(gpio_isr_handler_add(PCNT_PASS_INPUT_IO, pcnt_pass_on_edge, NULL));
     
     /* add watch point */
     pcntThreshold = 10;
     ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_unit, pcntThreshold));
+    pcntWatchPoints[0] = pcntThreshold;
+
+    /* track the fill level of the watch point events */
+    healthSetQueueCapacity(HEALTH_QUEUE_PCNT_EVENTS, PCNT_EVT_RING_LENGTH);
+    healthSetQueueCapacity(HEALTH_QUEUE_TRIGGER_POINTS, 2);
 
     /* register callbacks */
     pcnt_event_callbacks_t cbs = {
         .on_reach = pcnt_handler_on_reach,
     };
-    ESP_ERROR_CHECK(pcnt_unit_register_event_callbacks(pcnt_unit, &cbs, pcnt_evt_queue));
+    ESP_ERROR_CHECK(pcnt_unit_register_event_callbacks(pcnt_unit, &cbs, NULL));
     
      /* Enable, clear, and start pcnt unit */
     ESP_ERROR_CHECK(pcnt_unit_enable(pcnt_unit));
     ESP_ERROR_CHECK(pcnt_unit_clear_count(pcnt_unit));
     ESP_ERROR_CHECK(pcnt_unit_start(pcnt_unit));
+    pcntRunning = true;
+}
+
+/* Select the input that drives the radar trigger:
+ *  - the external encoder (motion controller) on PCNT_INPUT_EDGE_IO
+ *  - the internal step generator on PCNT_INPUT_STEP_IO
+ */
+void pcntSelectInput(pcnt_input_t input)
+{
+    /* set edge action for pcnt channels: keep the counter on rising edge, increase the counter on falling edge */
+    pcnt_channel_handle_t activeChan = (input == PCNT_INPUT_STEP) ? pcnt_step_chan : pcnt_encoder_chan;
+    pcnt_channel_handle_t idleChan = (input == PCNT_INPUT_STEP) ? pcnt_encoder_chan : pcnt_step_chan;
+
+    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(idleChan, PCNT_CHANNEL_EDGE_ACTION_HOLD, PCNT_CHANNEL_EDGE_ACTION_HOLD));
+    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(activeChan, PCNT_CHANNEL_EDGE_ACTION_HOLD, PCNT_CHANNEL_EDGE_ACTION_INCREASE));
+}
+
+/* Cancel a spacing change that has not taken effect yet
+ * and remove every watch point except the active one
+ */
+static void pcntReleaseShadowWatchPoint(void)
+{
+    /* from here on the interrupt leaves the active spacing alone */
+    portENTER_CRITICAL(&pcntThresholdLock);
+    pcntPendingThreshold = 0;
+    portEXIT_CRITICAL(&pcntThresholdLock);
+
+    for (int i = 0; i < 2; i++) {
+        if (pcntWatchPoints[i] != 0 && pcntWatchPoints[i] != pcntThreshold) {
+            ESP_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit, pcntWatchPoints[i]));
+            pcntWatchPoints[i] = 0;
+        }
+    }
+}
+
+/* Arm a watch point on a free hardware threshold point */
+static void pcntAddWatchPoint(int watchPoint)
+{
+    int i = (pcntWatchPoints[0] == 0) ? 0 : 1;
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_unit, watchPoint));
+    pcntWatchPoints[i] = watchPoint;
+}
+
+/* Remove the active watch point of the relative mode */
+static void pcntRemoveActiveWatchPoint(void)
+{
+    ESP_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit, pcntThreshold));
+    pcntWatchPoints[(pcntWatchPoints[0] == pcntThreshold) ? 0 : 1] = 0;
+}
+
+/* The counter value of an absolute trigger point, the counter reads zero at multiples of the limit */
+static inline int pcntWrapPoint(int64_t position)
+{
+    int point = (int)(position % PCNT_H_LIM_VAL);
+    return (point == 0) ? PCNT_H_LIM_VAL : point;
+}
+
+/* Arm or disarm a trigger point of the absolute mode, the high limit is always armed */
+static void pcntArmAbsolutePoint(int point, bool arm)
+{
+    if (point == PCNT_H_LIM_VAL) {
+        return;
+    }
+    if (arm) {
+        ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_unit, point));
+    }
+    else {
+        ESP_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit, point));
+    }
+}
+
+/* The spacing of the next trigger of the absolute mode
+ * the accumulated fraction adds a pulse whenever the ideal position is more than half a pulse ahead
+ */
+static int pcntNextSpacing(void)
+{
+    portENTER_CRITICAL(&pcntThresholdLock);
+    int spacing = pcntThreshold;
+    if (pcntSpacingFraction != 0) {
+        pcntSpacingError += pcntSpacingFraction;
+        if (2 * pcntSpacingError >= PCNT_FRACTION_ONE) {
+            pcntSpacingError -= PCNT_FRACTION_ONE;
+            spacing++;
+        }
+    }
+    portEXIT_CRITICAL(&pcntThresholdLock);
+    return spacing;
+}
+
+/* Drop the fraction of the spacing, the triggers are armed in whole pulses */
+static void pcntClearSpacingFraction(void)
+{
+    portENTER_CRITICAL(&pcntThresholdLock);
+    pcntSpacingFraction = 0;
+    pcntSpacingError = 0;
+    portEXIT_CRITICAL(&pcntThresholdLock);
+}
+
+/* Arm the first two triggers of the absolute mode (the counter is stopped at zero)
+ * the first trigger comes offset pulses after its spacing, the offset is part of its spacing
+ */
+static void pcntArmAbsoluteFromZero(int offset)
+{
+    int64_t position = 0;
+
+    pcntAbsoluteReached = 0;
+    pcntAbsoluteRearmed = 0;
+    pcntAbsoluteWraps = 0;
+    pcntSpacingError = 0;
+    for (int i = 0; i < 2; i++) {
+        int spacing = pcntNextSpacing() + ((i == 0) ? offset : 0);
+        position += spacing;
+        pcntAbsoluteTargets[i] = position;
+        pcntAbsolutePoints[i] = pcntWrapPoint(position);
+        pcntAbsoluteSpacing[i] = spacing;
+        pcntArmAbsolutePoint(pcntAbsolutePoints[i], true);
+    }
+}
+
+/* Disarm the triggers of the absolute mode (the counter is stopped) */
+static void pcntDisarmAbsolute(void)
+{
+    for (int i = 0; i < 2; i++) {
+        pcntArmAbsolutePoint(pcntAbsolutePoints[i], false);
+    }
+}
+
+/* Select the counting mode
+ * the counter is stopped and cleared while the watch points are replaced
+ */
+esp_err_t pcntSetMode(pcnt_mode_t mode)
+{
+    if (mode != PCNT_MODE_RELATIVE && mode != PCNT_MODE_ABSOLUTE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (mode == pcntMode) {
+        return ESP_OK;
+    }
+
+    /* stop and clear the counter */
+    xSemaphoreTake(pcntConfigMutex, portMAX_DELAY);
+    ESP_ERROR_CHECK(pcnt_unit_stop(pcnt_unit));
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(pcnt_unit));
+
+    if (mode == PCNT_MODE_ABSOLUTE) {
+        /* a pending spacing change is taken over right away */
+        int threshold = pcntGetThreshold();
+        pcntReleaseShadowWatchPoint();
+        pcntRemoveActiveWatchPoint();
+        pcntThreshold = threshold;
+
+        ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_unit, PCNT_H_LIM_VAL));
+        pcntArmAbsoluteFromZero(0);
+    }
+    else {
+        /* the relative mode counts whole pulses */
+        pcntDisarmAbsolute();
+        pcntClearSpacingFraction();
+        ESP_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit, PCNT_H_LIM_VAL));
+        pcntAddWatchPoint(pcntThreshold);
+    }
+    pcntMode = mode;
+
+    /* a stopped counter stays stopped */
+    if (pcntRunning) {
+        ESP_ERROR_CHECK(pcnt_unit_start(pcnt_unit));
+    }
+    xSemaphoreGive(pcntConfigMutex);
+    return ESP_OK;
+}
+
+/* Get the counting mode */
+pcnt_mode_t pcntGetMode(void)
+{
+    return pcntMode;
+}
+
+/* Change the pulse count threshold
+ * the counter is stopped and cleared while the watch point is replaced
+ */
+void pcntSetThreshold(int threshold)
+{
+    /* stop and clear the counter */
+    xSemaphoreTake(pcntConfigMutex, portMAX_DELAY);
+    ESP_ERROR_CHECK(pcnt_unit_stop(pcnt_unit));
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(pcnt_unit));
+
+    if (pcntMode == PCNT_MODE_ABSOLUTE) {
+        pcntDisarmAbsolute();
+        pcntClearSpacingFraction();
+        pcntThreshold = threshold;
+        pcntArmAbsoluteFromZero(0);
+    }
+    else {
+        pcntReleaseShadowWatchPoint();
+        if (threshold != pcntThreshold) {
+            pcntRemoveActiveWatchPoint();
+            pcntAddWatchPoint(threshold);
+            pcntThreshold = threshold;
+        }
+    }
+
+    /* a stopped counter stays stopped */
+    if (pcntRunning) {
+        ESP_ERROR_CHECK(pcnt_unit_start(pcnt_unit));
+    }
+    xSemaphoreGive(pcntConfigMutex);
+}
+
+/* Change the pulse count threshold at the next trigger boundary
+ * the new spacing is armed on the second hardware threshold point while the counter keeps running,
+ * the interrupt hands over to it when it clears the count at the current spacing
+ */
+esp_err_t pcntUpdateThreshold(int threshold)
+{
+    if (threshold <= 0 || threshold >= PCNT_H_LIM_VAL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* the next re-arm uses the new spacing */
+    if (pcntMode == PCNT_MODE_ABSOLUTE) {
+        portENTER_CRITICAL(&pcntThresholdLock);
+        pcntThreshold = threshold;
+        pcntSpacingFraction = 0;
+        pcntSpacingError = 0;
+        portEXIT_CRITICAL(&pcntThresholdLock);
+        return ESP_OK;
+    }
+
+    /* the previous change has taken effect by now, or it is replaced by this one */
+    xSemaphoreTake(pcntConfigMutex, portMAX_DELAY);
+    pcntReleaseShadowWatchPoint();
+    if (threshold != pcntThreshold) {
+        /* a smaller spacing is passed unnoticed until it becomes the active one */
+        pcntAddWatchPoint(threshold);
+
+        portENTER_CRITICAL(&pcntThresholdLock);
+        pcntPendingThreshold = threshold;
+        portEXIT_CRITICAL(&pcntThresholdLock);
+    }
+    xSemaphoreGive(pcntConfigMutex);
+    return ESP_OK;
+}
+
+/* Get the spacing that is (or will be at the next trigger) in effect */
+int pcntGetThreshold(void)
+{
+    int pending = pcntPendingThreshold;
+    return (pending != 0) ? pending : pcntThreshold;
+}
+
+/* The greatest common divisor */
+static int64_t pcntGcd(int64_t a, int64_t b)
+{
+    while (b != 0) {
+        int64_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/* Set the trigger spacing in physical units (absolute mode only)
+ * the spacing is split in whole pulses and a fraction of 1/PCNT_FRACTION_ONE pulses,
+ * the next re-arm picks up both (the trigger after the next one is already armed)
+ */
+esp_err_t pcntSetPhysicalSpacing(uint32_t pulsesPerMeter, uint32_t spacing_um, pcnt_spacing_info_t* pInfo)
+{
+    if (pcntMode != PCNT_MODE_ABSOLUTE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* the distance between two triggers in 1/PCNT_FRACTION_ONE pulses, the rounding may add a pulse */
+    int64_t distance = (int64_t)pulsesPerMeter * spacing_um;
+    int64_t whole = distance / PCNT_FRACTION_ONE;
+    int64_t fraction = distance % PCNT_FRACTION_ONE;
+    if (whole < 1 || whole + 1 >= PCNT_H_LIM_VAL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* the new grid starts at the trigger armed last, unless the mode has changed meanwhile */
+    xSemaphoreTake(pcntConfigMutex, portMAX_DELAY);
+    if (pcntMode != PCNT_MODE_ABSOLUTE) {
+        xSemaphoreGive(pcntConfigMutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+    portENTER_CRITICAL(&pcntThresholdLock);
+    pcntThreshold = (int)whole;
+    pcntSpacingFraction = fraction;
+    pcntSpacingError = 0;
+    portEXIT_CRITICAL(&pcntThresholdLock);
+    xSemaphoreGive(pcntConfigMutex);
+
+    /* the error takes the values k / q of a pulse, with q the reduced denominator of the fraction,
+     * the nearest pulse is at most floor(q / 2) / q pulses away
+     */
+    int64_t q = (fraction != 0) ? PCNT_FRACTION_ONE / pcntGcd(fraction, PCNT_FRACTION_ONE) : 1;
+    pInfo->spacing_mpulses = (uint32_t)(distance / (PCNT_FRACTION_ONE / 1000));
+    pInfo->maxError_nm = (uint32_t)((q / 2) * 1000000000LL / (q * pulsesPerMeter));
+    return ESP_OK;
+}
+
+/* Start counting */
+void pcntStart(void)
+{
+    xSemaphoreTake(pcntConfigMutex, portMAX_DELAY);
+    ESP_ERROR_CHECK(pcnt_unit_start(pcnt_unit));
+    pcntRunning = true;
+    xSemaphoreGive(pcntConfigMutex);
+}
+
+/* Stop counting, the count is kept */
+void pcntStop(void)
+{
+    xSemaphoreTake(pcntConfigMutex, portMAX_DELAY);
+    ESP_ERROR_CHECK(pcnt_unit_stop(pcnt_unit));
+    pcntRunning = false;
+    xSemaphoreGive(pcntConfigMutex);
+}
+
+/* Clear the counter and arm the triggers from zero (call with the counter stopped) */
+void pcntClearCount(void)
+{
+    xSemaphoreTake(pcntConfigMutex, portMAX_DELAY);
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(pcnt_unit));
+    if (pcntMode == PCNT_MODE_ABSOLUTE) {
+        pcntDisarmAbsolute();
+        pcntArmAbsoluteFromZero(0);
+    }
+    xSemaphoreGive(pcntConfigMutex);
+}
+
+/* Clear the counter and arm the triggers offset pulses later (absolute mode, call with the counter stopped) */
+esp_err_t pcntClearCountWithOffset(int offset)
+{
+    xSemaphoreTake(pcntConfigMutex, portMAX_DELAY);
+    esp_err_t err = pcntCheckOffset(offset);
+    if (err != ESP_OK) {
+        xSemaphoreGive(pcntConfigMutex);
+        return err;
+    }
+
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(pcnt_unit));
+    if (pcntMode == PCNT_MODE_ABSOLUTE) {
+        pcntDisarmAbsolute();
+        pcntArmAbsoluteFromZero(offset);
+    }
+    xSemaphoreGive(pcntConfigMutex);
+    return ESP_OK;
+}
+
+/* Check that the first trigger still falls into the counter range after an offset
+ * the first point is tracked in lap 0 only, beyond the high limit it would fire a lap early,
+ * the rounding of a fractional spacing may add a pulse
+ */
+esp_err_t pcntCheckOffset(int64_t offset)
+{
+    if (offset < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (offset == 0) {
+        return ESP_OK;
+    }
+    if (pcntMode != PCNT_MODE_ABSOLUTE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int64_t spacing = pcntGetThreshold() + ((pcntSpacingFraction != 0) ? 1 : 0);
+    return (offset + spacing < PCNT_H_LIM_VAL) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+/* Get the pulses counted since the last clear (absolute mode) or since the last trigger (relative mode) */
+int64_t pcntGetPosition(void)
+{
+    uint32_t wraps;
+    int count;
+
+    /* read again if the counter has wrapped in between */
+    do {
+        wraps = pcntAbsoluteWraps;
+        ESP_ERROR_CHECK(pcnt_unit_get_count(pcnt_unit, &count));
+    } while (wraps != pcntAbsoluteWraps);
+
+    if (pcntMode == PCNT_MODE_ABSOLUTE) {
+        return (int64_t)wraps * PCNT_H_LIM_VAL + count;
+    }
+    return count;
+}
+
+/* Re-arm the reached trigger points of the absolute mode
+ * a point is moved one spacing beyond the other one, before the counter gets there
+ */
+void pcntRearmWatchPoints(void)
+{
+    if (pcntMode != PCNT_MODE_ABSOLUTE) {
+        return;
+    }
+
+    /* a clear or a mode change in between has armed the points anew */
+    xSemaphoreTake(pcntConfigMutex, portMAX_DELAY);
+    while (pcntMode == PCNT_MODE_ABSOLUTE && pcntAbsoluteRearmed != pcntAbsoluteReached) {
+        uint32_t slot = pcntAbsoluteRearmed & 1;
+        int spacing = pcntNextSpacing();
+        int64_t target = pcntAbsoluteTargets[slot ^ 1] + spacing;
+
+        /* a late re-arm (a small spacing at a high rate, or a stalled task): the count is past the point already,
+         * and the hardware would only see it a lap later. Move on to the next point ahead, its spacing
+         * covers the skipped ones, so the trigger position stays right, and count every skipped trigger.
+         */
+        int64_t position = pcntGetPosition();
+        while (target <= position) {
+            int next = pcntNextSpacing();
+            spacing += next;
+            target += next;
+            healthRecordDrop(HEALTH_QUEUE_TRIGGER_POINTS);
+        }
+        int point = pcntWrapPoint(target);
+
+        /* the interrupt is waiting for the other slot, update this one before arming it */
+        pcntArmAbsolutePoint(pcntAbsolutePoints[slot], false);
+        pcntAbsoluteTargets[slot] = target;
+        pcntAbsolutePoints[slot] = point;
+        pcntAbsoluteSpacing[slot] = spacing;
+        pcntArmAbsolutePoint(point, true);
+        pcntAbsoluteRearmed++;
+    }
+    xSemaphoreGive(pcntConfigMutex);
+}
+
+/* Replace the glitch filter of a pulse counter unit
+ * the filter can only be changed while the unit is disabled, the count is kept
+ */
+static void pcntReplaceGlitchFilter(pcnt_unit_handle_t unit, uint32_t maxGlitch_ns, bool running)
+{
+    pcnt_glitch_filter_config_t filter_config = {
+        .max_glitch_ns = maxGlitch_ns,
+    };
+
+    if (running) {
+        ESP_ERROR_CHECK(pcnt_unit_stop(unit));
+    }
+    ESP_ERROR_CHECK(pcnt_unit_disable(unit));
+    ESP_ERROR_CHECK(pcnt_unit_set_glitch_filter(unit, (maxGlitch_ns > 0) ? &filter_config : NULL));
+    ESP_ERROR_CHECK(pcnt_unit_enable(unit));
+    if (running) {
+        ESP_ERROR_CHECK(pcnt_unit_start(unit));
+    }
+}
+
+/* Change the glitch filter of a free running pulse counter unit */
+esp_err_t pcntSetUnitGlitchFilter(pcnt_unit_handle_t unit, uint32_t maxGlitch_ns)
+{
+    if (maxGlitch_ns > PCNT_MAX_GLITCH_NS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pcntReplaceGlitchFilter(unit, maxGlitch_ns, true);
+    return ESP_OK;
+}
+
+/* Change the glitch filter of the radar trigger counter, a stopped counter stays stopped */
+esp_err_t pcntSetGlitchFilter(uint32_t maxGlitch_ns)
+{
+    if (maxGlitch_ns > PCNT_MAX_GLITCH_NS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(pcntConfigMutex, portMAX_DELAY);
+    pcntReplaceGlitchFilter(pcnt_unit, maxGlitch_ns, pcntRunning);
+    pcntGlitchFilter_ns = maxGlitch_ns;
+    xSemaphoreGive(pcntConfigMutex);
+    return ESP_OK;
+}
+
+/* Select the gate mode and the active level of the gate input
+ * the hold mode stops the counter of both channels at the inactive level in hardware
+ */
+esp_err_t pcntSetGate(pcnt_gate_mode_t mode, int activeLevel)
+{
+    if (mode >= PCNT_GATE_MODE_COUNT || (activeLevel != 0 && activeLevel != 1)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pcnt_channel_level_action_t highAction = PCNT_CHANNEL_LEVEL_ACTION_KEEP;
+    pcnt_channel_level_action_t lowAction = PCNT_CHANNEL_LEVEL_ACTION_KEEP;
+    if (mode == PCNT_GATE_HOLD_COUNT) {
+        highAction = (activeLevel == 1) ? PCNT_CHANNEL_LEVEL_ACTION_KEEP : PCNT_CHANNEL_LEVEL_ACTION_HOLD;
+        lowAction = (activeLevel == 1) ? PCNT_CHANNEL_LEVEL_ACTION_HOLD : PCNT_CHANNEL_LEVEL_ACTION_KEEP;
+    }
+    ESP_ERROR_CHECK(pcnt_channel_set_level_action(pcnt_encoder_chan, highAction, lowAction));
+    ESP_ERROR_CHECK(pcnt_channel_set_level_action(pcnt_step_chan, highAction, lowAction));
+
+    pcntGateActiveLevel = activeLevel;
+    pcntGateMode = mode;
+    return ESP_OK;
+}
+
+/* Check whether the gate lets a trigger through */
+bool IRAM_ATTR pcntGateIsOpen(void)
+{
+    /* the register read of the low level driver is inlined, gpio_get_level() lives in flash */
+    return (pcntGateMode != PCNT_GATE_SUPPRESS_TRIGGER) || (gpio_ll_get_level(&GPIO, PCNT_GATE_INPUT_IO) == pcntGateActiveLevel);
+}
+
+/* Select the edges of the pass boundary input that start a new measurement pass */
+esp_err_t pcntSetPassBoundary(pcnt_pass_boundary_t boundary)
+{
+    static const gpio_int_type_t intrTypes[PCNT_PASS_BOUNDARY_COUNT] = {
+        [PCNT_PASS_BOUNDARY_OFF] = GPIO_INTR_DISABLE,
+        [PCNT_PASS_BOUNDARY_RISING] = GPIO_INTR_POSEDGE,
+        [PCNT_PASS_BOUNDARY_FALLING] = GPIO_INTR_NEGEDGE,
+        [PCNT_PASS_BOUNDARY_REVERSAL] = GPIO_INTR_ANYEDGE,
+    };
+
+    if (boundary >= PCNT_PASS_BOUNDARY_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ESP_ERROR_CHECK(gpio_intr_disable(PCNT_PASS_INPUT_IO));
+    ESP_ERROR_CHECK(gpio_set_intr_type(PCNT_PASS_INPUT_IO, intrTypes[boundary]));
+    if (boundary != PCNT_PASS_BOUNDARY_OFF) {
+        ESP_ERROR_CHECK(gpio_intr_enable(PCNT_PASS_INPUT_IO));
+    }
+    pcntPassBoundary = boundary;
+    return ESP_OK;
+}
+
+/* Get the edges of the pass boundary input that start a new measurement pass */
+pcnt_pass_boundary_t pcntGetPassBoundary(void)
+{
+    return pcntPassBoundary;
+}
+
+/* Send the trigger pulse of a watch point from the PCNT interrupt (NULL: off) */
+void pcntSetTriggerHandler(pcnt_trigger_handler_t handler)
+{
+    pcntTriggerHandler = handler;
+}
+
+/* Read the oldest watch point event */
+bool pcntReadEvent(pcnt_evt_t* pEvt)
+{
+    uint32_t tail = pcntEventTail;
+    if (tail == pcntEventHead) {
+        return false;
+    }
+    *pEvt = pcntEventRing[tail & (PCNT_EVT_RING_LENGTH - 1)];
+    pcntEventTail = tail + 1;
+    return true;
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	PulseCounterY.c
+
+  Abstract:
+
+	The implementation file of the Y axis pulse counter
+	(a second encoder with a direction input, for 2D scanners)
+*/
+
+#include <PulseCounter.h>
+#include "hal/gpio_ll.h"
+
+
+/* PCNT unit and channel of the Y axis */
+static pcnt_unit_handle_t pcnt_y_unit;
+static pcnt_channel_handle_t pcnt_y_chan;
+
+/* The pulses of the hardware wraps, the counter is cleared at either limit */
+static volatile int32_t pcntYWrapOffset = 0;
+
+/* The guard band the count is in: 1 below the high limit, -1 above the low limit, 0 neither.
+ * All PCNT units share one interrupt, so the radar trigger counter can read the Y count after the
+ * hardware has cleared it at a limit but before this unit's limit callback has run. A count near zero
+ * while the band is still set is such a pending wrap.
+ */
+static volatile int pcntYBand = 0;
+
+/* Y axis watch point callback
+ * add the wrapped count to the offset at a limit, follow the count into and out of the guard bands
+ */
+static bool IRAM_ATTR pcnt_y_handler_on_reach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx)
+{
+    int value = edata->watch_point_value;
+
+    if (value == PCNT_H_LIM_VAL || value == PCNT_L_LIM_VAL) {
+        pcntYWrapOffset += value;
+        pcntYBand = 0;
+        return false;
+    }
+
+    /* the band edge is reached from either side, the count or else the direction tells which */
+    int count = 0;
+    pcnt_unit_get_count(unit, &count);
+    bool up = gpio_ll_get_level(&GPIO, PCNT_Y_DIRECTION_IO) != 0;
+    if (value > 0) {
+        pcntYBand = (count > value || (count == value && up)) ? 1 : 0;
+    }
+    else {
+        pcntYBand = (count < value || (count == value && !up)) ? -1 : 0;
+    }
+    return false;
+}
+
+/* Initialize the Y axis counter:
+ *  - count the falling edges of the pulse input, like the radar trigger counter
+ *  - count down while the direction input is low
+ *  - extend the count beyond the hardware limits
+ */
+void pcntYInitialize(void)
+{
+    /* Set the log level */
+    static const char *TAG = "PCNT_Y_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    /* install pcnt unit */
+    pcnt_unit_config_t unit_config = {
+        .high_limit = PCNT_H_LIM_VAL,
+        .low_limit = PCNT_L_LIM_VAL,
+    };
+    ESP_ERROR_CHECK(pcnt_new_unit(&unit_config, &pcnt_y_unit));
+
+    /* set glitch filter, ignore pulses lasting shorter than this */
+    pcnt_glitch_filter_config_t filter_config = {
+        .max_glitch_ns = PCNT_DEFAULT_GLITCH_NS,
+    };
+    ESP_ERROR_CHECK(pcnt_unit_set_glitch_filter(pcnt_y_unit, &filter_config));
+
+    /* install pcnt channel, the direction input inverts the count */
+    pcnt_chan_config_t chan_config = {
+        .edge_gpio_num = PCNT_Y_INPUT_EDGE_IO,
+        .level_gpio_num = PCNT_Y_DIRECTION_IO,
+    };
+    ESP_ERROR_CHECK(pcnt_new_channel(pcnt_y_unit, &chan_config, &pcnt_y_chan));
+    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(pcnt_y_chan, PCNT_CHANNEL_EDGE_ACTION_HOLD, PCNT_CHANNEL_EDGE_ACTION_INCREASE));
+    ESP_ERROR_CHECK(pcnt_channel_set_level_action(pcnt_y_chan, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE));
+
+    /* watch the limits to count the wraps, and the guard bands in front of them */
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_y_unit, PCNT_H_LIM_VAL));
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_y_unit, PCNT_L_LIM_VAL));
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_y_unit, PCNT_H_LIM_VAL - PCNT_Y_GUARD_BAND));
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_y_unit, PCNT_L_LIM_VAL + PCNT_Y_GUARD_BAND));
+
+    /* register callbacks */
+    pcnt_event_callbacks_t cbs = {
+        .on_reach = pcnt_y_handler_on_reach,
+    };
+    ESP_ERROR_CHECK(pcnt_unit_register_event_callbacks(pcnt_y_unit, &cbs, NULL));
+
+    /* Enable, clear, and start pcnt unit */
+    ESP_ERROR_CHECK(pcnt_unit_enable(pcnt_y_unit));
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(pcnt_y_unit));
+    ESP_ERROR_CHECK(pcnt_unit_start(pcnt_y_unit));
+}
+
+/* Get the Y position in pulses (also from the PCNT interrupt)
+ * the count is read again if a wrap is added meanwhile, a wrap whose callback is still pending is added here
+ */
+int32_t IRAM_ATTR pcntYGetPosition(void)
+{
+    int32_t offset;
+    int band;
+    int count = 0;
+
+    do {
+        offset = pcntYWrapOffset;
+        band = pcntYBand;
+        pcnt_unit_get_count(pcnt_y_unit, &count);
+    } while (offset != pcntYWrapOffset || band != pcntYBand);
+
+    /* leaving the band towards zero takes the whole band, a count near zero has wrapped */
+    if (band > 0 && count < PCNT_Y_GUARD_BAND) {
+        offset += PCNT_H_LIM_VAL;
+    }
+    else if (band < 0 && count > -PCNT_Y_GUARD_BAND) {
+        offset += PCNT_L_LIM_VAL;
+    }
+    return offset + count;
+}
+
+/* Set the Y position to zero */
+void pcntYClearPosition(void)
+{
+    ESP_ERROR_CHECK(pcnt_unit_stop(pcnt_y_unit));
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(pcnt_y_unit));
+    pcntYWrapOffset = 0;
+    pcntYBand = 0;
+    ESP_ERROR_CHECK(pcnt_unit_start(pcnt_y_unit));
+}
\ No newline at end of file
@@ -32,6 +32,86 @@
 #define PCNT_H_LIM_VAL      	SHRT_MAX
 #define PCNT_L_LIM_VAL     		SHRT_MIN
 #define PCNT_INPUT_EDGE_IO 		0  // Pulse Input GPIO (Edge)
+#define PCNT_INPUT_STEP_IO 		18 // Internal step generator output GPIO (Edge)
+#define PCNT_GATE_INPUT_IO 		27 // Gate input GPIO (Level), e.g. the "in constant velocity" output of the motion controller
+#define PCNT_Y_INPUT_EDGE_IO 	32 // Y axis pulse input GPIO (Edge)
+#define PCNT_Y_DIRECTION_IO 	33 // Y axis direction input GPIO (Level, low: count down)
+#define PCNT_PASS_INPUT_IO 		13 // Pass boundary input GPIO (Edge), a home switch or the direction line of the motion controller
+
+// Y axis: the band below either limit in which a pending wrap is looked for (far more than the
+// pulses of an interrupt latency)
+#define PCNT_Y_GUARD_BAND		1024
+
+// Pass boundary edges closer than this to the previous one are ignored (a bouncing switch)
+#define PCNT_PASS_HOLDOFF_US	10000
+
+// Glitch filter: pulses shorter than this are ignored (the filter counts up to 1023 APB cycles)
+#define PCNT_DEFAULT_GLITCH_NS	125
+#define PCNT_MAX_GLITCH_NS		12787
+
+// Number of watch point events kept until the radar trigger task reads them (power of two)
+#define PCNT_EVT_RING_LENGTH	16
+
+// A spacing in physical units is kept in 1/PCNT_FRACTION_ONE pulses (um per m, so pulses/m * um is exact)
+#define PCNT_FRACTION_ONE		1000000
+
+/* The input that drives the radar trigger */
+typedef enum {
+	PCNT_INPUT_ENCODER = 0,		// external motion controller pulses
+	PCNT_INPUT_STEP,			// internal step generator pulses
+} pcnt_input_t;
+
+/*
+	The counting mode of the radar trigger counter
+	Relative: the interrupt clears the counter at every trigger, pulses arriving before the clear are lost.
+	Absolute: the counter is never cleared and wraps to zero at PCNT_H_LIM_VAL in hardware,
+	trigger k is armed at k * spacing, so counting errors cannot accumulate.
+	The two hardware threshold points hold the next two triggers and the radar trigger task re-arms them,
+	so a trigger must be handled before the counter reaches the one after it.
+*/
+typedef enum {
+	PCNT_MODE_RELATIVE = 0,
+	PCNT_MODE_ABSOLUTE,
+} pcnt_mode_t;
+
+/*
+	The gate input
+	Hold: the counter only counts while the gate is active (the level input of the pulse counter channels),
+	the positions advance only in the gated zones.
+	Suppress: the counter keeps counting, a watch point reached while the gate is inactive generates no trigger,
+	the positions stay physical and show a gap.
+*/
+typedef enum {
+	PCNT_GATE_OFF = 0,
+	PCNT_GATE_HOLD_COUNT,
+	PCNT_GATE_SUPPRESS_TRIGGER,
+	PCNT_GATE_MODE_COUNT,
+} pcnt_gate_mode_t;
+
+/*
+	The edges of the pass boundary input that start a new measurement pass
+	Rising / falling: a home or index switch that the stage passes once per pass.
+	Reversal: the direction line of the motion controller, every reversal starts a pass.
+*/
+typedef enum {
+	PCNT_PASS_BOUNDARY_OFF = 0,
+	PCNT_PASS_BOUNDARY_RISING,
+	PCNT_PASS_BOUNDARY_FALLING,
+	PCNT_PASS_BOUNDARY_REVERSAL,
+	PCNT_PASS_BOUNDARY_COUNT,
+} pcnt_pass_boundary_t;
+
+/* A trigger spacing in physical units */
+typedef struct {
+	uint32_t spacing_mpulses;	// mean spacing (1/1000 pulses)
+	uint32_t maxError_nm;		// worst-case distance of a trigger from its ideal position
+} pcnt_spacing_info_t;
+
+/* The errors of a rejected physical spacing, replied as $SPX<error># */
+typedef enum {
+	PCNT_SPACING_ERROR_RANGE = 1,		// a parameter is zero or the spacing is not 1 to 32765 pulses
+	PCNT_SPACING_ERROR_MODE,			// the counter is not in the absolute mode
+} pcnt_spacing_error_t;
 
 
 /* Initialize PCNT functions:
@@ -41,4 +121,101 @@
  */
 void pcntInitialize(void);
 
+/* Select the input that drives the radar trigger */
+void pcntSelectInput(pcnt_input_t input);
+
+/* Select the counting mode (the counter is cleared) */
+esp_err_t pcntSetMode(pcnt_mode_t mode);
+
+/* Get the counting mode */
+pcnt_mode_t pcntGetMode(void);
+
+/* Start or stop the radar trigger counter ($PAU/$RES, armed scan plans and pass sequences), the count is kept
+ * the mode, threshold and glitch filter changes leave a stopped counter stopped
+ */
+void pcntStart(void);
+void pcntStop(void);
+
+/* Change the pulse count threshold (the counter is cleared) */
+void pcntSetThreshold(int threshold);
+
+/* Change the pulse count threshold at the next trigger boundary (the counter keeps running)
+ * in the absolute mode the trigger after the next one is already armed, the change takes effect after it
+ */
+esp_err_t pcntUpdateThreshold(int threshold);
+
+/* Clear the counter and arm the triggers from zero (call with the counter stopped) */
+void pcntClearCount(void);
+
+/* Clear the counter and arm the first trigger offset pulses after its spacing (call with the counter stopped)
+ * an offset other than zero needs the absolute mode
+ */
+esp_err_t pcntClearCountWithOffset(int offset);
+
+/* Check that the first trigger still falls into the counter range after an offset, at the current spacing
+ * (ESP_ERR_INVALID_STATE: an offset other than zero in the relative mode)
+ */
+esp_err_t pcntCheckOffset(int64_t offset);
+
+/* Get the pulses counted since the last clear (absolute mode) or since the last trigger (relative mode) */
+int64_t pcntGetPosition(void);
+
+/*
+	The functions that clear the count or change the mode or the spacing can be called from any task,
+	they and the re-arm of the radar trigger task take the same mutex (not from an interrupt)
+*/
+
+/* Re-arm the reached trigger points of the absolute mode (radar trigger task only) */
+void pcntRearmWatchPoints(void);
+
+/* Get the pulse count threshold, including a change that takes effect at the next trigger */
+int pcntGetThreshold(void);
+
+/* Set the trigger spacing in physical units (absolute mode only)
+ * the spacing is usually not a whole number of pulses: every trigger is armed on the pulse nearest to
+ * its ideal position and the fraction is accumulated, so the mean spacing is exact over any scan length.
+ * The change takes effect like pcntUpdateThreshold, a whole pulse threshold cancels it.
+ */
+esp_err_t pcntSetPhysicalSpacing(uint32_t pulsesPerMeter, uint32_t spacing_um, pcnt_spacing_info_t* pInfo);
+
+/* Change the glitch filter of the radar trigger counter (0: no filter) */
+esp_err_t pcntSetGlitchFilter(uint32_t maxGlitch_ns);
+
+/* Change the glitch filter of a free running pulse counter unit (0: no filter), the unit is stopped meanwhile
+ * and started again; the radar trigger counter uses pcntSetGlitchFilter
+ */
+esp_err_t pcntSetUnitGlitchFilter(pcnt_unit_handle_t unit, uint32_t maxGlitch_ns);
+
+/* Select the gate mode and the active level of the gate input */
+esp_err_t pcntSetGate(pcnt_gate_mode_t mode, int activeLevel);
+
+/* Check whether the gate lets a trigger through (always in the off and hold modes) */
+bool pcntGateIsOpen(void);
+
+/* Select the edges of the pass boundary input that start a new measurement pass */
+esp_err_t pcntSetPassBoundary(pcnt_pass_boundary_t boundary);
+
+/* Get the edges of the pass boundary input that start a new measurement pass */
+pcnt_pass_boundary_t pcntGetPassBoundary(void);
+
+/* The trigger handler of the watch points: called from the PCNT interrupt before the event is queued,
+ * it must be in IRAM with everything it calls, and it fills in the trigger fields of the event
+ */
+typedef void (*pcnt_trigger_handler_t)(pcnt_evt_t* pEvt);
+
+/* Send the trigger pulse of a watch point from the PCNT interrupt (NULL: off) */
+void pcntSetTriggerHandler(pcnt_trigger_handler_t handler);
+
+/* Read the oldest watch point event (radar trigger task only), returns false if there is none */
+bool pcntReadEvent(pcnt_evt_t* pEvt);
+
+/* Initialize the Y axis counter (a second encoder with a direction input) */
+void pcntYInitialize(void);
+
+/* Get the Y position in pulses since the last clear (also from the PCNT interrupt) */
+int32_t pcntYGetPosition(void);
+
+/* Set the Y position to zero */
+void pcntYClearPosition(void);
+
 #endif
\ No newline at end of file
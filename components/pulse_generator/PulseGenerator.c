@@ -0,0 +1,414 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	PulseGenerator.c
+
+  Abstract:
+
+	The implementation file of the RMT based motion profile pulse generator
+*/
+
+#include <PulseGenerator.h>
+#include <Health.h>
+#include <math.h>
+#include <string.h>
+#include "esp_random.h"
+
+
+/* The internal test pulse generator (GPIO2) */
+pulse_generator_t testPulseGenerator;
+
+/* RMT transmit done callback
+ * return the transmitted chunk to the free chunk pool
+ */
+static bool pulse_generator_on_trans_done(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t high_task_wakeup = pdFALSE;
+    pulse_generator_t* pGenerator = (pulse_generator_t*)user_ctx;
+
+    healthCountIsr(HEALTH_ISR_RMT_DONE);
+    xSemaphoreGiveFromISR(pGenerator->freeChunks, &high_task_wakeup);
+
+    /* return whether a high priority task has been waken up by this function */
+    return (high_task_wakeup == pdTRUE);
+}
+
+/* Send the partially filled chunk */
+static void flushChunk(pulse_generator_t* pGenerator)
+{
+    if (pGenerator->chunkFill == 0) {
+        return;
+    }
+
+    rmt_transmit_config_t tx_config = {
+        .loop_count = 0,
+    };
+    ESP_ERROR_CHECK(rmt_transmit(pGenerator->channel,
+                                pGenerator->encoder,
+                                pGenerator->chunks[pGenerator->chunkIndex],
+                                pGenerator->chunkFill * sizeof(rmt_symbol_word_t),
+                                &tx_config));
+
+    pGenerator->chunkIndex = (pGenerator->chunkIndex + 1) % PULSE_GENERATOR_NUM_CHUNKS;
+    pGenerator->chunkFill = 0;
+}
+
+/* Append a symbol to the current chunk
+ * returns false if the playback is stopped
+ */
+static bool appendSymbol(pulse_generator_t* pGenerator, uint32_t level0, uint32_t duration0, uint32_t level1, uint32_t duration1)
+{
+    /* a new chunk is started, wait until its buffer is transmitted */
+    if (pGenerator->chunkFill == 0) {
+        if (pGenerator->stopRequested) {
+            return false;
+        }
+        xSemaphoreTake(pGenerator->freeChunks, portMAX_DELAY);
+    }
+
+    rmt_symbol_word_t* pSymbol = &pGenerator->chunks[pGenerator->chunkIndex][pGenerator->chunkFill++];
+    pSymbol->level0 = level0;
+    pSymbol->duration0 = duration0;
+    pSymbol->level1 = level1;
+    pSymbol->duration1 = duration1;
+
+    if (pGenerator->chunkFill == PULSE_GENERATOR_CHUNK_SYMBOLS) {
+        flushChunk(pGenerator);
+    }
+    return true;
+}
+
+/* Wait until every queued chunk is transmitted */
+static void waitAllChunks(pulse_generator_t* pGenerator)
+{
+    flushChunk(pGenerator);
+    ESP_ERROR_CHECK(rmt_tx_wait_all_done(pGenerator->channel, portMAX_DELAY));
+}
+
+/* Append a single pulse at the given frequency */
+static bool emitPulse(pulse_generator_t* pGenerator, float frequencyHz)
+{
+    const pulse_profile_t* pProfile = &pGenerator->profile;
+
+    if (frequencyHz > pProfile->maxFrequencyHz) {
+        frequencyHz = pProfile->maxFrequencyHz;
+    }
+    if (frequencyHz < PULSE_GENERATOR_MIN_FREQUENCY) {
+        frequencyHz = PULSE_GENERATOR_MIN_FREQUENCY;
+    }
+
+    float periodTicks = (float)PULSE_GENERATOR_RESOLUTION_HZ / frequencyHz;
+
+    /* random period variation in [-jitter, +jitter] percent */
+    if (pProfile->jitterPercent > 0) {
+        float uniform = ((float)esp_random() / (float)UINT32_MAX) * 2.0f - 1.0f;
+        periodTicks += periodTicks * uniform * (float)pProfile->jitterPercent / 100.0f;
+    }
+
+    uint32_t period = (uint32_t)(periodTicks + 0.5f);
+    if (period < 2) {
+        period = 2;
+    }
+
+    uint32_t high = PULSE_GENERATOR_PULSE_WIDTH_TICKS;
+    if (high > period / 2) {
+        high = period / 2;
+    }
+    uint32_t low = period - high;
+    if (low > PULSE_GENERATOR_MAX_SYMBOL_TICKS) {
+        low = PULSE_GENERATOR_MAX_SYMBOL_TICKS;
+    }
+
+    if (!appendSymbol(pGenerator, 1, high, 0, low)) {
+        return false;
+    }
+    pGenerator->pulsesSent++;
+    return true;
+}
+
+/* Append an idle (low) period */
+static bool emitGap(pulse_generator_t* pGenerator, uint32_t gap_us)
+{
+    uint64_t ticks = (uint64_t)gap_us * (PULSE_GENERATOR_RESOLUTION_HZ / 1000000);
+
+    /* both halves of a symbol must be non-zero, a zero duration ends the transmission */
+    while (ticks >= 2) {
+        uint32_t take = (ticks > 2 * PULSE_GENERATOR_MAX_SYMBOL_TICKS) ? 2 * PULSE_GENERATOR_MAX_SYMBOL_TICKS : (uint32_t)ticks;
+        if (!appendSymbol(pGenerator, 0, take / 2, 0, take - take / 2)) {
+            return false;
+        }
+        ticks -= take;
+    }
+    return true;
+}
+
+/* Play back a single profile segment */
+static bool playSegment(pulse_generator_t* pGenerator, const pulse_segment_t* pSegment)
+{
+    switch (pSegment->type) {
+        case PULSE_SEGMENT_TRAPEZOID: {
+            /* v = sqrt(v0^2 + 2*a*x), limited by the distance to both ends of the segment */
+            const float v0 = PULSE_GENERATOR_MIN_FREQUENCY;
+            const float acceleration = (float)pSegment->parameter;
+            for (uint32_t k = 0; k < pSegment->numPulses; k++) {
+                float frequency = (float)pSegment->frequencyHz;
+                if (acceleration > 0) {
+                    float vUp = sqrtf(v0 * v0 + 2.0f * acceleration * (float)k);
+                    float vDown = sqrtf(v0 * v0 + 2.0f * acceleration * (float)(pSegment->numPulses - 1 - k));
+                    frequency = fminf(frequency, fminf(vUp, vDown));
+                }
+                if (!emitPulse(pGenerator, frequency)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        case PULSE_SEGMENT_BURST:
+            for (uint32_t k = 0; k < pSegment->numPulses; k++) {
+                if (!emitPulse(pGenerator, (float)pSegment->frequencyHz)) {
+                    return false;
+                }
+            }
+            return emitGap(pGenerator, pSegment->parameter);
+
+        case PULSE_SEGMENT_REVERSAL:
+            /* the direction must only change after the queued pulses are out */
+            waitAllChunks(pGenerator);
+            if (pGenerator->directionIo >= 0) {
+                pGenerator->directionLevel = !pGenerator->directionLevel;
+                gpio_set_level(pGenerator->directionIo, pGenerator->directionLevel);
+            }
+            return emitGap(pGenerator, pSegment->parameter);
+
+        default:
+            return true;
+    }
+}
+
+/* The Pulse Generator Task */
+static void pulseGeneratorTask(void* params)
+{
+    pulse_generator_t* pGenerator = (pulse_generator_t*)params;
+
+    while (1) {
+        /* Block until the playback is started */
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        const pulse_profile_t* pProfile = &pGenerator->profile;
+        bool playing = true;
+        for (uint32_t repeat = 0; playing && (pProfile->repeatCount == 0 || repeat < pProfile->repeatCount); repeat++) {
+            for (uint32_t i = 0; playing && i < pProfile->numSegments; i++) {
+                playing = playSegment(pGenerator, &pProfile->segments[i]);
+            }
+        }
+
+        waitAllChunks(pGenerator);
+        pGenerator->running = false;
+        xSemaphoreGive(pGenerator->done);
+    }
+}
+
+/*
+	Create a pulse generator instance on the given output and direction GPIOs
+	The output stays low until a profile is started
+*/
+void pulseGeneratorCreate(pulse_generator_t* pGenerator, int outputIo, int directionIo, const char* taskName)
+{
+    /* Set the log level */
+    static const char *TAG = "PULSE_GENERATOR_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    memset(pGenerator, 0, sizeof(pulse_generator_t));
+    pGenerator->directionIo = directionIo;
+    pGenerator->profile.maxFrequencyHz = PULSE_GENERATOR_DEFAULT_FREQUENCY;
+
+    /* Prepare the direction output */
+    if (directionIo >= 0) {
+        gpio_config_t directionGpioConfig = {
+            .intr_type = GPIO_INTR_DISABLE,
+            .mode = GPIO_MODE_OUTPUT,
+            .pin_bit_mask = (1ULL << directionIo),
+            .pull_down_en = 0,
+            .pull_up_en = 0,
+        };
+        gpio_config(&directionGpioConfig);
+        gpio_set_level(directionIo, 0);
+    }
+
+    /* Chunk pool and playback state */
+    pGenerator->freeChunks = xSemaphoreCreateCountingStatic(PULSE_GENERATOR_NUM_CHUNKS, PULSE_GENERATOR_NUM_CHUNKS, &pGenerator->freeChunksBuffer);
+    pGenerator->done = xSemaphoreCreateBinaryStatic(&pGenerator->doneBuffer);
+    configASSERT(pGenerator->freeChunks);
+    configASSERT(pGenerator->done);
+
+    /* install RMT TX channel */
+    rmt_tx_channel_config_t tx_chan_config = {
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .gpio_num = outputIo,
+        .mem_block_symbols = 64,
+        .resolution_hz = PULSE_GENERATOR_RESOLUTION_HZ,
+        .trans_queue_depth = PULSE_GENERATOR_NUM_CHUNKS,
+        .flags.io_loop_back = true,     // the pulse counter samples the output internally
+    };
+    ESP_ERROR_CHECK(rmt_new_tx_channel(&tx_chan_config, &pGenerator->channel));
+
+    /* the symbols are prepared by the task, so a copy encoder is sufficient */
+    rmt_copy_encoder_config_t copy_encoder_config = {};
+    ESP_ERROR_CHECK(rmt_new_copy_encoder(&copy_encoder_config, &pGenerator->encoder));
+
+    /* register callbacks */
+    rmt_tx_event_callbacks_t cbs = {
+        .on_trans_done = pulse_generator_on_trans_done,
+    };
+    ESP_ERROR_CHECK(rmt_tx_register_event_callbacks(pGenerator->channel, &cbs, pGenerator));
+    ESP_ERROR_CHECK(rmt_enable(pGenerator->channel));
+
+    /* Create the task, store the handle. */
+    pGenerator->task = xTaskCreateStaticPinnedToCore(
+                        pulseGeneratorTask,                     /* Function that implements the task. */
+                        taskName,                               /* Text name for the task. */
+                        PULSE_GENERATOR_TASK_STACK_SIZE_BYTES,  /* Stack size in bytes. */
+                        pGenerator,                             /* Parameter passed into the task. */
+                        3,                                      /* Priority at which the task is created. */
+                        pGenerator->taskStack,                  /* The task stack. */
+                        &pGenerator->taskBuffer,                /* The task control block. */
+                        1);                                     /* Core number. */
+    if( pGenerator->task == NULL )
+    {
+        /* The task is not created. */
+        ESP_LOGI(TAG, "The Pulse Generator Task could not created.");
+    }
+}
+
+/* Initialize the internal test pulse generator with the default profile */
+void pulseGeneratorInitialize(void)
+{
+    pulseGeneratorCreate(&testPulseGenerator, PULSE_GENERATOR_OUTPUT_IO, PULSE_GENERATOR_DIRECTION_IO, "PulseGeneratorTask");
+
+    /* continuous 100 KHz pulses, the same signal as the former LEDC test mode */
+    pulse_segment_t segment = {
+        .type = PULSE_SEGMENT_BURST,
+        .numPulses = PULSE_GENERATOR_DEFAULT_BURST,
+        .frequencyHz = PULSE_GENERATOR_DEFAULT_FREQUENCY,
+        .parameter = 0,
+    };
+    pulseGeneratorAddSegment(&testPulseGenerator, &segment);
+}
+
+/* Clear the profile (only while the generator is idle) */
+esp_err_t pulseGeneratorClearProfile(pulse_generator_t* pGenerator)
+{
+    if (pGenerator->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    pGenerator->profile.numSegments = 0;
+    return ESP_OK;
+}
+
+/* Append a segment to the profile (only while the generator is idle) */
+esp_err_t pulseGeneratorAddSegment(pulse_generator_t* pGenerator, const pulse_segment_t* pSegment)
+{
+    if (pGenerator->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (pSegment->type >= PULSE_SEGMENT_TYPE_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (pSegment->type != PULSE_SEGMENT_REVERSAL
+        && (pSegment->frequencyHz < PULSE_GENERATOR_MIN_FREQUENCY || pSegment->frequencyHz > PULSE_GENERATOR_MAX_FREQUENCY)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (pGenerator->profile.numSegments >= PULSE_GENERATOR_MAX_SEGMENTS) {
+        return ESP_ERR_NO_MEM;
+    }
+    pGenerator->profile.segments[pGenerator->profile.numSegments++] = *pSegment;
+    return ESP_OK;
+}
+
+/* Set the profile limits (only while the generator is idle) */
+esp_err_t pulseGeneratorConfigure(pulse_generator_t* pGenerator,
+                                uint32_t maxFrequencyHz,
+                                uint32_t jitterPercent,
+                                uint32_t repeatCount)
+{
+    if (pGenerator->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (maxFrequencyHz < PULSE_GENERATOR_MIN_FREQUENCY || maxFrequencyHz > PULSE_GENERATOR_MAX_FREQUENCY
+        || jitterPercent > 50) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pGenerator->profile.maxFrequencyHz = maxFrequencyHz;
+    pGenerator->profile.jitterPercent = jitterPercent;
+    pGenerator->profile.repeatCount = repeatCount;
+    return ESP_OK;
+}
+
+/* Start playing back the profile */
+esp_err_t pulseGeneratorStart(pulse_generator_t* pGenerator)
+{
+    if (pGenerator->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* an endless profile without pulses would never block */
+    bool hasPulses = false;
+    for (uint32_t i = 0; i < pGenerator->profile.numSegments; i++) {
+        if (pGenerator->profile.segments[i].type != PULSE_SEGMENT_REVERSAL
+            && pGenerator->profile.segments[i].numPulses > 0) {
+            hasPulses = true;
+        }
+    }
+    if (!hasPulses) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(pGenerator->done, 0);
+    pGenerator->pulsesSent = 0;
+    pGenerator->stopRequested = false;
+    pGenerator->running = true;
+    xTaskNotifyGive(pGenerator->task);
+    return ESP_OK;
+}
+
+/* Stop the playback at the next chunk boundary */
+void pulseGeneratorStop(pulse_generator_t* pGenerator)
+{
+    pGenerator->stopRequested = true;
+}
+
+/* Wait until the playback is finished (returns false on timeout) */
+bool pulseGeneratorWaitDone(pulse_generator_t* pGenerator, TickType_t ticksToWait)
+{
+    if (!pGenerator->running) {
+        return true;
+    }
+    return (xSemaphoreTake(pGenerator->done, ticksToWait) == pdTRUE);
+}
+
+/* Set the direction output (only while the generator is idle) */
+esp_err_t pulseGeneratorSetDirection(pulse_generator_t* pGenerator, int level)
+{
+    if (pGenerator->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (pGenerator->directionIo >= 0) {
+        pGenerator->directionLevel = (level != 0);
+        gpio_set_level(pGenerator->directionIo, pGenerator->directionLevel);
+    }
+    return ESP_OK;
+}
\ No newline at end of file
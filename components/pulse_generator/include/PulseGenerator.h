@@ -0,0 +1,136 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	PulseGenerator.h
+
+  Abstract:
+
+	The header file of the RMT based motion profile pulse generator
+*/
+
+#ifndef PULSE_GENERATOR_H
+#define PULSE_GENERATOR_H
+
+#include "Config.h"
+#include "driver/rmt_tx.h"
+#include "driver/gpio.h"
+#include "freertos/semphr.h"
+
+
+// Output GPIOs of the internal test pulse generator (short GPIO2 and GPIO0 for loopback tests)
+#define PULSE_GENERATOR_OUTPUT_IO			2
+#define PULSE_GENERATOR_DIRECTION_IO		21
+
+// RMT timing parameters
+#define PULSE_GENERATOR_RESOLUTION_HZ		10000000	// 10 MHz, 0.1 us per tick
+#define PULSE_GENERATOR_PULSE_WIDTH_TICKS	10			// 1 us high time (shortened to 50% duty above 500 KHz)
+#define PULSE_GENERATOR_MAX_SYMBOL_TICKS	32767		// 15-bit RMT duration field
+#define PULSE_GENERATOR_MIN_FREQUENCY		400			// Lowest pulse frequency (Hz) that fits in a single symbol
+#define PULSE_GENERATOR_MAX_FREQUENCY		2000000		// Highest pulse frequency (Hz), 5 ticks per period
+
+// Default profile: continuous 100 KHz pulses (the former LEDC test signal)
+#define PULSE_GENERATOR_DEFAULT_FREQUENCY	100000
+#define PULSE_GENERATOR_DEFAULT_BURST		1000
+
+// Symbols are produced on the fly into a ring of chunks, so profiles of any length can be played
+#define PULSE_GENERATOR_MAX_SEGMENTS		16
+#define PULSE_GENERATOR_CHUNK_SYMBOLS		64
+#define PULSE_GENERATOR_NUM_CHUNKS			4
+
+/* Motion profile segment types */
+typedef enum {
+	PULSE_SEGMENT_TRAPEZOID = 0,	// ramp up with constant acceleration, cruise, ramp down
+	PULSE_SEGMENT_BURST,			// pulses at a constant frequency followed by a gap
+	PULSE_SEGMENT_REVERSAL,			// toggle the direction output and dwell
+	PULSE_SEGMENT_TYPE_COUNT,
+} pulse_segment_type_t;
+
+/* A single motion profile segment */
+typedef struct {
+	pulse_segment_type_t type;
+	uint32_t numPulses;		// number of pulses (unused for reversal)
+	uint32_t frequencyHz;	// peak/cruise frequency, capped by the profile's maximum frequency
+	uint32_t parameter;		// trapezoid: acceleration (Hz/s), burst: gap (us), reversal: dwell (us)
+} pulse_segment_t;
+
+/* A motion profile */
+typedef struct {
+	pulse_segment_t segments[PULSE_GENERATOR_MAX_SEGMENTS];
+	uint32_t numSegments;
+	uint32_t maxFrequencyHz;	// upper bound applied to every segment
+	uint32_t jitterPercent;		// random period variation (+/- percent)
+	uint32_t repeatCount;		// number of profile repetitions (0: repeat until stopped)
+} pulse_profile_t;
+
+/* Pulse generator instance */
+typedef struct {
+	rmt_channel_handle_t channel;
+	rmt_encoder_handle_t encoder;
+	int directionIo;
+	int directionLevel;
+	pulse_profile_t profile;
+	TaskHandle_t task;
+	SemaphoreHandle_t freeChunks;
+	SemaphoreHandle_t done;
+	StaticTask_t taskBuffer;
+	StaticSemaphore_t freeChunksBuffer;
+	StaticSemaphore_t doneBuffer;
+	StackType_t taskStack[PULSE_GENERATOR_TASK_STACK_SIZE_BYTES];
+	volatile bool running;
+	volatile bool stopRequested;
+	uint32_t pulsesSent;
+	rmt_symbol_word_t chunks[PULSE_GENERATOR_NUM_CHUNKS][PULSE_GENERATOR_CHUNK_SYMBOLS];
+	uint32_t chunkIndex;
+	uint32_t chunkFill;
+} pulse_generator_t;
+
+/* The internal test pulse generator (GPIO2) */
+extern pulse_generator_t testPulseGenerator;
+
+/*
+	Create a pulse generator instance on the given output and direction GPIOs
+	The output stays low until a profile is started
+*/
+void pulseGeneratorCreate(pulse_generator_t* pGenerator, int outputIo, int directionIo, const char* taskName);
+
+/* Initialize the internal test pulse generator with the default profile */
+void pulseGeneratorInitialize(void);
+
+/* Clear the profile (only while the generator is idle) */
+esp_err_t pulseGeneratorClearProfile(pulse_generator_t* pGenerator);
+
+/* Append a segment to the profile (only while the generator is idle) */
+esp_err_t pulseGeneratorAddSegment(pulse_generator_t* pGenerator, const pulse_segment_t* pSegment);
+
+/* Set the profile limits (only while the generator is idle) */
+esp_err_t pulseGeneratorConfigure(pulse_generator_t* pGenerator,
+								uint32_t maxFrequencyHz,
+								uint32_t jitterPercent,
+								uint32_t repeatCount);
+
+/* Set the direction output (only while the generator is idle) */
+esp_err_t pulseGeneratorSetDirection(pulse_generator_t* pGenerator, int level);
+
+/* Start playing back the profile */
+esp_err_t pulseGeneratorStart(pulse_generator_t* pGenerator);
+
+/* Stop the playback at the next chunk boundary */
+void pulseGeneratorStop(pulse_generator_t* pGenerator);
+
+/* Wait until the playback is finished (returns false on timeout) */
+bool pulseGeneratorWaitDone(pulse_generator_t* pGenerator, TickType_t ticksToWait);
+
+#endif
\ No newline at end of file
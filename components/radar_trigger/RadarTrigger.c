@@ -22,11 +22,23 @@
 */
 
 #include <RadarTrigger.h>
+#include <TriggerLog.h>
+#include <PulseCounter.h>
+#include <Health.h>
+#include <TimeSync.h>
+#include <IndexCode.h>
+#include <FlashLog.h>
+#include <string.h>
+#include "hal/gpio_ll.h"
 
 
 /* A task handle for the radar trigger */
 TaskHandle_t xRadarTriggerTask;
 
+/* The task stack and control block */
+static StackType_t xRadarTriggerStack[RADAR_TRIGGER_TASK_STACK_SIZE_BYTES];
+static StaticTask_t xRadarTriggerTaskBuffer;
+
 /* Pulsewidth timer callback*/
 static void pulsewidth_timer_callback(void* arg);
 
@@ -36,24 +48,370 @@ static esp_timer_handle_t pulsewidth_timer;
 /* Pulse width in us (1 us by default) */
 uint64_t radarTriggerPulseWidth_us = 1;
 
-/* Number of Radar trigger */
-uint32_t numberOfTrigger = 0;
+/* Number of Radar trigger (counted by the PCNT interrupt and the task under the trigger lock) */
+volatile uint32_t numberOfTrigger = 0;
 
 /* Radar Trigger Variables */
 uint32_t desiredRadarTrigger = 0;
 
-/* A queue to handle pulse counter events */
-extern QueueHandle_t pcnt_evt_queue;
+/* Pulse position of the last trigger (kept by the PCNT interrupt, cleared by the task under the trigger lock) */
+static volatile int32_t triggerPosition = 0;
+static portMUX_TYPE triggerLock = portMUX_INITIALIZER_UNLOCKED;
+
+/* The window of positions that generate triggers (start == end: every position) */
+static volatile int32_t windowStart = 0;
+static volatile int32_t windowEnd = 0;
+static portMUX_TYPE windowLock = portMUX_INITIALIZER_UNLOCKED;
+
+/* The 2D trigger grid (numX == 0: off), guarded by the window lock */
+static radar_trigger_grid_t triggerGrid;
+
+/* A task notified on every pulse counter trigger */
+static TaskHandle_t radarTriggerObserver = NULL;
+
+/* Capture time of the last radar trigger edge */
+extern uint32_t edgeCaptureGetTriggerTicks(void);
+
+/* Watch point to trigger latency statistics */
+static radar_trigger_stats_t radarTriggerStats;
+
+/* Burst timer, the pulses after the first one of a burst are generated in its alarm interrupt */
+static gptimer_handle_t burst_timer;
+
+/* Burst configuration and state */
+static uint32_t burstPulses = 1;
+static uint32_t burstInterval_us = 0;
+static volatile uint32_t burstRemaining = 0;
+static volatile uint32_t burstIndex = 0;
+static volatile bool burstLevel = false;
+static portMUX_TYPE burstLock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Send an event to the host PC */
+extern int transportSendEvent(const char* data, uint32_t length);
 
 /* A queue to handle Uart radar trigger events */
 extern QueueHandle_t uart_evt_queue;
 
-/* PCNT threshold value */
-extern int pcntThreshold;
+/* The storage of the Uart command queue */
+static StaticQueue_t uart_evt_queue_buffer;
+static uint8_t uart_evt_queue_storage[UART_EVT_QUEUE_LENGTH * sizeof(uart_evt_t)];
+
+/* Multi-pass measurement (radar trigger task only): the passes of the sequence (0: off),
+ * the current pass (running once the first boundary is seen) and the offset added per pass
+ */
+static uint32_t numPasses = 0;
+static uint32_t currentPass = 0;
+static bool passRunning = false;
+static int32_t passOffset = 0;
+static uint32_t passFirstIndex = 0;
+static int64_t passStart_us = 0;
+
+/* Add a trigger to the trigger log */
+static void logTrigger(uint32_t index, int32_t position, uint32_t edgeTicks, int32_t positionY)
+{
+    int64_t time_us = esp_timer_get_time();
+    trigger_record_t record = {
+        .index = index,
+        .position = position,
+        .time_us = time_us,
+        .edgeTicks = edgeTicks,
+        .triggerTicks = edgeCaptureGetTriggerTicks(),
+        .syncTime_us = timeSyncGetTime(time_us),
+        .positionY = positionY,
+    };
+    triggerLogAppend(&record);
+    flashLogAppend(&record);
+}
+
+/* Burst timer alarm callback
+ * raise the next pulse at its interval, lower it one pulse width later
+ */
+static bool IRAM_ATTR burst_timer_on_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx)
+{
+    gptimer_alarm_config_t alarm_config = { 0 };
+
+    healthCountIsr(HEALTH_ISR_BURST_TIMER);
+    portENTER_CRITICAL_ISR(&burstLock);
+    if (burstRemaining == 0) {
+        /* cut short by the next trigger */
+        portEXIT_CRITICAL_ISR(&burstLock);
+        return false;
+    }
+
+    if (!burstLevel) {
+        gpio_ll_set_level(&GPIO, RADAR_TRIGGER_OUTPUT_IO, 1);
+        burstLevel = true;
+        #ifdef CONFIGURABLE_RADAR_PULSE_WIDTH
+            alarm_config.alarm_count = edata->alarm_value + radarTriggerPulseWidth_us;
+        #else
+            alarm_config.alarm_count = edata->alarm_value + 1;
+        #endif
+    }
+    else {
+        gpio_ll_set_level(&GPIO, RADAR_TRIGGER_OUTPUT_IO, 0);
+        burstLevel = false;
+        burstRemaining--;
+        burstIndex++;
+        alarm_config.alarm_count = (uint64_t)burstIndex * burstInterval_us;
+    }
+
+    if (burstRemaining == 0) {
+        gptimer_stop(timer);
+    }
+    else {
+        gptimer_set_alarm_action(timer, &alarm_config);
+    }
+    portEXIT_CRITICAL_ISR(&burstLock);
+    return false;
+}
+
+/* Cut a running burst short, returns the number of pulses that are not sent (PCNT interrupt) */
+static uint32_t IRAM_ATTR stopBurst(void)
+{
+    portENTER_CRITICAL_ISR(&burstLock);
+    uint32_t unsent = burstRemaining;
+    if (unsent != 0) {
+        gptimer_stop(burst_timer);
+        gpio_ll_set_level(&GPIO, RADAR_TRIGGER_OUTPUT_IO, 0);
+        burstRemaining = 0;
+        burstLevel = false;
+    }
+    portEXIT_CRITICAL_ISR(&burstLock);
+    return unsent;
+}
+
+/* Start the rest of the burst, the first pulse is already out (PCNT interrupt) */
+static void IRAM_ATTR startBurst(void)
+{
+    portENTER_CRITICAL_ISR(&burstLock);
+    if (burstPulses > 1) {
+        gptimer_alarm_config_t alarm_config = {
+            .alarm_count = burstInterval_us,
+        };
+        burstIndex = 1;
+        burstLevel = false;
+        burstRemaining = burstPulses - 1;
+        gptimer_set_raw_count(burst_timer, 0);
+        gptimer_set_alarm_action(burst_timer, &alarm_config);
+        gptimer_start(burst_timer);
+    }
+    portEXIT_CRITICAL_ISR(&burstLock);
+}
+
+/* Check whether a position is on a grid point: on a column and within the tolerance of a row */
+static bool IRAM_ATTR isOnGrid(const radar_trigger_grid_t* pGrid, int32_t positionX, int32_t positionY)
+{
+    int64_t dx = (int64_t)positionX - pGrid->originX;
+    if (dx < 0 || (dx % pGrid->pitchX) != 0 || dx / pGrid->pitchX >= pGrid->numX) {
+        return false;
+    }
+
+    /* the nearest row */
+    int64_t dy = (int64_t)positionY - pGrid->originY + pGrid->pitchY / 2;
+    if (dy < 0) {
+        return false;
+    }
+    int64_t row = dy / pGrid->pitchY;
+    int64_t rowError = dy - row * pGrid->pitchY - pGrid->pitchY / 2;
+    return (row < pGrid->numY) && (rowError <= pGrid->toleranceY) && (rowError >= -pGrid->toleranceY);
+}
+
+/* Check whether a position is inside the trigger window and on the trigger grid (PCNT interrupt) */
+static bool IRAM_ATTR isInWindow(int32_t positionX, int32_t positionY)
+{
+    portENTER_CRITICAL_ISR(&windowLock);
+    bool inWindow = (windowStart == windowEnd) || (positionX >= windowStart && positionX <= windowEnd);
+    if (inWindow && triggerGrid.numX != 0) {
+        inWindow = isOnGrid(&triggerGrid, positionX, positionY);
+    }
+    portEXIT_CRITICAL_ISR(&windowLock);
+    return inWindow;
+}
+
+/* Raise the trigger pulse and count it (task or PCNT interrupt), returns the index of the trigger */
+static uint32_t IRAM_ATTR raiseTrigger(void)
+{
+    portENTER_CRITICAL_SAFE(&triggerLock);
+    gpio_ll_set_level(&GPIO, RADAR_TRIGGER_OUTPUT_IO, 1);
+    uint32_t index = numberOfTrigger + 1;
+    numberOfTrigger = index;
+
+    /* Set the signal level to low */
+    #ifdef CONFIGURABLE_RADAR_PULSE_WIDTH
+        /* Start the timer (the falling edge comes from the esp_timer task) */
+        esp_timer_start_once(pulsewidth_timer, radarTriggerPulseWidth_us);
+    #else
+        gpio_ll_set_level(&GPIO, RADAR_TRIGGER_OUTPUT_IO, 0);
+    #endif
+    portEXIT_CRITICAL_SAFE(&triggerLock);
+    return index;
+}
+
+/* The trigger handler of the watch points, called from the PCNT interrupt
+ * the pulse and the burst go out right at the watch point, even while a flash write stops the caches,
+ * the task only codes the index and logs the trigger
+ */
+static void IRAM_ATTR triggerOnWatchPoint(pcnt_evt_t* pEvt)
+{
+    /* the spacing of this very watch point, a spacing change may already be in effect */
+    portENTER_CRITICAL_ISR(&triggerLock);
+    int32_t position = triggerPosition + pEvt->spacing;
+    triggerPosition = position;
+    portEXIT_CRITICAL_ISR(&triggerLock);
+    pEvt->position = position;
+
+    /* an acceleration zone (gate input inactive) or a position outside the window or the grid keeps its position only */
+    pEvt->fired = !pEvt->gateClosed && isInWindow(position, pEvt->positionY);
+    if (!pEvt->fired) {
+        return;
+    }
+
+    /* the previous position is still bursting, the new position has priority */
+    pEvt->unsent = stopBurst();
+    pEvt->index = raiseTrigger();
+    startBurst();
+    pEvt->latency_us = (int32_t)(esp_timer_get_time() - pEvt->time_us);
+}
+
+/* Log the trigger of a watch point event, its pulse is already out */
+static void handleWatchPoint(const pcnt_evt_t* pEvt)
+{
+    if (!pEvt->fired) {
+        radarTriggerStats.numGated++;
+        return;
+    }
+
+    /* Code the index of the trigger record on the second output */
+    indexCodeSend(pEvt->index);
+
+    if (pEvt->unsent != 0) {
+        char reply[32];
+        radarTriggerStats.numBurstOverlap++;
+        int length = snprintf(reply, sizeof(reply), "$BOV%lu,%lu#\r\n", pEvt->index - 1, pEvt->unsent);
+        transportSendEvent(reply, length);
+    }
+
+    /* Update the latency from the watch point interrupt to the trigger */
+    radarTriggerStats.numTrigger++;
+    radarTriggerStats.latencySum_us += pEvt->latency_us;
+    if (pEvt->latency_us > radarTriggerStats.latencyMax_us) {
+        radarTriggerStats.latencyMax_us = pEvt->latency_us;
+    }
+
+    logTrigger(pEvt->index, pEvt->position, pEvt->edgeTicks, pEvt->positionY);
+    if (radarTriggerObserver != NULL) {
+        xTaskNotifyGive(radarTriggerObserver);
+    }
+}
+
+/* Report the end of the current pass */
+static void endPass(void)
+{
+    char reply[64];
+    int length = snprintf(reply, sizeof(reply), "$PSE%lu,%lu,%lu,%ld,%lld#\r\n",
+                        currentPass,
+                        passFirstIndex,
+                        numberOfTrigger - passFirstIndex,
+                        triggerPosition,
+                        (esp_timer_get_time() - passStart_us) / 1000);
+    transportSendEvent(reply, length);
+    passRunning = false;
+    currentPass++;
+}
+
+/* End the pass sequence and go back to free counting */
+static void endPassSequence(bool aborted)
+{
+    char reply[32];
+    int length = snprintf(reply, sizeof(reply), "$MPE%lu,%d#\r\n", currentPass, aborted);
+    transportSendEvent(reply, length);
+
+    numPasses = 0;
+    pcntStop();
+    pcntClearCount();
+    pcntStart();
+}
+
+/* A pass boundary: end the current pass and start the next one from position zero */
+static void handlePassBoundary(void)
+{
+    if (numPasses == 0) {
+        return;
+    }
+    if (passRunning) {
+        endPass();
+    }
+    if (currentPass >= numPasses) {
+        endPassSequence(false);
+        return;
+    }
+
+    /* the pulses of the turnaround are forgotten, pass k is shifted by k offsets */
+    pcntStop();
+    if (pcntClearCountWithOffset(currentPass * passOffset) != ESP_OK) {
+        /* the spacing or the mode has changed since the sequence was armed */
+        char reply[16];
+        int length = snprintf(reply, sizeof(reply), "$MPX%d#\r\n", RADAR_TRIGGER_PASS_ERROR_OFFSET);
+        transportSendEvent(reply, length);
+        endPassSequence(true);
+        return;
+    }
+    portENTER_CRITICAL(&triggerLock);
+    triggerPosition = 0;
+    passFirstIndex = numberOfTrigger;
+    portEXIT_CRITICAL(&triggerLock);
+    passStart_us = esp_timer_get_time();
+    passRunning = true;
+    pcntStart();
+}
+
+/* Handle a command of the Uart task */
+static void handleUartEvent(const uart_evt_t* pEvt)
+{
+    if (pEvt->command == UART_RADAR_TRIGGER_COMMAND) {
+        uint32_t index = triggerRadar();
+        logTrigger(index, triggerPosition, 0, pcntYGetPosition());
+    }
+    if (pEvt->command == UART_DESIRED_NUM_TRIGGER_COMMAND) {
+        desiredRadarTrigger = pEvt->data;
+    }
+    if (pEvt->command == UART_CLEAR_NUM_TRIGGER_COMMAND) {
+        portENTER_CRITICAL(&triggerLock);
+        numberOfTrigger = 0;
+        triggerPosition = 0;
+        passFirstIndex = 0;
+        portEXIT_CRITICAL(&triggerLock);
+        triggerLogClear();
+    }
+    if (pEvt->command == UART_NUM_MEASUREMENT_COMMAND) {
+        /* a new sequence replaces a running one */
+        if (numPasses != 0) {
+            if (passRunning) {
+                endPass();
+            }
+            endPassSequence(true);
+        }
 
-/* A queue set to handle radar trigger events */
-QueueSetHandle_t radar_trigger_queue_set;
-QueueSetMemberHandle_t radar_trigger_queue_activated;
+        /* the counter holds until the first boundary starts pass 0 */
+        if (pEvt->data != 0) {
+            numPasses = pEvt->data;
+            currentPass = 0;
+            passRunning = false;
+            pcntStop();
+        }
+    }
+    if (pEvt->command == UART_PASS_OFFSET_COMMAND) {
+        passOffset = (int32_t)pEvt->data;
+
+        /* without a boundary an armed sequence would hold the counter forever */
+        if (numPasses != 0 && pcntGetPassBoundary() == PCNT_PASS_BOUNDARY_OFF) {
+            if (passRunning) {
+                endPass();
+            }
+            endPassSequence(true);
+        }
+    }
+}
 
 /* The Radar Trigger Task */
 void radarTriggerTask(void* params)
@@ -65,71 +423,38 @@ void radarTriggerTask(void* params)
     /* The parameter value is expected to be NULL. */
     configASSERT(params == NULL);
 
-    int pcnt_evt;
+    pcnt_evt_t pcnt_evt;
     uart_evt_t uart_evt;
-    portBASE_TYPE res;
-    
-    /* Create the radar trigger queue set */
-    radar_trigger_queue_set = xQueueCreateSet(RADAR_TRIGGER_QUEUE_SET_LENGTH);
-
-    /* Initialize PCNT and UART event queues */
-    pcnt_evt_queue = xQueueCreate(PCNT_EVT_QUEUE_LENGTH, sizeof(int));
-    uart_evt_queue = xQueueCreate(UART_EVT_QUEUE_LENGTH, sizeof(uart_evt_t));
-
-    /* Check everything was created. */
-    configASSERT(radar_trigger_queue_set);
-    configASSERT(pcnt_evt_queue);
-    configASSERT(uart_evt_queue);
-
-    /* Add the queues to the set */
-    xQueueAddToSet(pcnt_evt_queue, radar_trigger_queue_set);
-    xQueueAddToSet(uart_evt_queue, radar_trigger_queue_set);
+    uint32_t notification;
 
     /* Start Task Loop */
     while (1) {
-        /* 
-            Block to wait for something to be available from the queues
-            Don't block longer than 1000 ms
-        */
-        radar_trigger_queue_activated = xQueueSelectFromSet(radar_trigger_queue_set,
-                                                            1000 / portTICK_PERIOD_MS );
-
-        /* Which set member was selected?  Receives/takes can use a block time
-        of zero as they are guaranteed to pass because xQueueSelectFromSet()
-        would not have returned the handle unless something was available. */
-        if(radar_trigger_queue_activated == pcnt_evt_queue)
-        {
-            /* 
-                Wait for the event information passed from PCNT's interrupt handler.
-                Once received, decode the event type.
-            */
-            res = xQueueReceive(pcnt_evt_queue, &pcnt_evt, 0 / portTICK_PERIOD_MS);
-            if (res == pdTRUE) {
-                if (pcnt_evt == pcntThreshold) {
-                    triggerRadar();
-                }
-            }
+        /* Block until the PCNT interrupt or the Uart task notifies, and take every pending event */
+        if (xTaskNotifyWait(0, UINT32_MAX, &notification, portMAX_DELAY) != pdTRUE) {
+            continue;
         }
-        else if (radar_trigger_queue_activated == uart_evt_queue)
-        {
-            /* 
-                Wait for the event information passed from UART task.
-                Once received, decode the event status.
-            */
-            res = xQueueReceive(uart_evt_queue, &uart_evt, 0 / portTICK_PERIOD_MS);
-            if (res == pdTRUE) {
-                if (uart_evt.command == UART_RADAR_TRIGGER_COMMAND) {
-                    triggerRadar();
-                }
-                if (uart_evt.command == UART_DESIRED_NUM_TRIGGER_COMMAND) {
-                    desiredRadarTrigger = uart_evt.data;
-                }
-                if (uart_evt.command == UART_CLEAR_NUM_TRIGGER_COMMAND) {
-                    numberOfTrigger = 0;
-                }
+
+        /* The pulses are out already, log the pending watch points (a lost event is counted as a drop) */
+        uint32_t numPending = notification & RADAR_TRIGGER_NOTIFY_COUNT_MASK;
+        healthRecordLevel(HEALTH_QUEUE_PENDING_TRIGGERS, numPending);
+        for (uint32_t i = 0; i < numPending; i++) {
+            if (pcntReadEvent(&pcnt_evt)) {
+                handleWatchPoint(&pcnt_evt);
             }
         }
+        pcntRearmWatchPoints();
 
+        /* A pass boundary, after the watch points reached before it */
+        if (notification & RADAR_TRIGGER_NOTIFY_PASS_BIT) {
+            handlePassBoundary();
+        }
+
+        /* The rarer Uart commands still come through a queue */
+        if (notification & RADAR_TRIGGER_NOTIFY_UART_BIT) {
+            while (xQueueReceive(uart_evt_queue, &uart_evt, 0) == pdTRUE) {
+                handleUartEvent(&uart_evt);
+            }
+        }
     }
 
     /* The task is created. */
@@ -166,6 +491,25 @@ void radarTriggerInitialize(void)
         gpio_set_level(RADAR_TRIGGER_OUTPUT_IO, 0);
     }
 
+    /* Create the burst timer, it runs only during a burst */
+    gptimer_config_t burst_timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = RADAR_TRIGGER_BURST_RESOLUTION_HZ,
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&burst_timer_config, &burst_timer));
+    gptimer_event_callbacks_t burst_cbs = {
+        .on_alarm = burst_timer_on_alarm,
+    };
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(burst_timer, &burst_cbs, NULL));
+    ESP_ERROR_CHECK(gptimer_enable(burst_timer));
+
+    /* Create the Uart command queue before the task can be notified */
+    uart_evt_queue = xQueueCreateStatic(UART_EVT_QUEUE_LENGTH, sizeof(uart_evt_t), uart_evt_queue_storage, &uart_evt_queue_buffer);
+    configASSERT(uart_evt_queue);
+    healthSetQueueCapacity(HEALTH_QUEUE_UART_EVENTS, UART_EVT_QUEUE_LENGTH);
+    healthSetQueueCapacity(HEALTH_QUEUE_TRIGGER_LOG, TRIGGER_LOG_LENGTH);
+
     /* Create pulse width timer */
     const esp_timer_create_args_t pulsewidth_timer_args = {
             .callback = &pulsewidth_timer_callback,
@@ -173,17 +517,20 @@ void radarTriggerInitialize(void)
     };
     ESP_ERROR_CHECK(esp_timer_create(&pulsewidth_timer_args, &pulsewidth_timer));
 
+    /* The PCNT interrupt sends the pulse of every watch point from now on */
+    pcntSetTriggerHandler(triggerOnWatchPoint);
+
     /* Create the task, store the handle. */
-    BaseType_t xReturned;
-    xReturned = xTaskCreatePinnedToCore(
-                        radarTriggerTask,      			/* Function that implements the task. */
-                    	"RadarTriggerTask",     		/* Text name for the task. */
-                    	DEFAULT_TASK_STACK_SIZE_BYTES,  /* Stack size in bytes. */
-                    	NULL,               			/* Parameter passed into the task. */
-                    	5,                      		/* Priority at which the task is created. */
-                    	&xRadarTriggerTask,     		/* Used to pass out the created task's handle. */
-                        0);	                    		/* Core number. */
-    if( xReturned != pdPASS )
+    xRadarTriggerTask = xTaskCreateStaticPinnedToCore(
+                        radarTriggerTask,                    /* Function that implements the task. */
+                        "RadarTriggerTask",                  /* Text name for the task. */
+                        RADAR_TRIGGER_TASK_STACK_SIZE_BYTES, /* Stack size in bytes. */
+                        NULL,                                /* Parameter passed into the task. */
+                        5,                                   /* Priority at which the task is created. */
+                        xRadarTriggerStack,                  /* The task stack. */
+                        &xRadarTriggerTaskBuffer,            /* The task control block. */
+                        0);                                  /* Core number. */
+    if( xRadarTriggerTask == NULL )
     {
         /* The task is not created. */
         ESP_LOGI(TAG, "The Radar Trigger Task could not created.");
@@ -191,21 +538,13 @@ void radarTriggerInitialize(void)
 }
 
 /* Radar Trigger Command */
-void triggerRadar(void)
+uint32_t triggerRadar(void)
 {
-    /* Set the signal level to high */
-    gpio_set_level(RADAR_TRIGGER_OUTPUT_IO, 1);
-
-    /* Update the number of Radar trigger */
-    numberOfTrigger++;
+    uint32_t index = raiseTrigger();
 
-    /* Set the signal level to low */
-    #ifdef CONFIGURABLE_RADAR_PULSE_WIDTH
-        /* Start the timer */
-        ESP_ERROR_CHECK(esp_timer_start_once(pulsewidth_timer, radarTriggerPulseWidth_us));
-    #else
-        gpio_set_level(RADAR_TRIGGER_OUTPUT_IO, 0);
-    #endif
+    /* Code the index of the trigger record on the second output */
+    indexCodeSend(index);
+    return index;
 }
 
 /* Pulsewidth timer callback*/
@@ -213,4 +552,76 @@ static void pulsewidth_timer_callback(void* arg)
 {
     /* Stop the timer */
     gpio_set_level(RADAR_TRIGGER_OUTPUT_IO, 0);
+}
+
+/* Limit the pulse counter triggers to a window of positions (start == end: no window)
+ * the window is inclusive and applies from the next watch point on
+ */
+esp_err_t radarTriggerSetWindow(int32_t startPosition, int32_t endPosition)
+{
+    if (startPosition > endPosition) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&windowLock);
+    windowStart = startPosition;
+    windowEnd = endPosition;
+    portEXIT_CRITICAL(&windowLock);
+    return ESP_OK;
+}
+
+/* Limit the pulse counter triggers to the points of a 2D grid (NULL or numX == 0: no grid)
+ * the grid applies from the next watch point on
+ */
+esp_err_t radarTriggerSetGrid(const radar_trigger_grid_t* pGrid)
+{
+    radar_trigger_grid_t grid = { 0 };
+    if (pGrid != NULL && pGrid->numX != 0) {
+        if (pGrid->pitchX <= 0 || pGrid->pitchY <= 0 || pGrid->numY == 0 ||
+            pGrid->toleranceY < 0 || pGrid->toleranceY > pGrid->pitchY / 2) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        grid = *pGrid;
+    }
+
+    portENTER_CRITICAL(&windowLock);
+    triggerGrid = grid;
+    portEXIT_CRITICAL(&windowLock);
+    return ESP_OK;
+}
+
+/* Reset the trigger latency statistics */
+void radarTriggerResetStatistics(void)
+{
+    memset(&radarTriggerStats, 0, sizeof(radarTriggerStats));
+}
+
+/* Get the trigger latency statistics */
+void radarTriggerGetStatistics(radar_trigger_stats_t* pStats)
+{
+    *pStats = radarTriggerStats;
+}
+
+/* Notify a task on every pulse counter trigger (NULL to remove) */
+void radarTriggerSetObserver(TaskHandle_t task)
+{
+    radarTriggerObserver = task;
+}
+
+/* Set the number of pulses per pulse counter trigger and their interval (1: no burst) */
+esp_err_t radarTriggerSetBurst(uint32_t numPulses, uint32_t interval_us)
+{
+    if (numPulses == 0 || numPulses > RADAR_TRIGGER_MAX_BURST) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (numPulses > 1 && (interval_us < RADAR_TRIGGER_MIN_BURST_INTERVAL_US || interval_us <= radarTriggerPulseWidth_us)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* the next burst uses the new setting */
+    portENTER_CRITICAL(&burstLock);
+    burstPulses = numPulses;
+    burstInterval_us = interval_us;
+    portEXIT_CRITICAL(&burstLock);
+    return ESP_OK;
 }
\ No newline at end of file
@@ -26,6 +26,7 @@
 
 #include "Config.h"
 #include "driver/gpio.h"
+#include "driver/gptimer.h"
 #include "esp_timer.h"
 
 
@@ -35,26 +36,92 @@
 
 
 /* 
-	Radar Trigger task has two queues
-	The first one is from the Pulse Counter for automated trigger
-	The second one is for the manual trigers coming from the Uart interface
-	Define the lengths of the queues that will be added to the queue set.
+	Radar Trigger task is woken up by task notifications
+	The Pulse Counter interrupt increments the pending watch point count for automated triggers
+	The manual triggers and the settings coming from the Uart interface are queued
+	Define the length of the Uart queue.
 */
-#define PCNT_EVT_QUEUE_LENGTH		10
 #define UART_EVT_QUEUE_LENGTH		10
 
-#define RADAR_TRIGGER_QUEUE_SET_LENGTH ( PCNT_EVT_QUEUE_LENGTH + UART_EVT_QUEUE_LENGTH)
-
 //-----------------------------------------------------------------------------
 // If the configurable pulse width is used, comment out this line
 //-----------------------------------------------------------------------------
 // #define CONFIGURABLE_RADAR_PULSE_WIDTH
 
+/*
+	Burst mode: every pulse counter trigger is followed by more pulses at a fixed interval.
+	The extra pulses are timed by a general purpose timer and generated in its alarm interrupt,
+	a trigger that arrives while a burst is still running cuts the burst short and is reported as
+	$BOV<triggerIndex>,<unsentPulses>#
+*/
+#define RADAR_TRIGGER_BURST_RESOLUTION_HZ	1000000		// 1 us per tick
+#define RADAR_TRIGGER_MAX_BURST				64			// pulses per position
+#define RADAR_TRIGGER_MIN_BURST_INTERVAL_US	20			// leaves room for the alarm interrupt latency
+
+
+/* Latency statistics of the triggers generated by the pulse counter */
+typedef struct {
+	uint32_t numTrigger;		// number of pulse counter triggers
+	int64_t latencySum_us;		// sum of the watch point to trigger latencies
+	int64_t latencyMax_us;		// maximum watch point to trigger latency
+	uint32_t numBurstOverlap;	// bursts cut short by the next trigger
+	uint32_t numGated;			// watch points outside the gate or the trigger window
+} radar_trigger_stats_t;
 
 /* Initialize Radar Trigger */
 void radarTriggerInitialize(void);
 
-/* Radar Trigger Command */
-void triggerRadar(void);
+/* Radar Trigger Command, returns the index of the trigger */
+uint32_t triggerRadar(void);
+
+/* Notify a task on every pulse counter trigger (NULL to remove) */
+void radarTriggerSetObserver(TaskHandle_t task);
+
+/* Set the number of pulses per pulse counter trigger and their interval (1: no burst) */
+esp_err_t radarTriggerSetBurst(uint32_t numPulses, uint32_t interval_us);
+
+/*
+	A 2D trigger grid: columns at originX + i * pitchX (i < numX) of the pulse counter position,
+	rows at originY + j * pitchY (j < numY) of the Y axis position.
+	A watch point triggers if it is on a column and the Y position is within toleranceY of a row.
+*/
+typedef struct {
+	int32_t originX;
+	int32_t originY;
+	int32_t pitchX;
+	int32_t pitchY;
+	uint32_t numX;			// 0: no grid
+	uint32_t numY;
+	int32_t toleranceY;		// at most pitchY / 2 (pitchY / 2: the nearest row)
+} radar_trigger_grid_t;
+
+/* Limit the pulse counter triggers to a window of positions (start == end: no window) */
+esp_err_t radarTriggerSetWindow(int32_t startPosition, int32_t endPosition);
+
+/* Limit the pulse counter triggers to the points of a 2D grid (NULL or numX == 0: no grid) */
+esp_err_t radarTriggerSetGrid(const radar_trigger_grid_t* pGrid);
+
+/*
+	Multi-pass measurement ($MSR<passes>#): the pulse counter holds until the first edge of the
+	pass boundary input (see pcntSetPassBoundary), every edge ends the current pass and starts the
+	next one with the counter and the trigger position cleared, and pass k arms its first trigger
+	k * <offset> pulses later (absolute mode). The trigger index keeps counting across the passes.
+	The edge after the last pass ends the sequence and the counter counts freely again.
+	$PSE<pass>,<firstIndex>,<triggers>,<lastPosition>,<duration_ms>#	pass end
+	$MPE<completedPasses>,<aborted>#									sequence end
+	$MPX<error>#														rejected command or aborted pass
+*/
+
+/* The errors of the multi-pass measurement */
+typedef enum {
+	RADAR_TRIGGER_PASS_ERROR_OFFSET = 1,		// the offset of the last pass leaves the first trigger out of the counter range
+	RADAR_TRIGGER_PASS_ERROR_NO_BOUNDARY,		// no pass boundary is selected, the counter would hold forever
+} radar_trigger_pass_error_t;
+
+/* Reset the trigger latency statistics */
+void radarTriggerResetStatistics(void);
+
+/* Get the trigger latency statistics */
+void radarTriggerGetStatistics(radar_trigger_stats_t* pStats);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,216 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	ScanPlan.c
+
+  Abstract:
+
+	The implementation file of the autonomous 2D raster scan sequencer
+*/
+
+#include <ScanPlan.h>
+#include <PulseCounter.h>
+#include <MotionControl.h>
+#include <RadarTrigger.h>
+
+
+/* A task handle for the scan sequencer */
+static TaskHandle_t xScanPlanTask;
+
+/* The task stack and control block */
+static StackType_t xScanPlanStack[SCAN_PLAN_TASK_STACK_SIZE_BYTES];
+static StaticTask_t xScanPlanTaskBuffer;
+
+/* The uploaded plan */
+static scan_plan_t scanPlan;
+
+/* Scan state */
+static volatile bool scanRunning = false;
+static volatile bool scanAbortRequested = false;
+
+/* Send an event to the host PC */
+extern int transportSendEvent(const char* data, uint32_t length);
+
+/* Scan a single row, returns the number of triggers */
+static uint32_t scanRow(uint32_t row, bool internalMotion)
+{
+    char reply[48];
+    int length;
+
+    /* arm the counter for the row, forget the triggers of the previous row */
+    pcntStop();
+    pcntClearCount();
+    ulTaskNotifyTake(pdTRUE, 0);
+    if (internalMotion) {
+        pulseGeneratorSetDirection(&motionPulseGenerator, scanPlan.direction[row]);
+    }
+    pcntStart();
+
+    length = snprintf(reply, sizeof(reply), "$ROS%lu,%u#\r\n", row, scanPlan.direction[row]);
+    transportSendEvent(reply, length);
+
+    int64_t rowStart_us = esp_timer_get_time();
+    if (internalMotion) {
+        motionControlStart();
+    }
+
+    /* every trigger of the radar trigger task is notified */
+    uint32_t numTrigger = 0;
+    while (numTrigger < scanPlan.numColumns && !scanAbortRequested) {
+        numTrigger += ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SCAN_PLAN_POLL_MS)) & SCAN_PLAN_NOTIFY_COUNT_MASK;
+    }
+
+    /* ignore the pulses until the next row is armed */
+    pcntStop();
+    if (internalMotion) {
+        if (scanAbortRequested) {
+            motionControlStop();
+        }
+        pulseGeneratorWaitDone(&motionPulseGenerator, portMAX_DELAY);
+    }
+
+    length = snprintf(reply, sizeof(reply), "$ROC%lu,%lu,%lld#\r\n",
+                    row, numTrigger, (esp_timer_get_time() - rowStart_us) / 1000);
+    transportSendEvent(reply, length);
+
+    return numTrigger;
+}
+
+/* The Scan Sequencer Task */
+static void scanPlanTask(void* params)
+{
+    /* The parameter value is expected to be NULL. */
+    configASSERT(params == NULL);
+
+    char reply[32];
+    uint32_t notification;
+
+    while (1) {
+        /* Block until a scan is started, a trigger the observer counted after the last scan is dropped */
+        do {
+            xTaskNotifyWait(0, UINT32_MAX, &notification, portMAX_DELAY);
+        } while ((notification & SCAN_PLAN_NOTIFY_START_BIT) == 0);
+
+        bool internalMotion = (motionControlGetTriggerSource() == PCNT_INPUT_STEP);
+        radarTriggerSetObserver(xScanPlanTask);
+        pcntSetThreshold(scanPlan.spacing);
+
+        uint32_t row;
+        for (row = 0; row < scanPlan.numRows && !scanAbortRequested; row++) {
+            scanRow(row, internalMotion);
+
+            /* the stage changes the row, it is the only dead time */
+            if (row + 1 < scanPlan.numRows && !scanAbortRequested) {
+                vTaskDelay(pdMS_TO_TICKS(scanPlan.settle_ms));
+            }
+        }
+
+        int length = snprintf(reply, sizeof(reply), "$SCE%lu,%d#\r\n", row, scanAbortRequested);
+        transportSendEvent(reply, length);
+
+        /* back to free counting */
+        radarTriggerSetObserver(NULL);
+        pcntClearCount();
+        pcntStart();
+        scanRunning = false;
+    }
+}
+
+/* Initialize the scan sequencer task */
+void scanPlanInitialize(void)
+{
+    /* Set the log level */
+    static const char *TAG = "SCAN_PLAN_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    /* Create the task, store the handle. */
+    xScanPlanTask = xTaskCreateStaticPinnedToCore(
+                        scanPlanTask,                    /* Function that implements the task. */
+                        "ScanPlanTask",                  /* Text name for the task. */
+                        SCAN_PLAN_TASK_STACK_SIZE_BYTES, /* Stack size in bytes. */
+                        NULL,                            /* Parameter passed into the task. */
+                        4,                               /* Priority at which the task is created. */
+                        xScanPlanStack,                  /* The task stack. */
+                        &xScanPlanTaskBuffer,            /* The task control block. */
+                        0);                              /* Core number. */
+    if( xScanPlanTask == NULL )
+    {
+        /* The task is not created. */
+        ESP_LOGI(TAG, "The Scan Plan Task could not created.");
+    }
+}
+
+/* Upload the plan, every row in the same direction or alternating (serpentine) */
+esp_err_t scanPlanConfigure(uint32_t numRows,
+                            uint32_t numColumns,
+                            uint32_t spacing,
+                            uint32_t settle_ms,
+                            bool serpentine)
+{
+    if (scanRunning) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (numRows == 0 || numRows > SCAN_PLAN_MAX_ROWS || numColumns == 0
+        || spacing == 0 || spacing > PCNT_H_LIM_VAL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    scanPlan.numRows = numRows;
+    scanPlan.numColumns = numColumns;
+    scanPlan.spacing = spacing;
+    scanPlan.settle_ms = settle_ms;
+    for (uint32_t row = 0; row < numRows; row++) {
+        scanPlan.direction[row] = (serpentine && (row % 2)) ? SCAN_DIRECTION_REVERSE : SCAN_DIRECTION_FORWARD;
+    }
+    return ESP_OK;
+}
+
+/* Override the direction of a single row */
+esp_err_t scanPlanSetRowDirection(uint32_t row, scan_direction_t direction)
+{
+    if (scanRunning) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (row >= scanPlan.numRows || (direction != SCAN_DIRECTION_FORWARD && direction != SCAN_DIRECTION_REVERSE)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    scanPlan.direction[row] = direction;
+    return ESP_OK;
+}
+
+/* Start executing the plan */
+esp_err_t scanPlanStart(void)
+{
+    if (scanRunning || motionPulseGenerator.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (scanPlan.numRows == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    scanAbortRequested = false;
+    scanRunning = true;
+    xTaskNotify(xScanPlanTask, SCAN_PLAN_NOTIFY_START_BIT, eSetBits);
+    return ESP_OK;
+}
+
+/* Abort the plan, the current row is ended immediately */
+void scanPlanAbort(void)
+{
+    if (scanRunning) {
+        scanAbortRequested = true;
+    }
+}
\ No newline at end of file
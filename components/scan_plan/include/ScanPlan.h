@@ -0,0 +1,86 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	ScanPlan.h
+
+  Abstract:
+
+	The header file of the autonomous 2D raster scan sequencer
+*/
+
+#ifndef SCAN_PLAN_H
+#define SCAN_PLAN_H
+
+#include "Config.h"
+
+
+#define SCAN_PLAN_MAX_ROWS			256
+#define SCAN_PLAN_POLL_MS			100		// abort polling period while waiting for triggers
+
+/*
+	Notification value of the scan plan task
+	The radar trigger task increments the trigger count in the lower bits while the task observes it,
+	a start sets the top bit, so a trigger counted after a scan does not start the next one
+*/
+#define SCAN_PLAN_NOTIFY_START_BIT		(1UL << 31)
+#define SCAN_PLAN_NOTIFY_COUNT_MASK		(SCAN_PLAN_NOTIFY_START_BIT - 1)
+
+/* Row scan directions */
+typedef enum {
+	SCAN_DIRECTION_FORWARD = 0,
+	SCAN_DIRECTION_REVERSE,
+} scan_direction_t;
+
+/* A raster scan plan */
+typedef struct {
+	uint32_t numRows;
+	uint32_t numColumns;		// triggers per row
+	uint32_t spacing;			// pulses between triggers
+	uint32_t settle_ms;			// settle time between rows
+	uint8_t direction[SCAN_PLAN_MAX_ROWS];
+} scan_plan_t;
+
+/*
+	The plan is executed row by row without host interaction:
+	each row clears the pulse counter, counts <numColumns> triggers and then stops
+	counting until the settle time is over, so the row change of the stage is ignored.
+	With the built-in step generator as trigger source, each row also plays the motion
+	profile in the row's direction. The progress is reported to the host as
+	$ROS<row>,<direction>#						row start
+	$ROC<row>,<triggers>,<duration_ms>#		row complete
+	$SCE<completedRows>,<aborted>#				scan end
+*/
+
+/* Initialize the scan sequencer task */
+void scanPlanInitialize(void);
+
+/* Upload the plan, every row in the same direction or alternating (serpentine) */
+esp_err_t scanPlanConfigure(uint32_t numRows,
+							uint32_t numColumns,
+							uint32_t spacing,
+							uint32_t settle_ms,
+							bool serpentine);
+
+/* Override the direction of a single row */
+esp_err_t scanPlanSetRowDirection(uint32_t row, scan_direction_t direction);
+
+/* Start executing the plan */
+esp_err_t scanPlanStart(void);
+
+/* Abort the plan, the current row is ended immediately */
+void scanPlanAbort(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,357 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SelfTest.c
+
+  Abstract:
+
+	The implementation file of the loopback self-test (short GPIO2 and GPIO0)
+*/
+
+#include <SelfTest.h>
+#include <PulseGenerator.h>
+#include <RadarTrigger.h>
+
+
+/* A task handle for the self-test */
+static TaskHandle_t xSelfTestTask;
+
+/* The task stack and control block */
+static StackType_t xSelfTestStack[SELF_TEST_TASK_STACK_SIZE_BYTES];
+static StaticTask_t xSelfTestTaskBuffer;
+
+/* PCNT unit counting the radar trigger output */
+static pcnt_unit_handle_t trigger_pcnt_unit;
+
+/* Trigger edges accumulated on each counter wrap */
+static volatile uint32_t triggerAccumulated = 0;
+
+/* The sweep or drift test in progress */
+static self_test_config_t selfTestConfig;
+static self_test_drift_config_t selfTestDriftConfig;
+static bool selfTestDrift = false;
+static volatile bool selfTestRunning = false;
+
+/* PCNT threshold value */
+extern int pcntThreshold;
+
+/* Send an event to the host PC */
+extern int transportSendEvent(const char* data, uint32_t length);
+
+/* Trigger counter callback
+ * the counter is cleared by the hardware at the limit, keep the lost part
+ */
+static bool IRAM_ATTR trigger_pcnt_on_reach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx)
+{
+    if (edata->watch_point_value == SELF_TEST_PCNT_H_LIM_VAL) {
+        triggerAccumulated += SELF_TEST_PCNT_H_LIM_VAL;
+    }
+    return false;
+}
+
+/* Clear the trigger counter */
+static void clearTriggerCount(void)
+{
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(trigger_pcnt_unit));
+    triggerAccumulated = 0;
+}
+
+/* Read the number of trigger edges since the last clear */
+static uint32_t readTriggerCount(void)
+{
+    int count;
+    ESP_ERROR_CHECK(pcnt_unit_get_count(trigger_pcnt_unit, &count));
+    return triggerAccumulated + count;
+}
+
+/* Play a single burst on the test pulse generator and let the trigger task drain */
+static void playBurst(uint32_t numPulses, uint32_t frequencyHz)
+{
+    pulse_generator_t* pGenerator = &testPulseGenerator;
+
+    TickType_t timeout = pdMS_TO_TICKS(1000 + (uint64_t)numPulses * 1000 / frequencyHz);
+    ESP_ERROR_CHECK(pulseGeneratorStart(pGenerator));
+    if (!pulseGeneratorWaitDone(pGenerator, timeout)) {
+        pulseGeneratorStop(pGenerator);
+        pulseGeneratorWaitDone(pGenerator, portMAX_DELAY);
+    }
+    vTaskDelay(pdMS_TO_TICKS(SELF_TEST_SETTLE_MS));
+}
+
+/* Load a single burst profile on the test pulse generator */
+static void loadBurst(uint32_t numPulses, uint32_t frequencyHz)
+{
+    pulse_generator_t* pGenerator = &testPulseGenerator;
+
+    pulseGeneratorClearProfile(pGenerator);
+    pulseGeneratorConfigure(pGenerator, frequencyHz, 0, 1);
+    pulse_segment_t segment = {
+        .type = PULSE_SEGMENT_BURST,
+        .numPulses = numPulses,
+        .frequencyHz = frequencyHz,
+        .parameter = 0,
+    };
+    pulseGeneratorAddSegment(pGenerator, &segment);
+}
+
+/* Run the loopback test at a single frequency */
+static void runStep(uint32_t frequencyHz, self_test_result_t* pResult)
+{
+    pulse_generator_t* pGenerator = &testPulseGenerator;
+
+    /* a single burst at the requested frequency */
+    loadBurst(selfTestConfig.numPulses, frequencyHz);
+
+    /* restart both counters from zero */
+    pcntStop();
+    pcntClearCount();
+    clearTriggerCount();
+    radarTriggerResetStatistics();
+    pcntStart();
+
+    /* play the burst and let the trigger task drain */
+    playBurst(selfTestConfig.numPulses, frequencyHz);
+
+    /* compare the expected and the actual triggers */
+    radar_trigger_stats_t stats;
+    radarTriggerGetStatistics(&stats);
+
+    pResult->frequencyHz = frequencyHz;
+    pResult->expectedTriggers = pGenerator->pulsesSent / pcntThreshold;
+    pResult->countedTriggers = readTriggerCount();
+    pResult->handledTriggers = stats.numTrigger;
+    pResult->latencyMean_us = (stats.numTrigger > 0) ? (stats.latencySum_us / stats.numTrigger) : 0;
+    pResult->latencyMax_us = stats.latencyMax_us;
+
+    /* a trigger is late if it is not out before the next one is due */
+    int64_t triggerPeriod_us = (int64_t)pcntThreshold * 1000000 / frequencyHz;
+    pResult->passed = (pResult->countedTriggers == pResult->expectedTriggers)
+                    && (pResult->handledTriggers == pResult->expectedTriggers)
+                    && (pResult->latencyMax_us < triggerPeriod_us);
+}
+
+/* Run the frequency sweep */
+static void runSweep(void)
+{
+    char reply[96];
+
+    uint32_t maxSustainableHz = 0;
+    bool ceilingFound = false;
+    for (uint32_t frequencyHz = selfTestConfig.startHz; frequencyHz <= selfTestConfig.stopHz; frequencyHz += selfTestConfig.stepHz) {
+        self_test_result_t result;
+        runStep(frequencyHz, &result);
+
+        int length = snprintf(reply, sizeof(reply), "$STR%lu,%lu,%lu,%lu,%lld,%lld,%d#\r\n",
+                            result.frequencyHz,
+                            result.expectedTriggers,
+                            result.countedTriggers,
+                            result.handledTriggers,
+                            result.latencyMean_us,
+                            result.latencyMax_us,
+                            result.passed);
+        transportSendEvent(reply, length);
+
+        /* the ceiling is the last frequency before the first failure */
+        if (!result.passed) {
+            ceilingFound = true;
+        }
+        if (!ceilingFound) {
+            maxSustainableHz = frequencyHz;
+        }
+    }
+
+    int length = snprintf(reply, sizeof(reply), "$STC%lu#\r\n", maxSustainableHz);
+    transportSendEvent(reply, length);
+}
+
+/* Run the drift test
+ * every pulse has to end up either in a trigger or in the final count
+ */
+static void runDrift(void)
+{
+    pulse_generator_t* pGenerator = &testPulseGenerator;
+    const self_test_drift_config_t* pConfig = &selfTestDriftConfig;
+    self_test_drift_result_t result;
+    char reply[96];
+
+    /* half a spacing more, so the last trigger is not on the last pulse */
+    uint32_t numPulses = pConfig->numTriggers * pConfig->spacing + pConfig->spacing / 2;
+    loadBurst(numPulses, pConfig->frequencyHz);
+
+    /* the counter under test, restarted from zero */
+    pcnt_mode_t savedMode = pcntGetMode();
+    int savedThreshold = pcntGetThreshold();
+    ESP_ERROR_CHECK(pcntSetMode(pConfig->mode));
+    clearTriggerCount();
+    radarTriggerResetStatistics();
+    pcntSetThreshold(pConfig->spacing);
+
+    playBurst(numPulses, pConfig->frequencyHz);
+
+    radar_trigger_stats_t stats;
+    radarTriggerGetStatistics(&stats);
+
+    result.pulsesSent = pGenerator->pulsesSent;
+    result.expectedTriggers = result.pulsesSent / pConfig->spacing;
+    result.countedTriggers = readTriggerCount();
+    result.handledTriggers = stats.numTrigger;
+
+    /* the relative counter restarts at every trigger, the absolute one holds all pulses */
+    int64_t countedPulses = pcntGetPosition();
+    if (pConfig->mode == PCNT_MODE_RELATIVE) {
+        countedPulses += (int64_t)result.countedTriggers * pConfig->spacing;
+    }
+    result.driftPulses = (int64_t)result.pulsesSent - countedPulses;
+    result.passed = (result.driftPulses == 0)
+                    && (result.countedTriggers == result.expectedTriggers)
+                    && (result.handledTriggers == result.expectedTriggers);
+
+    int length = snprintf(reply, sizeof(reply), "$SDR%d,%lu,%lu,%lu,%lu,%lld,%d#\r\n",
+                        pConfig->mode,
+                        result.expectedTriggers,
+                        result.countedTriggers,
+                        result.handledTriggers,
+                        result.pulsesSent,
+                        result.driftPulses,
+                        result.passed);
+    transportSendEvent(reply, length);
+
+    /* restore the user's counter settings */
+    ESP_ERROR_CHECK(pcntSetMode(savedMode));
+    pcntSetThreshold(savedThreshold);
+}
+
+/* The Self-Test Task */
+static void selfTestTask(void* params)
+{
+    /* The parameter value is expected to be NULL. */
+    configASSERT(params == NULL);
+
+    while (1) {
+        /* Block until a sweep or a drift test is started */
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        /* keep the user's profile */
+        pulse_profile_t savedProfile = testPulseGenerator.profile;
+
+        if (selfTestDrift) {
+            runDrift();
+        }
+        else {
+            runSweep();
+        }
+
+        /* restore the user's profile and counter */
+        testPulseGenerator.profile = savedProfile;
+        pcntStop();
+        pcntClearCount();
+        pcntStart();
+        selfTestRunning = false;
+    }
+}
+
+/* Initialize the self-test task and the trigger counter */
+void selfTestInitialize(void)
+{
+    /* Set the log level */
+    static const char *TAG = "SELF_TEST_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    /* install the trigger counter unit */
+    pcnt_unit_config_t unit_config = {
+        .high_limit = SELF_TEST_PCNT_H_LIM_VAL,
+        .low_limit = SELF_TEST_PCNT_L_LIM_VAL,
+    };
+    ESP_ERROR_CHECK(pcnt_new_unit(&unit_config, &trigger_pcnt_unit));
+
+    /* count the rising edges of the radar trigger output, which stays an output */
+    pcnt_chan_config_t chan_config = {
+        .edge_gpio_num = RADAR_TRIGGER_OUTPUT_IO,
+        .level_gpio_num = -1,
+        .flags.io_loop_back = true,
+    };
+    pcnt_channel_handle_t pcnt_chan = NULL;
+    ESP_ERROR_CHECK(pcnt_new_channel(trigger_pcnt_unit, &chan_config, &pcnt_chan));
+    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(pcnt_chan, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD));
+
+    /* accumulate on each wrap, a drift test counts more triggers than the limit */
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(trigger_pcnt_unit, SELF_TEST_PCNT_H_LIM_VAL));
+    pcnt_event_callbacks_t cbs = {
+        .on_reach = trigger_pcnt_on_reach,
+    };
+    ESP_ERROR_CHECK(pcnt_unit_register_event_callbacks(trigger_pcnt_unit, &cbs, NULL));
+
+    ESP_ERROR_CHECK(pcnt_unit_enable(trigger_pcnt_unit));
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(trigger_pcnt_unit));
+    ESP_ERROR_CHECK(pcnt_unit_start(trigger_pcnt_unit));
+
+    /* Create the task, store the handle. */
+    xSelfTestTask = xTaskCreateStaticPinnedToCore(
+                        selfTestTask,                    /* Function that implements the task. */
+                        "SelfTestTask",                  /* Text name for the task. */
+                        SELF_TEST_TASK_STACK_SIZE_BYTES, /* Stack size in bytes. */
+                        NULL,                            /* Parameter passed into the task. */
+                        2,                               /* Priority at which the task is created. */
+                        xSelfTestStack,                  /* The task stack. */
+                        &xSelfTestTaskBuffer,            /* The task control block. */
+                        1);                              /* Core number. */
+    if( xSelfTestTask == NULL )
+    {
+        /* The task is not created. */
+        ESP_LOGI(TAG, "The Self-Test Task could not created.");
+    }
+}
+
+/* Start a loopback frequency sweep */
+esp_err_t selfTestStart(const self_test_config_t* pConfig)
+{
+    if (selfTestRunning || testPulseGenerator.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (pConfig->startHz < PULSE_GENERATOR_MIN_FREQUENCY || pConfig->stopHz > PULSE_GENERATOR_MAX_FREQUENCY
+        || pConfig->startHz > pConfig->stopHz || pConfig->stepHz == 0 || pConfig->numPulses == 0
+        || (pConfig->stopHz - pConfig->startHz) / pConfig->stepHz >= SELF_TEST_MAX_STEPS
+        || pConfig->numPulses / pcntThreshold > SELF_TEST_MAX_TRIGGERS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    selfTestConfig = *pConfig;
+    selfTestDrift = false;
+    selfTestRunning = true;
+    xTaskNotifyGive(xSelfTestTask);
+    return ESP_OK;
+}
+
+/* Start a loopback drift test */
+esp_err_t selfTestStartDrift(const self_test_drift_config_t* pConfig)
+{
+    if (selfTestRunning || testPulseGenerator.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if ((pConfig->mode != PCNT_MODE_RELATIVE && pConfig->mode != PCNT_MODE_ABSOLUTE)
+        || pConfig->spacing == 0 || pConfig->spacing >= PCNT_H_LIM_VAL
+        || pConfig->numTriggers == 0 || pConfig->numTriggers > SELF_TEST_DRIFT_MAX_TRIGGERS
+        || (uint64_t)pConfig->numTriggers * pConfig->spacing > UINT32_MAX / 2
+        || pConfig->frequencyHz < PULSE_GENERATOR_MIN_FREQUENCY || pConfig->frequencyHz > PULSE_GENERATOR_MAX_FREQUENCY) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    selfTestDriftConfig = *pConfig;
+    selfTestDrift = true;
+    selfTestRunning = true;
+    xTaskNotifyGive(xSelfTestTask);
+    return ESP_OK;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SelfTest.h
+
+  Abstract:
+
+	The header file of the loopback self-test (short GPIO2 and GPIO0)
+*/
+
+#ifndef SELF_TEST_H
+#define SELF_TEST_H
+
+#include "Config.h"
+#include "driver/pulse_cnt.h"
+#include "PulseCounter.h"
+#include <limits.h>
+
+
+// A second PCNT unit counts the radar trigger output (GPIO4) in hardware
+#define SELF_TEST_PCNT_H_LIM_VAL		SHRT_MAX
+#define SELF_TEST_PCNT_L_LIM_VAL		SHRT_MIN
+#define SELF_TEST_MAX_TRIGGERS			30000	// triggers per sweep step
+#define SELF_TEST_DRIFT_MAX_TRIGGERS	1000000	// triggers of a drift test (the trigger counter wraps are accumulated)
+
+#define SELF_TEST_MAX_STEPS				64		// maximum number of frequencies in a sweep
+#define SELF_TEST_SETTLE_MS				20		// time for the trigger task to drain after a burst
+
+/* Frequency sweep configuration */
+typedef struct {
+	uint32_t startHz;		// first pulse frequency
+	uint32_t stopHz;		// last pulse frequency
+	uint32_t stepHz;		// frequency increment
+	uint32_t numPulses;		// number of pulses generated at each frequency
+} self_test_config_t;
+
+/* Result of a single frequency step */
+typedef struct {
+	uint32_t frequencyHz;
+	uint32_t expectedTriggers;	// pulses / pulse count threshold
+	uint32_t countedTriggers;	// trigger edges counted by the second PCNT unit
+	uint32_t handledTriggers;	// triggers handled by the radar trigger task
+	int64_t latencyMean_us;		// mean watch point to trigger latency
+	int64_t latencyMax_us;		// maximum watch point to trigger latency
+	bool passed;				// no missed triggers and latency below the trigger period
+} self_test_result_t;
+
+/* Drift test configuration */
+typedef struct {
+	pcnt_mode_t mode;		// counting mode under test
+	uint32_t spacing;		// pulses between triggers
+	uint32_t numTriggers;	// number of triggers
+	uint32_t frequencyHz;	// pulse frequency
+} self_test_drift_config_t;
+
+/* Result of a drift test */
+typedef struct {
+	uint32_t expectedTriggers;	// pulses / spacing
+	uint32_t countedTriggers;	// trigger edges counted by the second PCNT unit
+	uint32_t handledTriggers;	// triggers handled by the radar trigger task
+	uint32_t pulsesSent;		// pulses played by the pulse generator
+	int64_t driftPulses;		// pulses sent minus the pulses accounted for by the triggers and the counter
+	bool passed;				// no missed triggers and no drift
+} self_test_drift_result_t;
+
+/*
+	Results are reported to the host as
+	$STR<freq>,<expected>,<counted>,<handled>,<meanLatency_us>,<maxLatency_us>,<passed>#
+	for each frequency, followed by
+	$STC<maxSustainableFreq>#
+
+	The drift test is reported as
+	$SDR<mode>,<expected>,<counted>,<handled>,<pulses>,<driftPulses>,<passed>#
+*/
+
+/* Initialize the self-test task and the trigger counter */
+void selfTestInitialize(void);
+
+/* Start a loopback frequency sweep */
+esp_err_t selfTestStart(const self_test_config_t* pConfig);
+
+/* Start a loopback drift test */
+esp_err_t selfTestStartDrift(const self_test_drift_config_t* pConfig);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,260 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SignalAnalyzer.c
+
+  Abstract:
+
+	The implementation file of the encoder signal quality analyzer
+*/
+
+#include <string.h>
+#include <SignalAnalyzer.h>
+#include <PulseCounter.h>
+#include <EdgeCapture.h>
+#include "driver/mcpwm_prelude.h"
+
+
+/* A task handle for the analyzer */
+static TaskHandle_t xSignalAnalyzerTask;
+
+/* The task stack and control block */
+static StackType_t xSignalAnalyzerStack[SIGNAL_ANALYZER_TASK_STACK_SIZE_BYTES];
+static StaticTask_t xSignalAnalyzerTaskBuffer;
+
+/* MCPWM capture timer and channel */
+static mcpwm_cap_timer_handle_t analyzer_cap_timer;
+static mcpwm_cap_channel_handle_t analyzer_cap_channel;
+
+/* The analysis in progress (written by the capture interrupt) */
+typedef struct {
+    uint32_t numEdges;
+    uint32_t shortWidths;
+    uint32_t missedEdges;
+    uint32_t minWidth[SIGNAL_ANALYZER_HISTOGRAM_COUNT];
+    uint32_t bins[SIGNAL_ANALYZER_HISTOGRAM_COUNT][SIGNAL_ANALYZER_NUM_BINS];
+    uint32_t lastEdgeTicks;
+    uint32_t lastRisingTicks;
+    bool lastEdgeRising;
+    bool haveLastEdge;
+    bool haveLastRising;
+} signal_analysis_t;
+
+static signal_analysis_t analysis;
+static uint32_t targetEdges;
+static uint32_t shortThresholdTicks;
+static volatile bool analyzerRunning = false;
+
+/* Send an event to the host PC */
+extern int transportSendEvent(const char* data, uint32_t length);
+
+/* Add a width to a histogram */
+static inline void addWidth(signal_analyzer_histogram_t histogram, uint32_t ticks)
+{
+    int bin = (ticks > 0) ? (31 - __builtin_clz(ticks)) : 0;
+    if (bin >= SIGNAL_ANALYZER_NUM_BINS) {
+        bin = SIGNAL_ANALYZER_NUM_BINS - 1;
+    }
+    analysis.bins[histogram][bin]++;
+
+    if (ticks < analysis.minWidth[histogram]) {
+        analysis.minWidth[histogram] = ticks;
+    }
+}
+
+/* Capture callback, called on both edges of the pulse input */
+static bool analyzer_on_cap(mcpwm_cap_channel_handle_t cap_channel, const mcpwm_capture_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t high_task_wakeup = pdFALSE;
+
+    if (analysis.numEdges >= targetEdges) {
+        return false;
+    }
+
+    uint32_t ticks = edata->cap_value;
+    bool rising = (edata->cap_edge == MCPWM_CAP_EDGE_POS);
+
+    if (analysis.haveLastEdge) {
+        if (rising == analysis.lastEdgeRising) {
+            /* an edge was lost in between, the width is unknown */
+            analysis.missedEdges++;
+        }
+        else {
+            /* a rising edge ends a low level, a falling edge ends a high level */
+            uint32_t width = ticks - analysis.lastEdgeTicks;
+            addWidth(rising ? SIGNAL_ANALYZER_LOW_WIDTH : SIGNAL_ANALYZER_HIGH_WIDTH, width);
+            if (width < shortThresholdTicks) {
+                analysis.shortWidths++;
+            }
+        }
+    }
+
+    if (rising) {
+        if (analysis.haveLastRising) {
+            addWidth(SIGNAL_ANALYZER_PERIOD, ticks - analysis.lastRisingTicks);
+        }
+        analysis.lastRisingTicks = ticks;
+        analysis.haveLastRising = true;
+    }
+
+    analysis.lastEdgeTicks = ticks;
+    analysis.lastEdgeRising = rising;
+    analysis.haveLastEdge = true;
+
+    /* wake up the task to report */
+    analysis.numEdges++;
+    if (analysis.numEdges == targetEdges) {
+        vTaskNotifyGiveFromISR(xSignalAnalyzerTask, &high_task_wakeup);
+    }
+
+    /* return whether a high priority task has been waken up by this function */
+    return (high_task_wakeup == pdTRUE);
+}
+
+/* The shortest width of a histogram in ns (0 if none was seen) */
+static uint32_t minWidth_ns(signal_analyzer_histogram_t histogram)
+{
+    uint32_t ticks = analysis.minWidth[histogram];
+    return (ticks == UINT32_MAX) ? 0 : (uint32_t)EDGE_CAPTURE_TICKS_TO_NS(ticks);
+}
+
+/* Report the analysis to the host */
+static void reportAnalysis(void)
+{
+    char reply[256];
+
+    int length = snprintf(reply, sizeof(reply), "$ANS%lu,%lu,%lu,%lu,%lu,%lu#\r\n",
+                        analysis.numEdges,
+                        analysis.shortWidths,
+                        analysis.missedEdges,
+                        minWidth_ns(SIGNAL_ANALYZER_HIGH_WIDTH),
+                        minWidth_ns(SIGNAL_ANALYZER_LOW_WIDTH),
+                        minWidth_ns(SIGNAL_ANALYZER_PERIOD));
+    transportSendEvent(reply, length);
+
+    for (int histogram = 0; histogram < SIGNAL_ANALYZER_HISTOGRAM_COUNT; histogram++) {
+        length = snprintf(reply, sizeof(reply), "$ANW%d", histogram);
+        for (int bin = 0; bin < SIGNAL_ANALYZER_NUM_BINS; bin++) {
+            length += snprintf(reply + length, sizeof(reply) - length, ",%lu", analysis.bins[histogram][bin]);
+        }
+        length += snprintf(reply + length, sizeof(reply) - length, "#\r\n");
+        transportSendEvent(reply, length);
+    }
+}
+
+/* The Signal Analyzer Task */
+static void signalAnalyzerTask(void* params)
+{
+    /* The parameter value is expected to be NULL. */
+    configASSERT(params == NULL);
+
+    while (1) {
+        /* Block until the edges are collected or the analysis is stopped */
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!analyzerRunning) {
+            continue;
+        }
+
+        ESP_ERROR_CHECK(mcpwm_capture_channel_disable(analyzer_cap_channel));
+        reportAnalysis();
+        analyzerRunning = false;
+    }
+}
+
+/* Initialize the analyzer */
+void signalAnalyzerInitialize(void)
+{
+    /* Set the log level */
+    static const char *TAG = "SIGNAL_ANALYZER_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    /* install the capture timer on its own group, the edge capture group is full */
+    mcpwm_capture_timer_config_t cap_conf = {
+        .group_id = SIGNAL_ANALYZER_GROUP_ID,
+        .clk_src = MCPWM_CAPTURE_CLK_SRC_DEFAULT,
+    };
+    ESP_ERROR_CHECK(mcpwm_new_capture_timer(&cap_conf, &analyzer_cap_timer));
+
+    /* both edges of the pulse input */
+    mcpwm_capture_channel_config_t cap_ch_conf = {
+        .gpio_num = PCNT_INPUT_EDGE_IO,
+        .prescale = 1,
+        .flags.pos_edge = true,
+        .flags.neg_edge = true,
+    };
+    ESP_ERROR_CHECK(mcpwm_new_capture_channel(analyzer_cap_timer, &cap_ch_conf, &analyzer_cap_channel));
+
+    mcpwm_capture_event_callbacks_t cbs = {
+        .on_cap = analyzer_on_cap,
+    };
+    ESP_ERROR_CHECK(mcpwm_capture_channel_register_event_callbacks(analyzer_cap_channel, &cbs, NULL));
+
+    /* the channel stays disabled until an analysis is started */
+    ESP_ERROR_CHECK(mcpwm_capture_timer_enable(analyzer_cap_timer));
+    ESP_ERROR_CHECK(mcpwm_capture_timer_start(analyzer_cap_timer));
+
+    /* Create the task, store the handle. */
+    xSignalAnalyzerTask = xTaskCreateStaticPinnedToCore(
+                        signalAnalyzerTask,                    /* Function that implements the task. */
+                        "SignalAnalyzerTask",                  /* Text name for the task. */
+                        SIGNAL_ANALYZER_TASK_STACK_SIZE_BYTES, /* Stack size in bytes. */
+                        NULL,                                  /* Parameter passed into the task. */
+                        2,                                     /* Priority at which the task is created. */
+                        xSignalAnalyzerStack,                  /* The task stack. */
+                        &xSignalAnalyzerTaskBuffer,            /* The task control block. */
+                        1);                                    /* Core number. */
+    if( xSignalAnalyzerTask == NULL )
+    {
+        /* The task is not created. */
+        ESP_LOGI(TAG, "The Signal Analyzer Task could not created.");
+    }
+}
+
+/* Analyze the given number of edges of the pulse input */
+esp_err_t signalAnalyzerStart(uint32_t numEdges, uint32_t shortThreshold_ns)
+{
+    if (analyzerRunning) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (numEdges == 0 || numEdges > SIGNAL_ANALYZER_MAX_EDGES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(&analysis, 0, sizeof(analysis));
+    for (int histogram = 0; histogram < SIGNAL_ANALYZER_HISTOGRAM_COUNT; histogram++) {
+        analysis.minWidth[histogram] = UINT32_MAX;
+    }
+    targetEdges = numEdges;
+    shortThresholdTicks = (uint32_t)((uint64_t)shortThreshold_ns * 2 / 25);
+
+    analyzerRunning = true;
+    ESP_ERROR_CHECK(mcpwm_capture_channel_enable(analyzer_cap_channel));
+    return ESP_OK;
+}
+
+/* Stop the analysis and report what has been collected */
+void signalAnalyzerStop(void)
+{
+    if (analyzerRunning) {
+        xTaskNotifyGive(xSignalAnalyzerTask);
+    }
+}
+
+/* The capture timer of the analyzer group, its two other channels are free for the time sync */
+mcpwm_cap_timer_handle_t signalAnalyzerGetCaptureTimer(void)
+{
+    return analyzer_cap_timer;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SignalAnalyzer.h
+
+  Abstract:
+
+	The header file of the encoder signal quality analyzer
+*/
+
+#ifndef SIGNAL_ANALYZER_H
+#define SIGNAL_ANALYZER_H
+
+#include "Config.h"
+#include "esp_err.h"
+#include "driver/mcpwm_prelude.h"
+
+
+/*
+	Both edges of the pulse input are captured on a second MCPWM group,
+	running from the APB clock like the edge capture (12.5 ns per tick).
+	Every edge raises an interrupt, so the analyzer runs for a bounded number of edges.
+*/
+#define SIGNAL_ANALYZER_GROUP_ID		1
+#define SIGNAL_ANALYZER_MAX_EDGES		1000000
+
+// Histogram bin k holds the widths of [2^k, 2^(k+1)) ticks, the last bin holds everything longer
+#define SIGNAL_ANALYZER_NUM_BINS		20
+
+/* The histograms */
+typedef enum {
+	SIGNAL_ANALYZER_HIGH_WIDTH = 0,
+	SIGNAL_ANALYZER_LOW_WIDTH,
+	SIGNAL_ANALYZER_PERIOD,
+	SIGNAL_ANALYZER_HISTOGRAM_COUNT,
+} signal_analyzer_histogram_t;
+
+/*
+	The analysis is reported to the host as
+	$ANS<edges>,<shortWidths>,<missedEdges>,<minHigh_ns>,<minLow_ns>,<minPeriod_ns>#
+	$ANW<histogram>,<bin0>,...,<bin19>#	(one line per histogram)
+	A width is short if it is below the threshold, a missed edge is two edges of the same polarity in a row
+*/
+
+/* Initialize the analyzer (idle until started) */
+void signalAnalyzerInitialize(void);
+
+/* Analyze the given number of edges of the pulse input */
+esp_err_t signalAnalyzerStart(uint32_t numEdges, uint32_t shortThreshold_ns);
+
+/* Stop the analysis and report what has been collected */
+void signalAnalyzerStop(void);
+
+/* The capture timer of the analyzer group, its two other channels are free for the time sync */
+mcpwm_cap_timer_handle_t signalAnalyzerGetCaptureTimer(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,172 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SocketServer.c
+
+  Abstract:
+
+	The implementation file of the TCP command / UDP event socket server
+*/
+
+#include <string.h>
+#include <unistd.h>
+#include <SocketServer.h>
+
+#ifndef ESP_PLATFORM
+	#include <netinet/tcp.h>
+#endif
+
+
+/* Open the TCP listening socket and the UDP event socket */
+int socketServerOpen(socket_server_t* pServer, uint16_t commandPort, uint16_t eventPort)
+{
+    memset(pServer, 0, sizeof(socket_server_t));
+    pServer->clientSocket = -1;
+    pServer->eventPort = eventPort;
+
+    pServer->listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (pServer->listenSocket < 0) {
+        return -1;
+    }
+    int reuse = 1;
+    setsockopt(pServer->listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in address = {
+        .sin_family = AF_INET,
+        .sin_port = htons(commandPort),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if ((bind(pServer->listenSocket, (struct sockaddr*)&address, sizeof(address)) != 0)
+        || (listen(pServer->listenSocket, 1) != 0)) {
+        close(pServer->listenSocket);
+        return -1;
+    }
+
+    pServer->eventSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (pServer->eventSocket < 0) {
+        close(pServer->listenSocket);
+        return -1;
+    }
+    return 0;
+}
+
+/* Wait for a host to connect */
+int socketServerAccept(socket_server_t* pServer)
+{
+    struct sockaddr_in address;
+    socklen_t addressLength = sizeof(address);
+    int clientSocket = accept(pServer->listenSocket, (struct sockaddr*)&address, &addressLength);
+    if (clientSocket < 0) {
+        return -1;
+    }
+
+    /* the replies are short, do not wait to coalesce them */
+    int noDelay = 1;
+    setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    /* the events go to the same host on the event port */
+    address.sin_port = htons(pServer->eventPort);
+    pServer->eventAddress = address;
+    pServer->eventAddressValid = true;
+
+    pServer->clientSocket = clientSocket;
+    pServer->frameFill = 0;
+    return 0;
+}
+
+/* Receive the commands of the connected host */
+void socketServerReceive(socket_server_t* pServer, socket_frame_handler_t handler, void* pContext)
+{
+    uint8_t rxBuffer[SOCKET_SERVER_FRAME_SIZE];
+
+    while (1) {
+        int rxBytes = recv(pServer->clientSocket, rxBuffer, sizeof(rxBuffer), 0);
+        if (rxBytes <= 0) {
+            break;
+        }
+
+        /* a TCP stream has no packet boundaries, collect the bytes from $ to # */
+        for (int i = 0; i < rxBytes; i++) {
+            uint8_t symbol = rxBuffer[i];
+            if (symbol == '$') {
+                pServer->frameFill = 0;
+            }
+            else if (pServer->frameFill == 0) {
+                /* outside of a packet */
+                continue;
+            }
+
+            if (pServer->frameFill >= SOCKET_SERVER_FRAME_SIZE) {
+                /* oversized packet, drop it */
+                pServer->frameFill = 0;
+                continue;
+            }
+            pServer->frame[pServer->frameFill++] = symbol;
+
+            if (symbol == '#') {
+                handler(pServer->frame, pServer->frameFill, pContext);
+                pServer->frameFill = 0;
+            }
+        }
+    }
+
+    pServer->eventAddressValid = false;
+    close(pServer->clientSocket);
+    pServer->clientSocket = -1;
+}
+
+/* Send a reply to the connected host */
+int socketServerSendReply(socket_server_t* pServer, const char* data, uint32_t length)
+{
+    int clientSocket = pServer->clientSocket;
+    if (clientSocket < 0) {
+        return 0;
+    }
+
+    uint32_t sentBytes = 0;
+    while (sentBytes < length) {
+        int txBytes = send(clientSocket, data + sentBytes, length - sentBytes, 0);
+        if (txBytes <= 0) {
+            break;
+        }
+        sentBytes += txBytes;
+    }
+    return (int)sentBytes;
+}
+
+/* Send an event to the connected host */
+int socketServerSendEvent(socket_server_t* pServer, const char* data, uint32_t length)
+{
+    if (!pServer->eventAddressValid) {
+        return 0;
+    }
+
+    int txBytes = sendto(pServer->eventSocket, data, length, 0,
+                        (struct sockaddr*)&pServer->eventAddress, sizeof(pServer->eventAddress));
+    return (txBytes < 0) ? 0 : txBytes;
+}
+
+/* Close every socket */
+void socketServerClose(socket_server_t* pServer)
+{
+    pServer->eventAddressValid = false;
+    if (pServer->clientSocket >= 0) {
+        close(pServer->clientSocket);
+        pServer->clientSocket = -1;
+    }
+    close(pServer->eventSocket);
+    close(pServer->listenSocket);
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SocketTransport.c
+
+  Abstract:
+
+	The implementation file of the Wi-Fi socket transport
+*/
+
+#include <string.h>
+#include <SocketTransport.h>
+#include <SocketServer.h>
+#include <Transport.h>
+#include "esp_wifi.h"
+#include "esp_netif.h"
+#include "esp_event.h"
+#include "nvs_flash.h"
+#include "esp_timer.h"
+
+
+/* The socket server */
+static socket_server_t socketServer;
+
+/* The task stack and control block */
+static StackType_t xSocketTransportStack[SOCKET_TRANSPORT_TASK_STACK_SIZE_BYTES];
+static StaticTask_t xSocketTransportTaskBuffer;
+
+/* Send a reply to the connected host */
+static int sendSocketReply(const char* data, uint32_t length)
+{
+    return socketServerSendReply(&socketServer, data, length);
+}
+
+/* Send an event to the connected host */
+static int sendSocketEvent(const char* data, uint32_t length)
+{
+    return socketServerSendEvent(&socketServer, data, length);
+}
+
+// The socket transport (replies over TCP, events over UDP)
+static const transport_t socketTransport = {
+    .name = "SOCKET",
+    .send = sendSocketReply,
+    .sendEvent = sendSocketEvent,
+};
+
+/* Pass a received packet to the protocol engine */
+static void handleSocketFrame(const uint8_t* pFrame, uint32_t sizeInBytes, void* pContext)
+{
+    transportHandleBuffer(&socketTransport, pFrame, sizeInBytes, esp_timer_get_time());
+}
+
+/* Reconnect whenever the access point is lost */
+static void wifiEventHandler(void* arg, esp_event_base_t eventBase, int32_t eventId, void* eventData)
+{
+    /* Set the log level */
+    static const char *TAG = "SOCKET_TRANSPORT_WIFI";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    if (eventBase == WIFI_EVENT && eventId == WIFI_EVENT_STA_START) {
+        esp_wifi_connect();
+    }
+    else if (eventBase == WIFI_EVENT && eventId == WIFI_EVENT_STA_DISCONNECTED) {
+        ESP_LOGI(TAG, "Disconnected, reconnecting");
+        esp_wifi_connect();
+    }
+    else if (eventBase == IP_EVENT && eventId == IP_EVENT_STA_GOT_IP) {
+        ip_event_got_ip_t* event = (ip_event_got_ip_t*)eventData;
+        ESP_LOGI(TAG, "Got IP " IPSTR, IP2STR(&event->ip_info.ip));
+    }
+}
+
+/* Initialize the Wi-Fi station */
+static void wifiInitialize(void)
+{
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(err);
+
+    ESP_ERROR_CHECK(esp_netif_init());
+    ESP_ERROR_CHECK(esp_event_loop_create_default());
+    esp_netif_create_default_wifi_sta();
+
+    wifi_init_config_t init_config = WIFI_INIT_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK(esp_wifi_init(&init_config));
+
+    ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID, wifiEventHandler, NULL));
+    ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, wifiEventHandler, NULL));
+
+    wifi_config_t wifi_config = {
+        .sta = {
+            .ssid = SOCKET_TRANSPORT_WIFI_SSID,
+            .password = SOCKET_TRANSPORT_WIFI_PASSWORD,
+        },
+    };
+    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
+    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+
+    /* keep the radio awake, power save adds up to a beacon interval to every packet */
+    ESP_ERROR_CHECK(esp_wifi_set_ps(WIFI_PS_NONE));
+    ESP_ERROR_CHECK(esp_wifi_start());
+}
+
+/* The Socket Transport Task */
+static void socketTransportTask(void* params)
+{
+    /* The parameter value is expected to be NULL. */
+    configASSERT(params == NULL);
+
+    /* Set the log level */
+    static const char *TAG = "SOCKET_TRANSPORT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    if (socketServerOpen(&socketServer, SOCKET_TRANSPORT_COMMAND_PORT, SOCKET_TRANSPORT_EVENT_PORT) != 0) {
+        ESP_LOGI(TAG, "The socket server could not be opened.");
+        vTaskDelete(NULL);
+    }
+
+    while (1) {
+        /* serve a single host at a time */
+        if (socketServerAccept(&socketServer) != 0) {
+            vTaskDelay(pdMS_TO_TICKS(100));
+            continue;
+        }
+        ESP_LOGI(TAG, "Host is connected");
+        socketServerReceive(&socketServer, handleSocketFrame, NULL);
+        ESP_LOGI(TAG, "Host is disconnected");
+    }
+}
+
+/* Initialize the Wi-Fi station and the socket server */
+void socketTransportInitialize(void)
+{
+    /* Set the log level */
+    static const char *TAG = "SOCKET_TRANSPORT_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    wifiInitialize();
+
+    ESP_ERROR_CHECK(transportRegister(&socketTransport));
+
+    /* Create the task. */
+    TaskHandle_t xSocketTransportTask;
+    xSocketTransportTask = xTaskCreateStaticPinnedToCore(
+                        socketTransportTask,                    /* Function that implements the task. */
+                        "SocketTransportTask",                  /* Text name for the task. */
+                        SOCKET_TRANSPORT_TASK_STACK_SIZE_BYTES, /* Stack size in bytes. */
+                        NULL,                                   /* Parameter passed into the task. */
+                        3,                                      /* Priority at which the task is created. */
+                        xSocketTransportStack,                  /* The task stack. */
+                        &xSocketTransportTaskBuffer,            /* The task control block. */
+                        0);                                     /* Core number. */
+    if( xSocketTransportTask == NULL )
+    {
+        /* The task is not created. */
+        ESP_LOGI(TAG, "The Socket Transport Task could not created.");
+    }
+}
\ No newline at end of file
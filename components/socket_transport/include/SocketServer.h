@@ -0,0 +1,86 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SocketServer.h
+
+  Abstract:
+
+	The header file of the TCP command / UDP event socket server
+	(plain BSD sockets, it runs on lwIP and on a Linux loopback alike)
+*/
+
+#ifndef SOCKET_SERVER_H
+#define SOCKET_SERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef ESP_PLATFORM
+	#include "lwip/sockets.h"
+#else
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Largest command packet ($ ... #)
+#define SOCKET_SERVER_FRAME_SIZE	128
+
+/* Called for every complete command packet */
+typedef void (*socket_frame_handler_t)(const uint8_t* pFrame, uint32_t sizeInBytes, void* pContext);
+
+/* Socket server instance */
+typedef struct {
+	int listenSocket;					// TCP listening socket
+	int clientSocket;					// TCP socket of the connected host (-1: none)
+	int eventSocket;					// UDP socket for the events
+	uint16_t eventPort;					// UDP port of the host
+	struct sockaddr_in eventAddress;	// the events go to the connected host
+	volatile bool eventAddressValid;
+	uint8_t frame[SOCKET_SERVER_FRAME_SIZE];
+	uint32_t frameFill;
+} socket_server_t;
+
+/* Open the TCP listening socket and the UDP event socket, returns 0 on success */
+int socketServerOpen(socket_server_t* pServer, uint16_t commandPort, uint16_t eventPort);
+
+/* Wait for a host to connect, its address becomes the event destination, returns 0 on success */
+int socketServerAccept(socket_server_t* pServer);
+
+/*
+	Receive the commands of the connected host and pass every $...# packet to the handler
+	Returns when the host disconnects
+*/
+void socketServerReceive(socket_server_t* pServer, socket_frame_handler_t handler, void* pContext);
+
+/* Send a reply to the connected host over TCP */
+int socketServerSendReply(socket_server_t* pServer, const char* data, uint32_t length);
+
+/* Send an event to the connected host over UDP (dropped if no host is connected) */
+int socketServerSendEvent(socket_server_t* pServer, const char* data, uint32_t length);
+
+/* Close every socket */
+void socketServerClose(socket_server_t* pServer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SocketTransport.h
+
+  Abstract:
+
+	The header file of the Wi-Fi socket transport
+	(commands and replies over TCP, events over UDP)
+*/
+
+#ifndef SOCKET_TRANSPORT_H
+#define SOCKET_TRANSPORT_H
+
+#include "Config.h"
+
+
+// Define following to control the scanner over Wi-Fi (in addition to the UART)
+// #define SOCKET_TRANSPORT_MODE
+
+// Wi-Fi station credentials, set them with idf.py menuconfig (SarSync socket transport)
+#define SOCKET_TRANSPORT_WIFI_SSID			CONFIG_SOCKET_TRANSPORT_WIFI_SSID
+#define SOCKET_TRANSPORT_WIFI_PASSWORD		CONFIG_SOCKET_TRANSPORT_WIFI_PASSWORD
+
+// The host connects to the command port, the events are sent to the same host on the event port
+#define SOCKET_TRANSPORT_COMMAND_PORT		3333
+#define SOCKET_TRANSPORT_EVENT_PORT			3334
+
+// Initialize the Wi-Fi station and the socket server
+void socketTransportInitialize(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,110 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SyncDiscipline.c
+
+  Abstract:
+
+	The implementation file of the sync pulse timebase discipline
+*/
+
+#include <stddef.h>
+#include <SyncDiscipline.h>
+
+
+/* Start over, the next pulse is at sync time zero */
+void syncDisciplineReset(sync_discipline_t* pDiscipline, uint32_t periodTicks)
+{
+    sync_discipline_t reset = { 0 };
+    reset.periodTicks = periodTicks;
+    *pDiscipline = reset;
+}
+
+/* Add a sync pulse, returns false if it is rejected */
+bool syncDisciplineAddPulse(sync_discipline_t* pDiscipline, uint32_t captureTicks, int64_t localTime_us)
+{
+    if (!pDiscipline->started) {
+        pDiscipline->started = true;
+        pDiscipline->lastCapture = captureTicks;
+        pDiscipline->lastLocalTime_us = localTime_us;
+        pDiscipline->localTicks = captureTicks;
+        pDiscipline->syncTicks = 0;
+        pDiscipline->anchorTicks = localTime_us * SYNC_TICKS_PER_US - captureTicks;
+        pDiscipline->numPulses = 1;
+        return true;
+    }
+
+    /* the exact interval from the capture, its wraps from the interrupt times */
+    int64_t coarseTicks = (localTime_us - pDiscipline->lastLocalTime_us) * SYNC_TICKS_PER_US;
+    int64_t fineTicks = (uint32_t)(captureTicks - pDiscipline->lastCapture);
+    int64_t wraps = (coarseTicks - fineTicks + (1LL << 31)) >> 32;
+    int64_t intervalTicks = fineTicks + (wraps << 32);
+
+    /* the number of periods since the last pulse, more than one if pulses are lost */
+    int64_t numPeriods = (intervalTicks + pDiscipline->periodTicks / 2) / pDiscipline->periodTicks;
+    if (numPeriods <= 0) {
+        pDiscipline->numRejected++;
+        return false;
+    }
+    int64_t nominalTicks = numPeriods * pDiscipline->periodTicks;
+    int64_t measured_ppb = (intervalTicks - nominalTicks) * 1000000000LL / nominalTicks;
+    if (measured_ppb > SYNC_MAX_DRIFT_PPB || measured_ppb < -SYNC_MAX_DRIFT_PPB) {
+        pDiscipline->numRejected++;
+        return false;
+    }
+
+    /* the first interval sets the drift, the later ones are averaged */
+    if (!pDiscipline->locked) {
+        pDiscipline->drift_ppb = (int32_t)measured_ppb;
+        pDiscipline->locked = true;
+    }
+    else {
+        pDiscipline->drift_ppb += (int32_t)((measured_ppb - pDiscipline->drift_ppb) / (1 << SYNC_DRIFT_FILTER_SHIFT));
+    }
+
+    pDiscipline->lastCapture = captureTicks;
+    pDiscipline->lastLocalTime_us = localTime_us;
+    pDiscipline->localTicks += intervalTicks;
+    pDiscipline->syncTicks += nominalTicks;
+    pDiscipline->numPulses++;
+    pDiscipline->numMissed += (uint32_t)(numPeriods - 1);
+
+    int64_t anchorTicks = localTime_us * SYNC_TICKS_PER_US - pDiscipline->localTicks;
+    if (anchorTicks < pDiscipline->anchorTicks) {
+        pDiscipline->anchorTicks = anchorTicks;
+    }
+    return true;
+}
+
+/* Convert a local time to the sync time, returns false until the discipline is locked */
+bool syncDisciplineToSyncTime(const sync_discipline_t* pDiscipline, int64_t localTime_us, int64_t* pSyncTime_us)
+{
+    if (!pDiscipline->locked) {
+        return false;
+    }
+
+    /* the local ticks since the last pulse, scaled to the master rate */
+    int64_t elapsedTicks = localTime_us * SYNC_TICKS_PER_US - pDiscipline->anchorTicks - pDiscipline->localTicks;
+    int64_t syncTicks = pDiscipline->syncTicks + elapsedTicks - elapsedTicks * pDiscipline->drift_ppb / 1000000000LL;
+    *pSyncTime_us = syncTicks / SYNC_TICKS_PER_US;
+    return true;
+}
+
+/* Local time minus sync time at the last pulse in us */
+int64_t syncDisciplineGetOffset(const sync_discipline_t* pDiscipline)
+{
+    return (pDiscipline->localTicks + pDiscipline->anchorTicks - pDiscipline->syncTicks) / SYNC_TICKS_PER_US;
+}
\ No newline at end of file
@@ -0,0 +1,249 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	TimeSync.c
+
+  Abstract:
+
+	The implementation file of the multi-board time synchronization
+*/
+
+#include <TimeSync.h>
+#include <SignalAnalyzer.h>
+#include <Health.h>
+#include "driver/ledc.h"
+#include "driver/mcpwm_prelude.h"
+#include "esp_timer.h"
+
+
+// The LEDC timer and channel of the master output
+#define TIME_SYNC_LEDC_MODE			LEDC_LOW_SPEED_MODE
+#define TIME_SYNC_LEDC_TIMER		LEDC_TIMER_1
+#define TIME_SYNC_LEDC_CHANNEL		LEDC_CHANNEL_1
+#define TIME_SYNC_LEDC_RESOLUTION	LEDC_TIMER_14_BIT
+#define TIME_SYNC_LEDC_DUTY			((1 << 14) / 100)	// 1% high
+
+/* A task handle for the sync reporter */
+static TaskHandle_t xTimeSyncTask;
+
+/* The task stack and control block */
+static StackType_t xTimeSyncStack[TIME_SYNC_TASK_STACK_SIZE_BYTES];
+static StaticTask_t xTimeSyncTaskBuffer;
+
+/* Capture channels of the own output (master) and of the sync input (slave) */
+static mcpwm_cap_channel_handle_t sync_cap_channels[TIME_SYNC_MODE_COUNT];
+
+/* The discipline, updated by the capture interrupt and read by the radar trigger task */
+static sync_discipline_t discipline;
+static portMUX_TYPE disciplineLock = portMUX_INITIALIZER_UNLOCKED;
+
+static time_sync_mode_t timeSyncMode = TIME_SYNC_OFF;
+static uint32_t timeSyncRate_Hz = TIME_SYNC_DEFAULT_RATE_HZ;
+
+/* Send an event to the host PC */
+extern int transportSendEvent(const char* data, uint32_t length);
+
+/* Capture callback, called on the rising edge of a sync pulse */
+static bool time_sync_on_cap(mcpwm_cap_channel_handle_t cap_channel, const mcpwm_capture_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t high_task_wakeup = pdFALSE;
+    int64_t localTime_us = esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&disciplineLock);
+    syncDisciplineAddPulse(&discipline, edata->cap_value, localTime_us);
+    portEXIT_CRITICAL_ISR(&disciplineLock);
+
+    healthCountIsr(HEALTH_ISR_TIME_SYNC);
+    vTaskNotifyGiveFromISR(xTimeSyncTask, &high_task_wakeup);
+
+    /* return whether a high priority task has been waken up by this function */
+    return (high_task_wakeup == pdTRUE);
+}
+
+/* Report the status to the host */
+static void reportStatus(void)
+{
+    sync_discipline_t snapshot;
+    portENTER_CRITICAL(&disciplineLock);
+    snapshot = discipline;
+    portEXIT_CRITICAL(&disciplineLock);
+
+    char reply[96];
+    int length = snprintf(reply, sizeof(reply), "$SYS%d,%lu,%lu,%lu,%lld,%ld#\r\n",
+                        timeSyncMode,
+                        snapshot.numPulses,
+                        snapshot.numMissed,
+                        snapshot.numRejected,
+                        syncDisciplineGetOffset(&snapshot),
+                        snapshot.drift_ppb);
+    transportSendEvent(reply, length);
+}
+
+/* The Time Sync Task */
+static void timeSyncTask(void* params)
+{
+    /* The parameter value is expected to be NULL. */
+    configASSERT(params == NULL);
+
+    uint32_t lastPulses = 0;
+    bool lost = false;
+
+    while (1) {
+        /* Wait for a pulse, two periods without one are a lost sync */
+        TickType_t timeout = (timeSyncMode == TIME_SYNC_OFF) ? portMAX_DELAY : pdMS_TO_TICKS(2000 / timeSyncRate_Hz);
+        bool pulsed = (ulTaskNotifyTake(pdTRUE, timeout) != 0);
+
+        uint32_t numPulses = discipline.numPulses;
+        if (numPulses < lastPulses) {
+            /* the sync time started over */
+            lastPulses = 0;
+            lost = false;
+        }
+        if (numPulses == lastPulses) {
+            if (!pulsed && timeSyncMode != TIME_SYNC_OFF && numPulses > 0 && !lost) {
+                char reply[32];
+                int length = snprintf(reply, sizeof(reply), "$SYL%lu#\r\n", numPulses);
+                transportSendEvent(reply, length);
+                lost = true;
+            }
+            continue;
+        }
+        lost = false;
+
+        /* report the lock and then once per report period */
+        uint32_t pulsesPerReport = (TIME_SYNC_REPORT_PERIOD_MS * timeSyncRate_Hz) / 1000;
+        if (numPulses == 2 || (numPulses / pulsesPerReport) != (lastPulses / pulsesPerReport)) {
+            reportStatus();
+        }
+        lastPulses = numPulses;
+    }
+}
+
+/* Initialize the sync output and input (off until started) */
+void timeSyncInitialize(void)
+{
+    /* Set the log level */
+    static const char *TAG = "TIME_SYNC_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    /* the master output is low until the master is started */
+    ledc_timer_config_t ledc_timer = {
+        .speed_mode = TIME_SYNC_LEDC_MODE,
+        .timer_num = TIME_SYNC_LEDC_TIMER,
+        .duty_resolution = TIME_SYNC_LEDC_RESOLUTION,
+        .freq_hz = TIME_SYNC_DEFAULT_RATE_HZ,
+        .clk_cfg = LEDC_USE_APB_CLK,
+    };
+    ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
+
+    ledc_channel_config_t ledc_channel = {
+        .gpio_num = TIME_SYNC_OUTPUT_IO,
+        .speed_mode = TIME_SYNC_LEDC_MODE,
+        .channel = TIME_SYNC_LEDC_CHANNEL,
+        .timer_sel = TIME_SYNC_LEDC_TIMER,
+        .duty = 0,
+        .hpoint = 0,
+    };
+    ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
+
+    /* the rising edges of the own output (loop back) and of the sync input, on the spare analyzer channels */
+    mcpwm_capture_channel_config_t cap_ch_conf = {
+        .gpio_num = TIME_SYNC_OUTPUT_IO,
+        .prescale = 1,
+        .flags.pos_edge = true,
+        .flags.io_loop_back = true,
+    };
+    ESP_ERROR_CHECK(mcpwm_new_capture_channel(signalAnalyzerGetCaptureTimer(), &cap_ch_conf, &sync_cap_channels[TIME_SYNC_MASTER]));
+
+    cap_ch_conf.gpio_num = TIME_SYNC_INPUT_IO;
+    cap_ch_conf.flags.io_loop_back = false;
+    cap_ch_conf.flags.pull_down = true;
+    ESP_ERROR_CHECK(mcpwm_new_capture_channel(signalAnalyzerGetCaptureTimer(), &cap_ch_conf, &sync_cap_channels[TIME_SYNC_SLAVE]));
+
+    /* the channels stay disabled until a role is selected */
+    mcpwm_capture_event_callbacks_t cbs = {
+        .on_cap = time_sync_on_cap,
+    };
+    ESP_ERROR_CHECK(mcpwm_capture_channel_register_event_callbacks(sync_cap_channels[TIME_SYNC_MASTER], &cbs, NULL));
+    ESP_ERROR_CHECK(mcpwm_capture_channel_register_event_callbacks(sync_cap_channels[TIME_SYNC_SLAVE], &cbs, NULL));
+
+    /* Create the task, store the handle. */
+    xTimeSyncTask = xTaskCreateStaticPinnedToCore(
+                        timeSyncTask,                    /* Function that implements the task. */
+                        "TimeSyncTask",                  /* Text name for the task. */
+                        TIME_SYNC_TASK_STACK_SIZE_BYTES, /* Stack size in bytes. */
+                        NULL,                            /* Parameter passed into the task. */
+                        2,                               /* Priority at which the task is created. */
+                        xTimeSyncStack,                  /* The task stack. */
+                        &xTimeSyncTaskBuffer,            /* The task control block. */
+                        1);                              /* Core number. */
+    if( xTimeSyncTask == NULL )
+    {
+        /* The task is not created. */
+        ESP_LOGI(TAG, "The Time Sync Task could not created.");
+    }
+}
+
+/* Select the role of the board and the pulse rate, the sync time starts over */
+esp_err_t timeSyncStart(time_sync_mode_t mode, uint32_t rate_Hz)
+{
+    if (mode >= TIME_SYNC_MODE_COUNT || rate_Hz == 0 || rate_Hz > TIME_SYNC_MAX_RATE_HZ) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* stop the current role */
+    if (timeSyncMode == TIME_SYNC_MASTER) {
+        ESP_ERROR_CHECK(ledc_set_duty(TIME_SYNC_LEDC_MODE, TIME_SYNC_LEDC_CHANNEL, 0));
+        ESP_ERROR_CHECK(ledc_update_duty(TIME_SYNC_LEDC_MODE, TIME_SYNC_LEDC_CHANNEL));
+    }
+    if (timeSyncMode != TIME_SYNC_OFF) {
+        ESP_ERROR_CHECK(mcpwm_capture_channel_disable(sync_cap_channels[timeSyncMode]));
+    }
+
+    portENTER_CRITICAL(&disciplineLock);
+    syncDisciplineReset(&discipline, (uint32_t)(SYNC_TICKS_PER_US * 1000000ULL / rate_Hz));
+    portEXIT_CRITICAL(&disciplineLock);
+    timeSyncRate_Hz = rate_Hz;
+    timeSyncMode = mode;
+
+    if (mode != TIME_SYNC_OFF) {
+        ESP_ERROR_CHECK(mcpwm_capture_channel_enable(sync_cap_channels[mode]));
+    }
+    if (mode == TIME_SYNC_MASTER) {
+        /* restart the pulse train, its first edge is the sync epoch */
+        ESP_ERROR_CHECK(ledc_set_freq(TIME_SYNC_LEDC_MODE, TIME_SYNC_LEDC_TIMER, rate_Hz));
+        ESP_ERROR_CHECK(ledc_timer_rst(TIME_SYNC_LEDC_MODE, TIME_SYNC_LEDC_TIMER));
+        ESP_ERROR_CHECK(ledc_set_duty(TIME_SYNC_LEDC_MODE, TIME_SYNC_LEDC_CHANNEL, TIME_SYNC_LEDC_DUTY));
+        ESP_ERROR_CHECK(ledc_update_duty(TIME_SYNC_LEDC_MODE, TIME_SYNC_LEDC_CHANNEL));
+    }
+
+    /* wake up the task to apply the new timeout */
+    xTaskNotifyGive(xTimeSyncTask);
+    return ESP_OK;
+}
+
+/* Sync time of a local esp_timer time, -1 until the board is synchronized */
+int64_t timeSyncGetTime(int64_t localTime_us)
+{
+    int64_t syncTime_us;
+    bool locked;
+
+    portENTER_CRITICAL(&disciplineLock);
+    locked = syncDisciplineToSyncTime(&discipline, localTime_us, &syncTime_us);
+    portEXIT_CRITICAL(&disciplineLock);
+
+    return locked ? syncTime_us : -1;
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SyncDiscipline.h
+
+  Abstract:
+
+	The header file of the sync pulse timebase discipline
+	(plain C, no ESP-IDF dependency, so the host simulator runs the same code)
+*/
+
+#ifndef SYNC_DISCIPLINE_H
+#define SYNC_DISCIPLINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+//  Define sync discipline variables
+//-----------------------------------------------------------------------------
+
+// The sync pulses are timestamped by a capture timer running from the APB clock
+#define SYNC_TICKS_PER_US			80
+
+// Intervals further off the sync period are rejected as glitches (crystals are within +/-50 ppm)
+#define SYNC_MAX_DRIFT_PPB			500000
+
+// The drift estimate averages the measured intervals over about 2^shift pulses
+#define SYNC_DRIFT_FILTER_SHIFT		3
+
+/*
+	The sync time is the time of the master since its first sync pulse: pulse k is at k periods.
+	Every board timestamps the pulses in its own local time and keeps the mapping to the sync time:
+	the sync time of the last pulse and the rate of the local clock relative to the master (drift).
+	The capture time of a pulse is exact but only 32 bits wide; the local time of the interrupt
+	extends it and anchors the capture ticks to esp_timer. The interrupt latency only makes the
+	local time later, so the smallest difference seen is the anchor.
+*/
+typedef struct {
+	uint32_t periodTicks;		// nominal sync period in master ticks
+	bool started;				// the first pulse is seen
+	bool locked;				// the drift is measured
+	uint32_t lastCapture;		// capture value of the last pulse
+	int64_t lastLocalTime_us;	// local time of the last pulse interrupt
+	int64_t localTicks;			// local time of the last pulse (capture ticks, extended to 64 bits)
+	int64_t syncTicks;			// sync time of the last pulse
+	int64_t anchorTicks;		// local time in ticks minus the extended capture time
+	int32_t drift_ppb;			// rate of the local clock relative to the master (positive: runs fast)
+	uint32_t numPulses;			// accepted pulses
+	uint32_t numMissed;			// pulses lost in the gaps
+	uint32_t numRejected;		// pulses off the period
+} sync_discipline_t;
+
+/* Start over, the next pulse is at sync time zero */
+void syncDisciplineReset(sync_discipline_t* pDiscipline, uint32_t periodTicks);
+
+/* Add a sync pulse, returns false if it is rejected */
+bool syncDisciplineAddPulse(sync_discipline_t* pDiscipline, uint32_t captureTicks, int64_t localTime_us);
+
+/* Convert a local time to the sync time, returns false until the discipline is locked */
+bool syncDisciplineToSyncTime(const sync_discipline_t* pDiscipline, int64_t localTime_us, int64_t* pSyncTime_us);
+
+/* Local time minus sync time at the last pulse in us */
+int64_t syncDisciplineGetOffset(const sync_discipline_t* pDiscipline);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	TimeSync.h
+
+  Abstract:
+
+	The header file of the multi-board time synchronization
+*/
+
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include "Config.h"
+#include "esp_err.h"
+#include "SyncDiscipline.h"
+
+
+#define TIME_SYNC_OUTPUT_IO			25	// sync pulse output of the master
+#define TIME_SYNC_INPUT_IO			26	// sync pulse input of a slave
+
+// Sync pulse rate
+#define TIME_SYNC_DEFAULT_RATE_HZ	10
+#define TIME_SYNC_MAX_RATE_HZ		100
+
+// The status is reported about once per interval
+#define TIME_SYNC_REPORT_PERIOD_MS	1000
+
+/*
+	The master drives a hardware (LEDC) pulse train on TIME_SYNC_OUTPUT_IO, the slaves receive it on
+	TIME_SYNC_INPUT_IO. Every board, the master included (loop back), timestamps the rising edges with a
+	capture channel of the signal analyzer group and disciplines the sync time (see SyncDiscipline.h).
+	Start the slaves before the master, the first pulse of the master is sync time zero on every board.
+*/
+typedef enum {
+	TIME_SYNC_OFF = 0,
+	TIME_SYNC_MASTER,
+	TIME_SYNC_SLAVE,
+	TIME_SYNC_MODE_COUNT,
+} time_sync_mode_t;
+
+/*
+	The status is reported to the host as
+	$SYS<mode>,<pulses>,<missed>,<rejected>,<offset_us>,<drift_ppb>#
+	where the offset is the local esp_timer time minus the sync time, and
+	$SYL<pulses>#	once when the pulses stop for two periods
+*/
+
+/* Initialize the sync output and input (off until started) */
+void timeSyncInitialize(void);
+
+/* Select the role of the board and the pulse rate, the sync time starts over */
+esp_err_t timeSyncStart(time_sync_mode_t mode, uint32_t rate_Hz);
+
+/* Sync time of a local esp_timer time, -1 until the board is synchronized */
+int64_t timeSyncGetTime(int64_t localTime_us);
+
+#endif
\ No newline at end of file
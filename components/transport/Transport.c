@@ -0,0 +1,121 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	Transport.c
+
+  Abstract:
+
+	The implementation file of the host transport layer
+*/
+
+#include <Transport.h>
+#include "freertos/semphr.h"
+
+
+/* The registered transports */
+static const transport_t* transports[TRANSPORT_MAX_BACKENDS];
+static volatile int numTransports = 0;
+
+/* The protocol engine handles one packet at a time */
+static SemaphoreHandle_t transportMutex;
+static StaticSemaphore_t transportMutexBuffer;
+
+/* The transport whose packet is being handled and its receive time */
+static const transport_t* pActiveTransport = NULL;
+static int64_t activeReceiveTime_us = 0;
+
+/* The reply buffer of the protocol engine */
+static uint8_t sReplyBuffer[TRANSPORT_REPLY_BUFFER_SIZE];
+
+/* The simplified protocol engine */
+extern void uartHandleBufferSimplified(const uint8_t* pPostBuffer,
+                                    uint32_t postSizeInBytes,
+                                    uint8_t* pReplyBuffer,
+                                    uint32_t replySizeInBytes,
+                                    uint32_t* pNumReplyBytesWritten);
+
+/* Initialize the transport layer */
+void transportInitialize(void)
+{
+    transportMutex = xSemaphoreCreateMutexStatic(&transportMutexBuffer);
+    configASSERT(transportMutex);
+}
+
+/* Register a transport */
+esp_err_t transportRegister(const transport_t* pTransport)
+{
+    if (numTransports >= TRANSPORT_MAX_BACKENDS) {
+        return ESP_ERR_NO_MEM;
+    }
+    transports[numTransports] = pTransport;
+    numTransports++;
+    return ESP_OK;
+}
+
+/* Run the protocol engine on a received packet */
+void transportHandleBuffer(const transport_t* pTransport, const uint8_t* pBuffer, uint32_t sizeInBytes, int64_t receiveTime_us)
+{
+    uint32_t numReplyBytesWritten = 0;
+
+    xSemaphoreTake(transportMutex, portMAX_DELAY);
+    pActiveTransport = pTransport;
+    activeReceiveTime_us = receiveTime_us;
+
+    uartHandleBufferSimplified(pBuffer,
+                            sizeInBytes,
+                            sReplyBuffer,
+                            TRANSPORT_REPLY_BUFFER_SIZE,
+                            &numReplyBytesWritten);
+
+    // Send the reply buffer data
+    if (numReplyBytesWritten > 0)
+    {
+        pTransport->send((const char*)sReplyBuffer, numReplyBytesWritten);
+    }
+
+    pActiveTransport = NULL;
+    xSemaphoreGive(transportMutex);
+}
+
+/* The receive time of the packet being handled */
+int64_t transportGetReceiveTime(void)
+{
+    return activeReceiveTime_us;
+}
+
+/* Send a reply to the active transport */
+int transportSendReply(const char* data, uint32_t length)
+{
+    const transport_t* pTransport = pActiveTransport;
+    if (pTransport == NULL) {
+        return transportSendEvent(data, length);
+    }
+    return pTransport->send(data, length);
+}
+
+/* Send an event to every transport */
+int transportSendEvent(const char* data, uint32_t length)
+{
+    int sentBytes = 0;
+    for (int i = 0; i < numTransports; i++) {
+        const transport_t* pTransport = transports[i];
+        int txBytes = (pTransport->sendEvent != NULL) ? pTransport->sendEvent(data, length) : pTransport->send(data, length);
+        if (txBytes > sentBytes) {
+            sentBytes = txBytes;
+        }
+    }
+    return sentBytes;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	Transport.h
+
+  Abstract:
+
+	The header file of the host transport layer
+	(the simplified protocol engine is shared by every transport)
+*/
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include "Config.h"
+#include "esp_err.h"
+
+
+// Maximum number of transports (UART, socket, ...)
+#define TRANSPORT_MAX_BACKENDS		4
+
+// Size of the reply buffer of the protocol engine
+#define TRANSPORT_REPLY_BUFFER_SIZE	1024
+
+/* A host transport */
+typedef struct {
+	const char* name;
+	int (*send)(const char* data, uint32_t length);			// replies to the commands received on this transport
+	int (*sendEvent)(const char* data, uint32_t length);	// unsolicited events (NULL: use send)
+} transport_t;
+
+/* Initialize the transport layer (before any transport is registered) */
+void transportInitialize(void);
+
+/* Register a transport, events are sent to every registered transport */
+esp_err_t transportRegister(const transport_t* pTransport);
+
+/*
+	Run the protocol engine on a received packet and send the reply back on the same transport
+	Packets of different transports are handled one at a time
+	receiveTime_us is the local time (esp_timer) the packet was received
+*/
+void transportHandleBuffer(const transport_t* pTransport, const uint8_t* pBuffer, uint32_t sizeInBytes, int64_t receiveTime_us);
+
+/* The receive time of the packet being handled */
+int64_t transportGetReceiveTime(void);
+
+/* Send a reply to the transport whose command is being handled (all transports otherwise) */
+int transportSendReply(const char* data, uint32_t length);
+
+/* Send an event to every transport */
+int transportSendEvent(const char* data, uint32_t length);
+
+#endif
\ No newline at end of file
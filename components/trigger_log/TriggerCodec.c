@@ -0,0 +1,137 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	TriggerCodec.c
+
+  Abstract:
+
+	The implementation file of the compressed trigger record encoding
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <TriggerCodec.h>
+
+
+// A record is the mask and seven varints of at most ten bytes
+#define TRIGGER_CODEC_NUM_FIELDS		7
+#define TRIGGER_CODEC_MAX_RECORD_BYTES	(1 + TRIGGER_CODEC_NUM_FIELDS * 10)
+
+static const char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* Append a signed value as a zigzag varint, returns the new size */
+static uint32_t putVarint(uint8_t* pData, uint32_t size, int64_t value)
+{
+    uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    while (zigzag >= 0x80) {
+        pData[size++] = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    pData[size++] = (uint8_t)zigzag;
+    return size;
+}
+
+/* Start an empty block */
+void triggerEncoderReset(trigger_encoder_t* pEncoder)
+{
+    memset(pEncoder, 0, sizeof(*pEncoder));
+}
+
+/* Append a record, returns false if the block is full */
+bool triggerEncoderAdd(trigger_encoder_t* pEncoder, const trigger_record_t* pRecord)
+{
+    if (pEncoder->numRecords >= TRIGGER_CODEC_MAX_RECORDS) {
+        return false;
+    }
+
+    /* the residuals of the predictions */
+    const trigger_record_t* pLast = &pEncoder->last;
+    int64_t residuals[TRIGGER_CODEC_NUM_FIELDS] = {
+        (int64_t)pRecord->index - pLast->index - 1,
+        (int64_t)pRecord->position - pLast->position - pEncoder->positionStep,
+        pRecord->time_us - pLast->time_us - pEncoder->timeStep,
+        (int32_t)(pRecord->edgeTicks - pLast->edgeTicks - pEncoder->edgeStep),
+        (int32_t)(pRecord->triggerTicks - pRecord->edgeTicks - pEncoder->edgeToTrigger),
+        pRecord->syncTime_us - pLast->syncTime_us - pEncoder->syncStep,
+        (int64_t)pRecord->positionY - pLast->positionY - pEncoder->positionYStep,
+    };
+
+    /* the mask of the mispredicted fields and their residuals */
+    uint8_t record[TRIGGER_CODEC_MAX_RECORD_BYTES];
+    uint32_t size = 1;
+    record[0] = 0;
+    for (int field = 0; field < TRIGGER_CODEC_NUM_FIELDS; field++) {
+        if (residuals[field] != 0) {
+            record[0] |= (uint8_t)(1 << field);
+            size = putVarint(record, size, residuals[field]);
+        }
+    }
+
+    if (pEncoder->size + size > TRIGGER_CODEC_BLOCK_BYTES) {
+        return false;
+    }
+    memcpy(&pEncoder->data[pEncoder->size], record, size);
+    pEncoder->size += size;
+    pEncoder->numRecords++;
+
+    /* the predictors of the next record */
+    pEncoder->positionStep = (int64_t)pRecord->position - pLast->position;
+    pEncoder->timeStep = pRecord->time_us - pLast->time_us;
+    pEncoder->edgeStep = pRecord->edgeTicks - pLast->edgeTicks;
+    pEncoder->edgeToTrigger = pRecord->triggerTicks - pRecord->edgeTicks;
+    pEncoder->syncStep = pRecord->syncTime_us - pLast->syncTime_us;
+    pEncoder->positionYStep = (int64_t)pRecord->positionY - pLast->positionY;
+    pEncoder->last = *pRecord;
+    return true;
+}
+
+/* Format the block as a $TRZ frame, returns the length */
+uint32_t triggerEncoderFormat(const trigger_encoder_t* pEncoder, uint32_t sequence, uint32_t dropped,
+                            char* pBuffer, uint32_t sizeInBytes)
+{
+    int length = snprintf(pBuffer, sizeInBytes, "$TRZ%lu,%lu,%lu,",
+                        (unsigned long)sequence, (unsigned long)pEncoder->numRecords, (unsigned long)dropped);
+    uint32_t textSize = ((pEncoder->size + 2) / 3) * 4;
+    if (length < 0 || (uint32_t)length + textSize + 3 >= sizeInBytes) {
+        return 0;
+    }
+
+    /* base64 without padding, the last group is cut to the bytes it holds */
+    char* pText = pBuffer + length;
+    for (uint32_t i = 0; i < pEncoder->size; i += 3) {
+        uint32_t remaining = pEncoder->size - i;
+        uint32_t group = (uint32_t)pEncoder->data[i] << 16;
+        if (remaining > 1) {
+            group |= (uint32_t)pEncoder->data[i + 1] << 8;
+        }
+        if (remaining > 2) {
+            group |= pEncoder->data[i + 2];
+        }
+        *pText++ = base64Alphabet[(group >> 18) & 0x3F];
+        *pText++ = base64Alphabet[(group >> 12) & 0x3F];
+        if (remaining > 1) {
+            *pText++ = base64Alphabet[(group >> 6) & 0x3F];
+        }
+        if (remaining > 2) {
+            *pText++ = base64Alphabet[group & 0x3F];
+        }
+    }
+    *pText++ = '#';
+    *pText++ = '\r';
+    *pText++ = '\n';
+    *pText = '\0';
+    return (uint32_t)(pText - pBuffer);
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	TriggerLog.c
+
+  Abstract:
+
+	The implementation file of the trigger log
+*/
+
+#include <TriggerLog.h>
+#include <Health.h>
+
+
+/* The record ring, written by the radar trigger task and read by the host interface */
+static trigger_record_t triggerLog[TRIGGER_LOG_LENGTH];
+static volatile uint32_t triggerLogHead = 0;
+static volatile uint32_t triggerLogTail = 0;
+
+/* Number of records dropped because the log was full */
+static volatile uint32_t triggerLogDropped = 0;
+
+/* Append a record (single producer: the radar trigger task) */
+void triggerLogAppend(const trigger_record_t* pRecord)
+{
+    uint32_t head = triggerLogHead;
+
+    /* keep the oldest records, the host has not read them yet */
+    if (head - triggerLogTail >= TRIGGER_LOG_LENGTH) {
+        triggerLogDropped++;
+        healthRecordDrop(HEALTH_QUEUE_TRIGGER_LOG);
+        return;
+    }
+
+    triggerLog[head % TRIGGER_LOG_LENGTH] = *pRecord;
+    triggerLogHead = head + 1;
+    healthRecordLevel(HEALTH_QUEUE_TRIGGER_LOG, head + 1 - triggerLogTail);
+}
+
+/* Read the oldest record (single consumer), returns false if the log is empty */
+bool triggerLogRead(trigger_record_t* pRecord)
+{
+    uint32_t tail = triggerLogTail;
+
+    if (tail == triggerLogHead) {
+        return false;
+    }
+
+    *pRecord = triggerLog[tail % TRIGGER_LOG_LENGTH];
+    triggerLogTail = tail + 1;
+    return true;
+}
+
+/* Discard every record */
+void triggerLogClear(void)
+{
+    triggerLogTail = triggerLogHead;
+    triggerLogDropped = 0;
+}
+
+/* Number of records dropped because the log was full */
+uint32_t triggerLogGetDropped(void)
+{
+    return triggerLogDropped;
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	TriggerStream.c
+
+  Abstract:
+
+	The implementation file of the compressed live trigger log stream
+*/
+
+#include <TriggerLog.h>
+
+
+/* A task handle for the stream */
+static TaskHandle_t xTriggerStreamTask;
+
+/* The task stack and control block */
+static StackType_t xTriggerStreamStack[TRIGGER_STREAM_TASK_STACK_SIZE_BYTES];
+static StaticTask_t xTriggerStreamTaskBuffer;
+
+static volatile bool triggerStreamEnabled = false;
+static volatile bool triggerStreamRestart = false;
+
+/* The block being filled and the number of blocks sent since the stream was enabled */
+static trigger_encoder_t encoder;
+static uint32_t blockSequence = 0;
+
+/* Send an event to the host PC */
+extern int transportSendEvent(const char* data, uint32_t length);
+
+/* Send the block and start the next one */
+static void sendBlock(void)
+{
+    static char frame[TRIGGER_CODEC_FRAME_SIZE];
+
+    uint32_t length = triggerEncoderFormat(&encoder, blockSequence, triggerLogGetDropped(), frame, sizeof(frame));
+    transportSendEvent(frame, length);
+    blockSequence++;
+    triggerEncoderReset(&encoder);
+}
+
+/* The Trigger Stream Task */
+static void triggerStreamTask(void* params)
+{
+    /* The parameter value is expected to be NULL. */
+    configASSERT(params == NULL);
+
+    trigger_record_t record;
+
+    while (1) {
+        /* Sleep until enabled, then wake up every stream period */
+        ulTaskNotifyTake(pdTRUE, triggerStreamEnabled ? pdMS_TO_TICKS(TRIGGER_STREAM_PERIOD_MS) : portMAX_DELAY);
+        if (!triggerStreamEnabled) {
+            continue;
+        }
+        if (triggerStreamRestart) {
+            triggerStreamRestart = false;
+            triggerEncoderReset(&encoder);
+            blockSequence = 0;
+        }
+
+        /* full blocks go out at once, the rest at the end of the period */
+        while (triggerLogRead(&record)) {
+            if (!triggerEncoderAdd(&encoder, &record)) {
+                sendBlock();
+                triggerEncoderAdd(&encoder, &record);
+            }
+        }
+        if (encoder.numRecords > 0) {
+            sendBlock();
+        }
+    }
+}
+
+/* Initialize the live stream (off until enabled) */
+void triggerStreamInitialize(void)
+{
+    /* Set the log level */
+    static const char *TAG = "TRIGGER_STREAM_INIT";
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+
+    /* Create the task, store the handle. */
+    xTriggerStreamTask = xTaskCreateStaticPinnedToCore(
+                        triggerStreamTask,                    /* Function that implements the task. */
+                        "TriggerStreamTask",                  /* Text name for the task. */
+                        TRIGGER_STREAM_TASK_STACK_SIZE_BYTES, /* Stack size in bytes. */
+                        NULL,                                 /* Parameter passed into the task. */
+                        2,                                    /* Priority at which the task is created. */
+                        xTriggerStreamStack,                  /* The task stack. */
+                        &xTriggerStreamTaskBuffer,            /* The task control block. */
+                        1);                                   /* Core number. */
+    if( xTriggerStreamTask == NULL )
+    {
+        /* The task is not created. */
+        ESP_LOGI(TAG, "The Trigger Stream Task could not created.");
+    }
+}
+
+/* Start or stop the live stream */
+void triggerStreamEnable(bool enable)
+{
+    /* the task starts the block sequence over */
+    if (enable && !triggerStreamEnabled) {
+        triggerStreamRestart = true;
+    }
+    triggerStreamEnabled = enable;
+    xTaskNotifyGive(xTriggerStreamTask);
+}
+
+/* Whether the live stream is the consumer of the log */
+bool triggerStreamIsEnabled(void)
+{
+    return triggerStreamEnabled;
+}
\ No newline at end of file
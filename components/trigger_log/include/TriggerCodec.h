@@ -0,0 +1,97 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	TriggerCodec.h
+
+  Abstract:
+
+	The header file of the compressed trigger record encoding
+	(plain C, no ESP-IDF dependency, so it also builds on the host)
+*/
+
+#ifndef TRIGGER_CODEC_H
+#define TRIGGER_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Binary payload of a block, it is sent as base64 text (4 characters per 3 bytes)
+#define TRIGGER_CODEC_BLOCK_BYTES		240
+#define TRIGGER_CODEC_MAX_RECORDS		64
+
+// A  frame: command, three numbers, the payload, the terminator and a null
+#define TRIGGER_CODEC_FRAME_SIZE		(48 + ((TRIGGER_CODEC_BLOCK_BYTES + 2) / 3) * 4)
+
+/* A single trigger record */
+typedef struct {
+	uint32_t index;			// trigger number since the last clear
+	int32_t position;		// pulse position of the trigger
+	int64_t time_us;		// esp_timer time of the trigger
+	uint32_t edgeTicks;		// capture time of the counted edge that reached the watch point
+	uint32_t triggerTicks;	// capture time of the trigger edge
+	int64_t syncTime_us;	// time_us in the sync time of the board array (-1: not synchronized)
+	int32_t positionY;		// Y axis position of the trigger
+} trigger_record_t;
+
+/*
+	A block is a self-contained run of records, sent as
+	$TRZ<sequence>,<numRecords>,<dropped>,<base64 payload>#
+	Every field of a record is predicted from the previous records of the block:
+	  index			previous index + 1
+	  position		previous position + previous position step
+	  time_us		previous time + previous time step
+	  edgeTicks		previous edge + previous edge step (modulo 2^32)
+	  triggerTicks	edgeTicks + previous edge to trigger delay (modulo 2^32)
+	  syncTime_us	previous sync time + previous sync time step
+	  positionY		previous Y position + previous Y position step
+	A record starts with a byte whose bit n is set if field n (in this order) is mispredicted,
+	followed by the residuals of these fields as zigzag varints (7 bits per byte, the top bit
+	marks a following byte). The predictors start at zero in every block. Periodic triggers
+	leave few and small residuals, so a record takes a few bytes instead of about seventy as $TRG text.
+*/
+typedef struct {
+	trigger_record_t last;		// the previous record of the block
+	int64_t positionStep;
+	int64_t timeStep;
+	uint32_t edgeStep;
+	uint32_t edgeToTrigger;
+	int64_t syncStep;
+	int64_t positionYStep;
+	uint32_t numRecords;
+	uint32_t size;
+	uint8_t data[TRIGGER_CODEC_BLOCK_BYTES];
+} trigger_encoder_t;
+
+/* Start an empty block */
+void triggerEncoderReset(trigger_encoder_t* pEncoder);
+
+/* Append a record, returns false if the block is full (send it, reset and append again) */
+bool triggerEncoderAdd(trigger_encoder_t* pEncoder, const trigger_record_t* pRecord);
+
+/* Format the block as a $TRZ frame, returns the length (0 if the buffer is too small) */
+uint32_t triggerEncoderFormat(const trigger_encoder_t* pEncoder, uint32_t sequence, uint32_t dropped,
+							char* pBuffer, uint32_t sizeInBytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
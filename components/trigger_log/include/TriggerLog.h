@@ -0,0 +1,70 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	TriggerLog.h
+
+  Abstract:
+
+	The header file of the trigger log
+*/
+
+#ifndef TRIGGER_LOG_H
+#define TRIGGER_LOG_H
+
+#include "Config.h"
+#include "TriggerCodec.h"
+
+
+// Number of trigger records kept until they are read by the host
+#define TRIGGER_LOG_LENGTH		256
+
+// The live stream sends the new records this often
+#define TRIGGER_STREAM_PERIOD_MS	20
+
+/*
+	Records are reported to the host as
+	$TRG<index>,<position>,<time_us>,<edgeTicks>,<triggerTicks>,<edgeToTrigger_ns>,<syncTime_us>,<positionY>#
+	followed by
+	$TRE<numRecords>,<dropped>#
+*/
+
+/* Append a record (single producer: the radar trigger task) */
+void triggerLogAppend(const trigger_record_t* pRecord);
+
+/* Read the oldest record (single consumer), returns false if the log is empty */
+bool triggerLogRead(trigger_record_t* pRecord);
+
+/* Discard every record */
+void triggerLogClear(void);
+
+/* Number of records dropped because the log was full */
+uint32_t triggerLogGetDropped(void);
+
+/*
+	While the live stream is enabled it is the consumer of the log: the new records are sent
+	as compressed $TRZ blocks (see TriggerCodec.h) and $LOG# only reports $TRE0,<dropped>#
+*/
+
+/* Initialize the live stream (off until enabled) */
+void triggerStreamInitialize(void);
+
+/* Start or stop the live stream */
+void triggerStreamEnable(bool enable);
+
+/* Whether the live stream is the consumer of the log */
+bool triggerStreamIsEnabled(void);
+
+#endif
\ No newline at end of file
@@ -22,12 +22,21 @@
 */
 
 #include <Uart.h>
-#include <UartHandlerSimplified.h>
+#include <Transport.h>
+#include <Protocol.h>
+#include "esp_timer.h"
 
 
-// Create RX and TX buffers
+// Create RX buffer
 static uint8_t sUartRxBuffer[UART_BUFFER_SIZE];
-static char sUartTxBuffer[UART_BUFFER_SIZE];
+
+// The packet being collected (pipelined packets arrive back to back)
+static uint8_t sUartFrame[PROTOCOL_MIN_PACKET_SIZE + PROTOCOL_MAX_PARAMETER_SIZE];
+static uint32_t sUartFrameFill = 0;
+
+// The task stack and control block
+static StackType_t sUartTaskStack[UART_TASK_STACK_SIZE_BYTES];
+static StaticTask_t sUartTaskBuffer;
 
 // Define the UART number
 #ifdef UART_DEBUG_MODE
@@ -42,26 +51,57 @@ int sendUartData(const char* data, uint32_t length)
     return txBytes;
 }
 
+// The UART transport (replies and events on the same port)
+static const transport_t uartTransport = {
+    .name = "UART",
+    .send = sendUartData,
+    .sendEvent = NULL,
+};
+
 void uartTask(void *arg)
 {
-    // prepare the number of reply bytes
-    uint32_t numReplyBytesWritten = 0;
-
     // Read the packet and process it
     while (1) {
-        const int rxBytes = uart_read_bytes(UART_HOST_PC, sUartRxBuffer, UART_BUFFER_SIZE, 10 / portTICK_PERIOD_MS);
-        if (rxBytes > 0) {
-            // Handle the buffer content
-            uartHandleBufferSimplified(sUartRxBuffer,
-                        rxBytes,
-                        (uint8_t*)sUartTxBuffer,
-                        UART_BUFFER_SIZE,
-                        &numReplyBytesWritten);
-            
-            // Send the TX buffer data
-            if (numReplyBytesWritten > 0)
-            {
-                sendUartData(sUartTxBuffer, numReplyBytesWritten);
+        // Wait for the first byte and take what has arrived with it, a read timeout would delay
+        // the receive time of the packet (the clock exchange of the host relies on it)
+        int rxBytes = uart_read_bytes(UART_HOST_PC, sUartRxBuffer, 1, portMAX_DELAY);
+        if (rxBytes <= 0) {
+            continue;
+        }
+        const int64_t rxTime_us = esp_timer_get_time();
+        size_t bufferedBytes = 0;
+        ESP_ERROR_CHECK(uart_get_buffered_data_len(UART_HOST_PC, &bufferedBytes));
+        if (bufferedBytes > UART_BUFFER_SIZE - 1) {
+            bufferedBytes = UART_BUFFER_SIZE - 1;
+        }
+        if (bufferedBytes > 0) {
+            const int moreBytes = uart_read_bytes(UART_HOST_PC, sUartRxBuffer + 1, bufferedBytes, 0);
+            if (moreBytes > 0) {
+                rxBytes += moreBytes;
+            }
+        }
+
+        // Collect the bytes from $ to #, a read may hold several packets or a part of one
+        for (int i = 0; i < rxBytes; i++) {
+            uint8_t symbol = sUartRxBuffer[i];
+            if (symbol == PROTOCOL_START_SYMBOL) {
+                sUartFrameFill = 0;
+            }
+            else if (sUartFrameFill == 0) {
+                continue;
+            }
+
+            if (sUartFrameFill >= sizeof(sUartFrame)) {
+                // oversized packet, drop it
+                sUartFrameFill = 0;
+                continue;
+            }
+            sUartFrame[sUartFrameFill++] = symbol;
+
+            if (symbol == PROTOCOL_STOP_SYMBOL) {
+                // Handle the packet and send the reply
+                transportHandleBuffer(&uartTransport, sUartFrame, sUartFrameFill, rxTime_us);
+                sUartFrameFill = 0;
             }
         }
     }
@@ -92,17 +132,21 @@ void uartInitialize(void) {
 #endif
     ESP_ERROR_CHECK(uart_flush(UART_HOST_PC));
 
+    // Send the replies and the events over the UART
+    ESP_ERROR_CHECK(transportRegister(&uartTransport));
+
     // Create the UART task
-    BaseType_t xReturned;
-    xReturned = xTaskCreatePinnedToCore(
+    TaskHandle_t xUartTask;
+    xUartTask = xTaskCreateStaticPinnedToCore(
                     uartTask,
                     "UartTask",
-                    DEFAULT_TASK_STACK_SIZE_BYTES,
-                    NULL,
-                    configMAX_PRIORITIES,
+                    UART_TASK_STACK_SIZE_BYTES,
                     NULL,
+                    UART_TASK_PRIORITY,
+                    sUartTaskStack,
+                    &sUartTaskBuffer,
                     1);
-    if( xReturned != pdPASS )
+    if( xUartTask == NULL )
     {
         /* The task is not created. */
         ESP_LOGI(TAG, "The UART Task could not created.");
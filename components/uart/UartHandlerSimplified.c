@@ -23,37 +23,64 @@ Abstract:
 */
 
 
-#include <string.h>
-#include <stdlib.h>
 #include <UartHandlerSimplified.h>
+#include <Protocol.h>
 #include <Uart.h>
+#include <Transport.h>
+#include <PulseCounter.h>
+#include <PulseGenerator.h>
+#include <SelfTest.h>
+#include <MotionControl.h>
+#include <TriggerLog.h>
+#include <EdgeCapture.h>
+#include <ScanPlan.h>
+#include <Health.h>
+#include <SignalAnalyzer.h>
+#include <RadarTrigger.h>
+#include <TimeSync.h>
+#include <IndexCode.h>
+#include <FlashLog.h>
+#include "esp_timer.h"
 
 
-/* PCNT unit */
-extern pcnt_unit_handle_t pcnt_unit;
-
 /* PCNT threshold value */
 extern int pcntThreshold;
 
 /* A queue to handle Uart radar trigger events */
 QueueHandle_t uart_evt_queue;
 
-//-----------------------------------------------------------------------------
-//  Define simplified protocol version variables
-//-----------------------------------------------------------------------------
-static char startSymbol = '$';
-static char stopSymbol = '#';
+/* A task handle for the radar trigger */
+extern TaskHandle_t xRadarTriggerTask;
 
-static char radarTriggerCommand[] = "RTG";
-static char setDesiredNumberOfTriggerCommand[] = "DTG";
-static char clearNumberOfTriggerCommand[] = "CTG";
+/* The last accepted number of passes and offset per pass, to check the one against the other */
+static int32_t passConfigPasses = 0;
+static int32_t passConfigOffset = 0;
 
-static char setPulseCountCommand[] = "PLS";
-static char resetPcntCommand[] = "RST";
-static char pausePcntCommand[] = "PAU";
-static char resumePcntCommand[] = "RES";
+//-----------------------------------------------------------------------------
+// queue an event for the radar trigger task and wake it up
+//-----------------------------------------------------------------------------
+static void sendRadarTriggerEvent(const uart_evt_t* pEvt)
+{
+    if (xQueueSend(uart_evt_queue, pEvt, 0 / portTICK_PERIOD_MS) == pdTRUE)
+    {
+        healthRecordLevel(HEALTH_QUEUE_UART_EVENTS, uxQueueMessagesWaiting(uart_evt_queue));
+        xTaskNotify(xRadarTriggerTask, RADAR_TRIGGER_NOTIFY_UART_BIT, eSetBits);
+    }
+    else
+    {
+        healthRecordDrop(HEALTH_QUEUE_UART_EVENTS);
+    }
+}
 
-static char setNumMeasurementCommand[] = "MSR";
+//-----------------------------------------------------------------------------
+// reply a rejected multi-pass command
+//-----------------------------------------------------------------------------
+static void sendPassError(radar_trigger_pass_error_t error)
+{
+    char reply[16];
+    int length = snprintf(reply, sizeof(reply), "$MPX%d#\r\n", error);
+    transportSendReply(reply, length);
+}
 
 //-----------------------------------------------------------------------------
 // handle the post buffer (simplified version)
@@ -66,110 +93,197 @@ void uartHandleBufferSimplified(
     uint32_t replySizeInBytes,
     uint32_t* pNumReplyBytesWritten)
 {
-    /* Set the log level */
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
     static const char *TAG = "UART_HANDLE_BUFFER_SIMPLIFIED";
-    esp_log_level_set(TAG, ESP_LOG_INFO);
 
     //-----------------------------------------------------------------------------
     // by default, nothing is written to the reply buffer
     //-----------------------------------------------------------------------------
     *pNumReplyBytesWritten = 0;
 
-    //-----------------------------------------------------------------------------
-    // post packet should at least be the command size
-    //-----------------------------------------------------------------------------
-    if (postSizeInBytes < SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE)
-    {
-        ESP_LOGI(TAG, "Received packet is too small (received:%lu < expected:%d)", postSizeInBytes, SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE);
-        return;
-    }
-
     //-----------------------------------------------------------------------------
     // reply size should at least be the command size
     //-----------------------------------------------------------------------------
-    if (replySizeInBytes < SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE)
+    if (replySizeInBytes < PROTOCOL_MIN_PACKET_SIZE)
     {
-        ESP_LOGI(TAG, "Reply size is too small (received:%lu < expected:%d)", replySizeInBytes, SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE);
+        UART_COMMAND_LOGI(TAG, "Reply size is too small (received:%lu < expected:%d)", replySizeInBytes, PROTOCOL_MIN_PACKET_SIZE);
         return;
     }
 
     //-----------------------------------------------------------------------------
-    // check the start symbol
+    // parse the packet
     //-----------------------------------------------------------------------------
-    if (pPostBuffer[0] != startSymbol)
+    protocol_frame_t frame;
+    protocol_status_t status = protocolParseFrame(pPostBuffer, postSizeInBytes, &frame);
+    if (status != PROTOCOL_OK)
     {
-        ESP_LOGI(TAG, "Invalid start symbol is received");
+        UART_COMMAND_LOGI(TAG, "Received packet is rejected: %s", protocolStatusName(status));
         return;
     }
+    UART_COMMAND_LOGI(TAG, "%s command is received", protocolCommandName(frame.command));
 
     //-----------------------------------------------------------------------------
-    // check the stop symbol
+    // handle the command
     //-----------------------------------------------------------------------------
-    if (pPostBuffer[postSizeInBytes-1] != stopSymbol)
+    switch (frame.command)
     {
-        ESP_LOGI(TAG, "Invalid stop symbol is received");
-        return;
-    }
+        case PROTOCOL_COMMAND_RADAR_TRIGGER:
+            handleRadarTriggerCommand();
+            break;
+        case PROTOCOL_COMMAND_SET_DESIRED_NUM_TRIGGER:
+            handleSetDesiredNumberOfTriggerCommand(&frame);
+            break;
+        case PROTOCOL_COMMAND_CLEAR_NUM_TRIGGER:
+            handleClearNumberOfTriggerCommand();
+            break;
 
-    //-----------------------------------------------------------------------------
-    // get the pointer for the command part
-    //-----------------------------------------------------------------------------
-    const uint8_t* pCommand = pPostBuffer + 1;
+        case PROTOCOL_COMMAND_SET_PULSE_COUNT:
+            handleSetPulseCountCommand(&frame);
+            break;
+        case PROTOCOL_COMMAND_RESET_PCNT:
+            handleResetPcntCommand();
+            break;
+        case PROTOCOL_COMMAND_PAUSE_PCNT:
+            handlePausePcntCommand();
+            break;
+        case PROTOCOL_COMMAND_RESUME_PCNT:
+            handleResumePcntCommand();
+            break;
 
-    //-----------------------------------------------------------------------------
-    // handle the command
-    //-----------------------------------------------------------------------------
-    if ((memcmp(pCommand, radarTriggerCommand, SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE) == 0)
-        && (postSizeInBytes == SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE))
-    {
-        ESP_LOGI(TAG, "Radar trigger command is received");
-        handleRadarTriggerCommand();
-    }
-    else if (memcmp(pCommand, setDesiredNumberOfTriggerCommand, SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE) == 0)
-    {
-        ESP_LOGI(TAG, "Set desired number of Radar trigger command is received");
-        handleSetDesiredNumberOfTriggerCommand(pCommand, postSizeInBytes);
-    }
-    else if ((memcmp(pCommand, clearNumberOfTriggerCommand, SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE) == 0)
-        && (postSizeInBytes == SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE))
-    {
-        ESP_LOGI(TAG, "Clear number of Radar trigger command is received");
-        handleClearNumberOfTriggerCommand();
-    }
+        case PROTOCOL_COMMAND_SET_NUM_MEASUREMENT:
+            handleSetNumMeasurementCommand(&frame);
+            break;
 
-    else if (memcmp(pCommand, setPulseCountCommand, SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE) == 0)
-    {
-        ESP_LOGI(TAG, "Set pulse count command is received");
-        handleSetPulseCountCommand(pCommand, postSizeInBytes);
-    }
-    else if ((memcmp(pCommand, resetPcntCommand, SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE) == 0)
-            && (postSizeInBytes == SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE))
-    {
-        ESP_LOGI(TAG, "Reset command is received");
-        handleResetPcntCommand();
-    }
-    else if ((memcmp(pCommand, pausePcntCommand, SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE) == 0)
-            && (postSizeInBytes == SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE))
-    {
-        ESP_LOGI(TAG, "Pause command is received");
-        handlePausePcntCommand();
-    }
-    else if ((memcmp(pCommand, resumePcntCommand, SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE) == 0)
-            && (postSizeInBytes == SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE))
-    {
-        ESP_LOGI(TAG, "Resume command is received");
-        handleResumePcntCommand();
-    }
+        case PROTOCOL_COMMAND_PULSE_GENERATOR:
+            handlePulseGeneratorCommand(&frame);
+            break;
+        case PROTOCOL_COMMAND_PULSE_GENERATOR_CONFIG:
+            handlePulseGeneratorConfigCommand(&frame);
+            break;
+        case PROTOCOL_COMMAND_PULSE_GENERATOR_CLEAR:
+            handlePulseGeneratorClearCommand();
+            break;
+        case PROTOCOL_COMMAND_PULSE_GENERATOR_ADD:
+            handlePulseGeneratorAddSegmentCommand(&frame);
+            break;
 
-    else if (memcmp(pCommand, setNumMeasurementCommand, SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE) == 0)
-    {
-        ESP_LOGI(TAG, "Set number of measurement command is received");
-        handleSetNumMeasurementCommand(pCommand, postSizeInBytes);
-    }
+        case PROTOCOL_COMMAND_SELF_TEST:
+            handleSelfTestCommand(&frame);
+            break;
 
-    else
-    {
-        ESP_LOGI(TAG, "Invalid command is received");
+        case PROTOCOL_COMMAND_TRIGGER_SOURCE:
+            handleTriggerSourceCommand(&frame);
+            break;
+        case PROTOCOL_COMMAND_MOVE:
+            handleMoveCommand(&frame);
+            break;
+        case PROTOCOL_COMMAND_MOVE_CONFIG:
+            handleMoveConfigCommand(&frame);
+            break;
+        case PROTOCOL_COMMAND_MOVE_CLEAR:
+            handleMoveClearCommand();
+            break;
+        case PROTOCOL_COMMAND_MOVE_ADD:
+            handleMoveAddSegmentCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_READ_TRIGGER_LOG:
+            handleReadTriggerLogCommand();
+            break;
+
+        case PROTOCOL_COMMAND_SCAN_PLAN:
+            handleScanPlanCommand(&frame);
+            break;
+        case PROTOCOL_COMMAND_SCAN_ROW_DIRECTION:
+            handleScanRowDirectionCommand(&frame);
+            break;
+        case PROTOCOL_COMMAND_SCAN_START:
+            handleScanStartCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_READ_HEALTH:
+            handleReadHealthCommand();
+            break;
+
+        case PROTOCOL_COMMAND_GLITCH_FILTER:
+            handleGlitchFilterCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_ANALYZE_SIGNAL:
+            handleAnalyzeSignalCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_COUNTER_MODE:
+            handleCounterModeCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_DRIFT_TEST:
+            handleDriftTestCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_TRIGGER_BURST:
+            handleTriggerBurstCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_TIME_SYNC:
+            handleTimeSyncCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_STREAM_TRIGGER_LOG:
+            handleStreamTriggerLogCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_PHYSICAL_SPACING:
+            handlePhysicalSpacingCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_INDEX_CODE:
+            handleIndexCodeCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_GATE:
+            handleGateCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_GATE_WINDOW:
+            handleGateWindowCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_CLOCK_EXCHANGE:
+            handleClockExchangeCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_TRIGGER_GRID:
+            handleTriggerGridCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_RESET_Y:
+            handleResetYCommand();
+            break;
+
+        case PROTOCOL_COMMAND_FLASH_LOG_RECORD:
+            handleFlashLogRecordCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_FLASH_LOG_LIST:
+            handleFlashLogListCommand();
+            break;
+
+        case PROTOCOL_COMMAND_FLASH_LOG_DUMP:
+            handleFlashLogDumpCommand(&frame);
+            break;
+
+        case PROTOCOL_COMMAND_FLASH_LOG_ERASE:
+            handleFlashLogEraseCommand();
+            break;
+
+        case PROTOCOL_COMMAND_PASS_CONFIG:
+            handlePassConfigCommand(&frame);
+            break;
+
+        default:
+            UART_COMMAND_LOGI(TAG, "Invalid command is received");
+            break;
     }
 }
 
@@ -180,49 +294,32 @@ void handleRadarTriggerCommand(void)
 {
     uart_evt_t evt;
     evt.command = UART_RADAR_TRIGGER_COMMAND;
-    xQueueSend(uart_evt_queue, &evt, 0 / portTICK_PERIOD_MS);
+    sendRadarTriggerEvent(&evt);
 }
 
 //-----------------------------------------------------------------------------
 // handle the set desired number of radar trigger command
 //-----------------------------------------------------------------------------
-void handleSetDesiredNumberOfTriggerCommand(const uint8_t* pCommand,
-                                        uint32_t postSizeInBytes)
+void handleSetDesiredNumberOfTriggerCommand(const protocol_frame_t* pFrame)
 {
-    /* Set the log level */
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
     static const char *TAG = "UART_SET_NUM_TRIGGER_COMMAND";
-    esp_log_level_set(TAG, ESP_LOG_INFO);
     
-    // Set the last character to NULL
-    char desiredTriggerParameter[5]; // Maximum 5 characters
-        
-    if((postSizeInBytes-SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE) <=5)
-    {
-        strncpy(desiredTriggerParameter,
-            (const char*)pCommand+SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE,
-            postSizeInBytes-SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE);
-    }
-    else {
-        ESP_LOGI(TAG, "Configuration parameter is too long");
-        return;
-    }
-        
     // Read the parameter
-    int desiredTrigger;
-    desiredTrigger = atoi(desiredTriggerParameter);
+    int desiredTrigger = pFrame->parameters[0];
      
     if (desiredTrigger > 0 )
     {
-        ESP_LOGI(TAG, "Current desired trigger value is: %d", desiredTrigger);
+        UART_COMMAND_LOGI(TAG, "Current desired trigger value is: %d", desiredTrigger);
         
         uart_evt_t evt;
         evt.command = UART_DESIRED_NUM_TRIGGER_COMMAND;
         evt.data = (uint32_t)desiredTrigger;
-        xQueueSend(uart_evt_queue, &evt, 0 / portTICK_PERIOD_MS);
+        sendRadarTriggerEvent(&evt);
     }
     else
     {
-        ESP_LOGI(TAG, "There is no valid configuration parameter in the command");
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
     }
 }
 
@@ -233,54 +330,29 @@ void handleClearNumberOfTriggerCommand(void)
 {
     uart_evt_t evt;
     evt.command = UART_CLEAR_NUM_TRIGGER_COMMAND;
-    xQueueSend(uart_evt_queue, &evt, 0 / portTICK_PERIOD_MS);
+    sendRadarTriggerEvent(&evt);
 }
 
 //-----------------------------------------------------------------------------
 // handle the set pulse count command
 //-----------------------------------------------------------------------------
-void handleSetPulseCountCommand(const uint8_t* pCommand,
-                                uint32_t postSizeInBytes)
+void handleSetPulseCountCommand(const protocol_frame_t* pFrame)
 {
-    /* Set the log level */
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
     static const char *TAG = "UART_SET_PULSE_COUNT_COMMAND";
-    esp_log_level_set(TAG, ESP_LOG_INFO);
 
-    // Set the last character to NULL
-    char pulseCountParameter[5]; // Maximum 5 characters for the int16_t
-        
-    if((postSizeInBytes-SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE) <=5)
-    {
-        strncpy(pulseCountParameter,
-            (const char*)pCommand+SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE,
-            postSizeInBytes-SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE);
-    }
-    else {
-        ESP_LOGI(TAG, "Configuration parameter is too long");
-        return;
-    }
-        
     // Read the parameter
-    int pcntThresholdNew;
-    pcntThresholdNew = atoi(pulseCountParameter);
+    int pcntThresholdNew = pFrame->parameters[0];
      
-    if (pcntThresholdNew > 0 )
+    if ((pcntThresholdNew > 0) && (pcntThresholdNew < PCNT_H_LIM_VAL))
     {
-        /* stop and clear the counter */
-        ESP_ERROR_CHECK(pcnt_unit_stop(pcnt_unit));
-        ESP_ERROR_CHECK(pcnt_unit_clear_count(pcnt_unit));
-
-        ESP_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit, pcntThreshold));
-        ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_unit, pcntThresholdNew));
-        ESP_LOGI(TAG, "Pulse counter threshold %d is changed to %d", pcntThreshold, pcntThresholdNew);
-        pcntThreshold = pcntThresholdNew;
-
-        /* start the counter */
-        ESP_ERROR_CHECK(pcnt_unit_start(pcnt_unit));
+        /* the counter keeps running, the new spacing starts at the next trigger */
+        UART_COMMAND_LOGI(TAG, "Pulse counter threshold %d is changed to %d", pcntGetThreshold(), pcntThresholdNew);
+        ESP_ERROR_CHECK(pcntUpdateThreshold(pcntThresholdNew));
     }
     else
     {
-        ESP_LOGI(TAG, "There is no valid configuration parameter in the command");
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
     }
 }
 
@@ -290,9 +362,9 @@ void handleSetPulseCountCommand(const uint8_t* pCommand,
 void handleResetPcntCommand(void)
 {
     /* stop, clear and resume to counting */
-    ESP_ERROR_CHECK(pcnt_unit_stop(pcnt_unit));
-    ESP_ERROR_CHECK(pcnt_unit_clear_count(pcnt_unit));
-    ESP_ERROR_CHECK(pcnt_unit_start(pcnt_unit));
+    pcntStop();
+    pcntClearCount();
+    pcntStart();
 }
 
 //-----------------------------------------------------------------------------
@@ -301,7 +373,7 @@ void handleResetPcntCommand(void)
 void handlePausePcntCommand(void)
 {
     /* stop the counting */
-    ESP_ERROR_CHECK(pcnt_unit_stop(pcnt_unit));
+    pcntStop();
 }
 
 //-----------------------------------------------------------------------------
@@ -310,43 +382,793 @@ void handlePausePcntCommand(void)
 void handleResumePcntCommand(void)
 {
     /* resume to counting */
-   ESP_ERROR_CHECK(pcnt_unit_start(pcnt_unit));
+    pcntStart();
 }
 
 //-----------------------------------------------------------------------------
 // handle the set number of measurements command
 //-----------------------------------------------------------------------------
-void handleSetNumMeasurementCommand(const uint8_t* pCommand,
-                                    uint32_t postSizeInBytes)
+void handleSetNumMeasurementCommand(const protocol_frame_t* pFrame)
 {
-    /* Set the log level */
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
     static const char *TAG = "UART_SET_NUM_MEAS_COMMAND";
-    esp_log_level_set(TAG, ESP_LOG_INFO);
 
-    // Set the last character to NULL
-    char numMeasurementParameter[5]; // Maximum 5 characters for the int16_t
-        
-    if((postSizeInBytes-SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE) <=5)
+    // Read the parameter
+    int32_t numMeasurement = pFrame->parameters[0];
+     
+    if (numMeasurement >= 0 )
+    {
+        /* a sequence only starts at a boundary, and the last pass must fit into the counter range */
+        if (numMeasurement != 0 && pcntGetPassBoundary() == PCNT_PASS_BOUNDARY_OFF)
+        {
+            sendPassError(RADAR_TRIGGER_PASS_ERROR_NO_BOUNDARY);
+            return;
+        }
+        if (numMeasurement != 0 && pcntCheckOffset((int64_t)(numMeasurement - 1) * passConfigOffset) != ESP_OK)
+        {
+            sendPassError(RADAR_TRIGGER_PASS_ERROR_OFFSET);
+            return;
+        }
+        passConfigPasses = numMeasurement;
+
+        /* the radar trigger task runs the passes (0: end the sequence) */
+        UART_COMMAND_LOGI(TAG, "Number of measurement value is: %ld", numMeasurement);
+        uart_evt_t evt;
+        evt.command = UART_NUM_MEASUREMENT_COMMAND;
+        evt.data = (uint32_t)numMeasurement;
+        sendRadarTriggerEvent(&evt);
+    }
+    else
     {
-        strncpy(numMeasurementParameter,
-            (const char*)pCommand+SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE,
-            postSizeInBytes-SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE);
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
     }
-    else {
-        ESP_LOGI(TAG, "Configuration parameter is too long");
+}
+
+//-----------------------------------------------------------------------------
+// handle the pulse generator start/stop command
+//-----------------------------------------------------------------------------
+void handlePulseGeneratorCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_PULSE_GENERATOR_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+
+    if (values[0] != 0)
+    {
+        esp_err_t err = pulseGeneratorStart(&testPulseGenerator);
+        UART_COMMAND_LOGI(TAG, "Pulse generator start: %s", esp_err_to_name(err));
+    }
+    else
+    {
+        pulseGeneratorStop(&testPulseGenerator);
+        UART_COMMAND_LOGI(TAG, "Pulse generator is stopped");
+    }
+}
+
+//-----------------------------------------------------------------------------
+// configure the profile limits of a pulse generator
+// (maximum frequency, jitter percent, repeat count)
+//-----------------------------------------------------------------------------
+static void configureProfile(pulse_generator_t* pGenerator,
+                            const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_PROFILE_CONFIG_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] < 0) || (values[1] < 0) || (values[2] < 0))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
         return;
     }
-        
-    // Read the parameter
-    uint16_t numMeasurement;
-    numMeasurement = atoi(numMeasurementParameter);
-     
-    if (numMeasurement > 0 )
+
+    esp_err_t err = pulseGeneratorConfigure(pGenerator, values[0], values[1], values[2]);
+    UART_COMMAND_LOGI(TAG, "Profile max frequency %ld Hz, jitter %ld%%, repeat %ld: %s",
+            values[0], values[1], values[2], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// clear the profile of a pulse generator
+//-----------------------------------------------------------------------------
+static void clearProfile(pulse_generator_t* pGenerator)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_PROFILE_CLEAR_COMMAND";
+
+    esp_err_t err = pulseGeneratorClearProfile(pGenerator);
+    UART_COMMAND_LOGI(TAG, "Profile clear: %s", esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// append a segment to the profile of a pulse generator
+// (type, number of pulses, frequency, acceleration/gap/dwell)
+//-----------------------------------------------------------------------------
+static void addProfileSegment(pulse_generator_t* pGenerator,
+                            const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_PROFILE_SEGMENT_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] < 0) || (values[1] < 0) || (values[2] < 0) || (values[3] < 0))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    pulse_segment_t segment = {
+        .type = (pulse_segment_type_t)values[0],
+        .numPulses = values[1],
+        .frequencyHz = values[2],
+        .parameter = values[3],
+    };
+    esp_err_t err = pulseGeneratorAddSegment(pGenerator, &segment);
+    UART_COMMAND_LOGI(TAG, "Profile segment %ld (%ld pulses at %ld Hz, %ld): %s",
+            values[0], values[1], values[2], values[3], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the pulse generator configuration command
+//-----------------------------------------------------------------------------
+void handlePulseGeneratorConfigCommand(const protocol_frame_t* pFrame)
+{
+    configureProfile(&testPulseGenerator, pFrame);
+}
+
+//-----------------------------------------------------------------------------
+// handle the pulse generator clear profile command
+//-----------------------------------------------------------------------------
+void handlePulseGeneratorClearCommand(void)
+{
+    clearProfile(&testPulseGenerator);
+}
+
+//-----------------------------------------------------------------------------
+// handle the pulse generator add segment command
+//-----------------------------------------------------------------------------
+void handlePulseGeneratorAddSegmentCommand(const protocol_frame_t* pFrame)
+{
+    addProfileSegment(&testPulseGenerator, pFrame);
+}
+
+//-----------------------------------------------------------------------------
+// handle the loopback self-test command
+// (start frequency, stop frequency, frequency step, pulses per step)
+//-----------------------------------------------------------------------------
+void handleSelfTestCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_SELF_TEST_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] <= 0) || (values[1] <= 0) || (values[2] <= 0) || (values[3] <= 0))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    self_test_config_t config = {
+        .startHz = values[0],
+        .stopHz = values[1],
+        .stepHz = values[2],
+        .numPulses = values[3],
+    };
+    esp_err_t err = selfTestStart(&config);
+    UART_COMMAND_LOGI(TAG, "Self-test from %ld Hz to %ld Hz: %s", values[0], values[1], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the trigger source command
+// (0: external encoder, 1: internal step generator)
+//-----------------------------------------------------------------------------
+void handleTriggerSourceCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_TRIGGER_SOURCE_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+
+    esp_err_t err = motionControlSetTriggerSource((pcnt_input_t)values[0]);
+    UART_COMMAND_LOGI(TAG, "Trigger source %ld: %s", values[0], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the move start/stop command
+//-----------------------------------------------------------------------------
+void handleMoveCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_MOVE_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+
+    if (values[0] != 0)
     {
-        ESP_LOGI(TAG, "Number of measurement value is: %u", numMeasurement);
+        esp_err_t err = motionControlStart();
+        UART_COMMAND_LOGI(TAG, "Move start: %s", esp_err_to_name(err));
     }
     else
     {
-        ESP_LOGI(TAG, "There is no valid configuration parameter in the command");
+        motionControlStop();
+        UART_COMMAND_LOGI(TAG, "Move is stopped");
+    }
+}
+
+//-----------------------------------------------------------------------------
+// handle the move configuration command
+//-----------------------------------------------------------------------------
+void handleMoveConfigCommand(const protocol_frame_t* pFrame)
+{
+    configureProfile(&motionPulseGenerator, pFrame);
+}
+
+//-----------------------------------------------------------------------------
+// handle the move clear profile command
+//-----------------------------------------------------------------------------
+void handleMoveClearCommand(void)
+{
+    clearProfile(&motionPulseGenerator);
+}
+
+//-----------------------------------------------------------------------------
+// handle the move add segment command
+//-----------------------------------------------------------------------------
+void handleMoveAddSegmentCommand(const protocol_frame_t* pFrame)
+{
+    addProfileSegment(&motionPulseGenerator, pFrame);
+}
+
+//-----------------------------------------------------------------------------
+// handle the read trigger log command
+//-----------------------------------------------------------------------------
+void handleReadTriggerLogCommand(void)
+{
+    char reply[128];
+    trigger_record_t record;
+    uint32_t numRecords = 0;
+
+    /* send every record in the log, the live stream takes them otherwise */
+    while (!triggerStreamIsEnabled() && triggerLogRead(&record))
+    {
+        numRecords++;
+        uint32_t delay_ns = (record.edgeTicks != 0) ? EDGE_CAPTURE_TICKS_TO_NS(record.triggerTicks - record.edgeTicks) : 0;
+        int length = snprintf(reply, sizeof(reply), "$TRG%lu,%ld,%lld,%lu,%lu,%lu,%lld,%ld#\r\n",
+                            record.index,
+                            record.position,
+                            record.time_us,
+                            record.edgeTicks,
+                            record.triggerTicks,
+                            delay_ns,
+                            record.syncTime_us,
+                            record.positionY);
+        transportSendReply(reply, length);
+    }
+
+    /* the end of the readout, also sent for an empty log */
+    int length = snprintf(reply, sizeof(reply), "$TRE%lu,%lu#\r\n", numRecords, triggerLogGetDropped());
+    transportSendReply(reply, length);
+}
+
+//-----------------------------------------------------------------------------
+// handle the scan plan command
+// (rows, triggers per row, pulses between triggers, settle time in ms, serpentine)
+//-----------------------------------------------------------------------------
+void handleScanPlanCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_SCAN_PLAN_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] <= 0) || (values[1] <= 0) || (values[2] <= 0) || (values[3] < 0))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
     }
+
+    esp_err_t err = scanPlanConfigure(values[0], values[1], values[2], values[3], values[4] != 0);
+    UART_COMMAND_LOGI(TAG, "Scan plan %ld rows x %ld triggers, %ld pulses, %ld ms: %s",
+            values[0], values[1], values[2], values[3], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the scan row direction command
+// (row, direction)
+//-----------------------------------------------------------------------------
+void handleScanRowDirectionCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_SCAN_ROW_DIRECTION_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] < 0) || (values[1] < 0))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    esp_err_t err = scanPlanSetRowDirection(values[0], (scan_direction_t)values[1]);
+    UART_COMMAND_LOGI(TAG, "Scan row %ld direction %ld: %s", values[0], values[1], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the scan start/abort command
+//-----------------------------------------------------------------------------
+void handleScanStartCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_SCAN_START_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+
+    if (values[0] != 0)
+    {
+        esp_err_t err = scanPlanStart();
+        UART_COMMAND_LOGI(TAG, "Scan start: %s", esp_err_to_name(err));
+    }
+    else
+    {
+        scanPlanAbort();
+        UART_COMMAND_LOGI(TAG, "Scan is aborted");
+    }
+}
+
+//-----------------------------------------------------------------------------
+// handle the read health command
+//-----------------------------------------------------------------------------
+void handleReadHealthCommand(void)
+{
+    static health_task_stats_t tasks[HEALTH_MAX_TASKS];
+    char reply[64];
+    int length;
+
+    /* queue fill levels and drops */
+    for (int queue = 0; queue < HEALTH_QUEUE_COUNT; queue++)
+    {
+        health_queue_stats_t stats;
+        healthGetQueueStatistics((health_queue_t)queue, &stats);
+        length = snprintf(reply, sizeof(reply), "$HQU%d,%lu,%lu,%lu#\r\n",
+                        queue, stats.capacity, stats.highWater, stats.dropped);
+        transportSendReply(reply, length);
+    }
+
+    /* interrupt counts */
+    for (int isr = 0; isr < HEALTH_ISR_COUNT; isr++)
+    {
+        length = snprintf(reply, sizeof(reply), "$HIS%d,%lu#\r\n",
+                        isr, healthGetIsrCount((health_isr_t)isr));
+        transportSendReply(reply, length);
+    }
+
+    /* stack high-water marks and CPU usage */
+    uint32_t numTasks = healthGetTaskStatistics(tasks, HEALTH_MAX_TASKS);
+    for (uint32_t i = 0; i < numTasks; i++)
+    {
+        length = snprintf(reply, sizeof(reply), "$HTK%s,%lu,%lu#\r\n",
+                        tasks[i].name, tasks[i].stackFree, tasks[i].cpuPermille);
+        transportSendReply(reply, length);
+    }
+
+    /* free heap */
+    health_heap_stats_t heap;
+    healthGetHeapStatistics(&heap);
+    length = snprintf(reply, sizeof(reply), "$HHP%lu,%lu,%lu#\r\n",
+                    heap.freeBytes, heap.minFreeBytes, heap.largestBlock);
+    transportSendReply(reply, length);
+
+    /* the end of the report */
+    length = snprintf(reply, sizeof(reply), "$HLE#\r\n");
+    transportSendReply(reply, length);
+}
+
+//-----------------------------------------------------------------------------
+// handle the glitch filter command
+// (maximum glitch width in ns, 0 disables the filter)
+//-----------------------------------------------------------------------------
+void handleGlitchFilterCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_GLITCH_FILTER_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] < 0) || (values[0] > PCNT_MAX_GLITCH_NS))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    /* the radar trigger and the encoder verification counters see the same input */
+    esp_err_t err = pcntSetGlitchFilter(values[0]);
+    if (err == ESP_OK)
+    {
+        err = motionControlSetGlitchFilter(values[0]);
+    }
+    UART_COMMAND_LOGI(TAG, "Glitch filter %ld ns: %s", values[0], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the analyze signal command
+// (number of edges, short width threshold in ns), 0 edges stops the analysis
+//-----------------------------------------------------------------------------
+void handleAnalyzeSignalCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_ANALYZE_SIGNAL_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] < 0) || (values[0] > SIGNAL_ANALYZER_MAX_EDGES) || (values[1] < 0))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    if (values[0] == 0)
+    {
+        signalAnalyzerStop();
+        UART_COMMAND_LOGI(TAG, "Signal analysis is stopped");
+        return;
+    }
+
+    esp_err_t err = signalAnalyzerStart(values[0], values[1]);
+    UART_COMMAND_LOGI(TAG, "Signal analysis of %ld edges: %s", values[0], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the counter mode command
+// (0: relative, the counter is cleared at every trigger, 1: absolute)
+//-----------------------------------------------------------------------------
+void handleCounterModeCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_COUNTER_MODE_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    esp_err_t err = pcntSetMode((pcnt_mode_t)values[0]);
+    UART_COMMAND_LOGI(TAG, "Counter mode %ld: %s", values[0], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the drift test command
+// (counting mode, pulses between triggers, number of triggers, pulse frequency)
+//-----------------------------------------------------------------------------
+void handleDriftTestCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_DRIFT_TEST_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] < 0) || (values[1] <= 0) || (values[2] <= 0) || (values[3] <= 0))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    self_test_drift_config_t config = {
+        .mode = (pcnt_mode_t)values[0],
+        .spacing = values[1],
+        .numTriggers = values[2],
+        .frequencyHz = values[3],
+    };
+    esp_err_t err = selfTestStartDrift(&config);
+    UART_COMMAND_LOGI(TAG, "Drift test of %ld triggers in mode %ld: %s", values[2], values[0], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the trigger burst command
+// (pulses per pulse counter trigger, interval between the pulses in us)
+//-----------------------------------------------------------------------------
+void handleTriggerBurstCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_TRIGGER_BURST_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] <= 0) || (values[1] < 0))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    esp_err_t err = radarTriggerSetBurst(values[0], values[1]);
+    UART_COMMAND_LOGI(TAG, "Trigger burst of %ld pulses every %ld us: %s", values[0], values[1], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the time sync command
+// (0: off, 1: master, 2: slave, sync pulse rate in Hz)
+//-----------------------------------------------------------------------------
+void handleTimeSyncCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_TIME_SYNC_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] < TIME_SYNC_OFF) || (values[0] >= TIME_SYNC_MODE_COUNT) || (values[1] <= 0))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    esp_err_t err = timeSyncStart((time_sync_mode_t)values[0], values[1]);
+    UART_COMMAND_LOGI(TAG, "Time sync mode %ld at %ld Hz: %s", values[0], values[1], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the trigger log stream command
+// (1: stream the trigger log as compressed blocks, 0: stop)
+//-----------------------------------------------------------------------------
+void handleStreamTriggerLogCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_STREAM_TRIGGER_LOG_COMMAND";
+
+    int enable = pFrame->parameters[0];
+    if ((enable != 0) && (enable != 1))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    triggerStreamEnable(enable == 1);
+    UART_COMMAND_LOGI(TAG, "Trigger log stream is %s", enable ? "started" : "stopped");
+}
+
+//-----------------------------------------------------------------------------
+// handle the physical spacing command
+// (encoder pulses per m, trigger spacing in um)
+//-----------------------------------------------------------------------------
+void handlePhysicalSpacingCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_PHYSICAL_SPACING_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    char reply[48];
+    int length;
+    if ((values[0] <= 0) || (values[1] <= 0))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        length = snprintf(reply, sizeof(reply), "$SPX%d#\r\n", PCNT_SPACING_ERROR_RANGE);
+        transportSendReply(reply, length);
+        return;
+    }
+
+    pcnt_spacing_info_t info;
+    esp_err_t err = pcntSetPhysicalSpacing(values[0], values[1], &info);
+    if (err != ESP_OK)
+    {
+        UART_COMMAND_LOGI(TAG, "Spacing %ld um at %ld pulses/m: %s", values[1], values[0], esp_err_to_name(err));
+        pcnt_spacing_error_t error = (err == ESP_ERR_INVALID_STATE) ? PCNT_SPACING_ERROR_MODE : PCNT_SPACING_ERROR_RANGE;
+        length = snprintf(reply, sizeof(reply), "$SPX%d#\r\n", error);
+        transportSendReply(reply, length);
+        return;
+    }
+
+    /* the mean spacing and the worst-case position error of a trigger */
+    length = snprintf(reply, sizeof(reply), "$SPR%lu,%lu#\r\n", info.spacing_mpulses, info.maxError_nm);
+    transportSendReply(reply, length);
+}
+
+//-----------------------------------------------------------------------------
+// handle the index code command
+// (1: enable, 0: disable, baud rate)
+//-----------------------------------------------------------------------------
+void handleIndexCodeCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_INDEX_CODE_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] != 0 && values[0] != 1) || (values[1] < 0))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    esp_err_t err = indexCodeConfigure(values[0] == 1, values[1]);
+    UART_COMMAND_LOGI(TAG, "Index code %ld at %ld baud: %s", values[0], values[1], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the gate command
+// (0: off, 1: hold the count, 2: suppress the triggers, active level)
+//-----------------------------------------------------------------------------
+void handleGateCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_GATE_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] < 0) || (values[0] >= PCNT_GATE_MODE_COUNT) || (values[1] != 0 && values[1] != 1))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    esp_err_t err = pcntSetGate((pcnt_gate_mode_t)values[0], values[1]);
+    UART_COMMAND_LOGI(TAG, "Gate mode %ld, active level %ld: %s", values[0], values[1], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the gate window command
+// (first and last trigger position, 0,0: no window)
+//-----------------------------------------------------------------------------
+void handleGateWindowCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_GATE_WINDOW_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    esp_err_t err = radarTriggerSetWindow(values[0], values[1]);
+    if (err != ESP_OK)
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    radar_trigger_stats_t stats;
+    radarTriggerGetStatistics(&stats);
+    UART_COMMAND_LOGI(TAG, "Trigger window %ld to %ld, %lu watch points gated so far", values[0], values[1], stats.numGated);
+}
+
+//-----------------------------------------------------------------------------
+// handle the clock exchange command
+// (a tag of the host, replied with the receive and transmit times of the device)
+//-----------------------------------------------------------------------------
+void handleClockExchangeCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_CLOCK_EXCHANGE_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if (values[0] < 0)
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    /* the transmit time is taken last, right before the reply is handed to the transport */
+    char reply[64];
+    int64_t receiveTime_us = transportGetReceiveTime();
+    int length = snprintf(reply, sizeof(reply), "$HCR%ld,%lld,%lld#\r\n", values[0], receiveTime_us, esp_timer_get_time());
+    transportSendReply(reply, length);
+}
+
+//-----------------------------------------------------------------------------
+// handle the trigger grid command
+// (origin, pitch and number of points of X and Y, row tolerance; 0 points: no grid)
+//-----------------------------------------------------------------------------
+void handleTriggerGridCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_TRIGGER_GRID_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    radar_trigger_grid_t grid = {
+        .originX = values[0],
+        .originY = values[1],
+        .pitchX = values[2],
+        .pitchY = values[3],
+        .numX = (values[4] > 0) ? values[4] : 0,
+        .numY = (values[5] > 0) ? values[5] : 0,
+        .toleranceY = values[6],
+    };
+    esp_err_t err = radarTriggerSetGrid(&grid);
+    if (err != ESP_OK)
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    if (grid.numX == 0)
+    {
+        UART_COMMAND_LOGI(TAG, "Trigger grid is off");
+        return;
+    }
+    UART_COMMAND_LOGI(TAG, "Trigger grid %lu x %lu from (%ld, %ld), pitch (%ld, %ld), row tolerance %ld",
+            grid.numX, grid.numY, grid.originX, grid.originY, grid.pitchX, grid.pitchY, grid.toleranceY);
+}
+
+//-----------------------------------------------------------------------------
+// handle the Y axis reset command
+//-----------------------------------------------------------------------------
+void handleResetYCommand(void)
+{
+    pcntYClearPosition();
+}
+
+//-----------------------------------------------------------------------------
+// handle the flash log record command
+// (1: start a new scan, 0: stop recording)
+//-----------------------------------------------------------------------------
+void handleFlashLogRecordCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_FLASH_LOG_RECORD_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] != 0) && (values[0] != 1))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    esp_err_t err = flashLogRecord(values[0] == 1);
+    UART_COMMAND_LOGI(TAG, "Flash log recording %s: %s", values[0] ? "started" : "stopped", esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the flash log list command
+//-----------------------------------------------------------------------------
+void handleFlashLogListCommand(void)
+{
+    flashLogSendList();
+}
+
+//-----------------------------------------------------------------------------
+// handle the flash log dump command
+//-----------------------------------------------------------------------------
+void handleFlashLogDumpCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_FLASH_LOG_DUMP_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if (values[0] < 0)
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        char reply[40];
+        int length = snprintf(reply, sizeof(reply), "$FDE%ld,0,0#\r\n", values[0]);
+        transportSendReply(reply, length);
+        return;
+    }
+
+    esp_err_t err = flashLogDump(values[0]);
+    UART_COMMAND_LOGI(TAG, "Flash log dump of scan %ld: %s", values[0], esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the flash log erase command
+//-----------------------------------------------------------------------------
+void handleFlashLogEraseCommand(void)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_FLASH_LOG_ERASE_COMMAND";
+
+    esp_err_t err = flashLogErase();
+    UART_COMMAND_LOGI(TAG, "Flash log erase: %s", esp_err_to_name(err));
+}
+
+//-----------------------------------------------------------------------------
+// handle the multi-pass configuration command
+// (pass boundary: 0 off, 1 rising, 2 falling, 3 every reversal; offset per pass in pulses)
+//-----------------------------------------------------------------------------
+void handlePassConfigCommand(const protocol_frame_t* pFrame)
+{
+    /* The command log, compiled out unless UART_COMMAND_LOG is defined */
+    static const char *TAG = "UART_PASS_CONFIG_COMMAND";
+
+    const int32_t* values = pFrame->parameters;
+    if ((values[0] < 0) || (values[0] >= PCNT_PASS_BOUNDARY_COUNT) || (values[1] < 0) || (values[1] >= PCNT_H_LIM_VAL)
+        || (values[1] != 0 && pcntGetMode() != PCNT_MODE_ABSOLUTE))
+    {
+        UART_COMMAND_LOGI(TAG, "There is no valid configuration parameter in the command");
+        return;
+    }
+
+    /* the last pass of the armed number of passes shifts the first trigger the most */
+    int32_t lastPass = (passConfigPasses > 0) ? passConfigPasses - 1 : 0;
+    if (pcntCheckOffset(values[1]) != ESP_OK || pcntCheckOffset((int64_t)lastPass * values[1]) != ESP_OK)
+    {
+        sendPassError(RADAR_TRIGGER_PASS_ERROR_OFFSET);
+        return;
+    }
+    passConfigOffset = values[1];
+
+    ESP_ERROR_CHECK(pcntSetPassBoundary(values[0]));
+    uart_evt_t evt;
+    evt.command = UART_PASS_OFFSET_COMMAND;
+    evt.data = (uint32_t)values[1];
+    sendRadarTriggerEvent(&evt);
+    UART_COMMAND_LOGI(TAG, "Pass boundary %ld, offset %ld pulses per pass", values[0], values[1]);
 }
\ No newline at end of file
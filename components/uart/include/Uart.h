@@ -35,6 +35,9 @@
 // Uart RX and TX buffer size
 #define UART_BUFFER_SIZE 	1024
 
+// Priority of the UART task (the radar trigger task runs at 5)
+#define UART_TASK_PRIORITY	4
+
 // Define following to set the UART debug port (Use UART_NUM_2)
 // #define UART_DEBUG_MODE
 
@@ -43,7 +46,21 @@
 	#define UART_DATA_TXD_PIN (GPIO_NUM_17)
 #endif
 
+// Define following to log every command on the console (UART1, TX on GPIO22, see sdkconfig).
+// The log never shares the protocol port, but a command then waits for its log line at the
+// console baud rate, so it stays compiled out of the command handlers by default
+// #define UART_COMMAND_LOG
+
+#ifdef UART_COMMAND_LOG
+	#define UART_COMMAND_LOGI(tag, format, ...)	ESP_LOGI(tag, format, ##__VA_ARGS__)
+#else
+	#define UART_COMMAND_LOGI(tag, format, ...)	do { if (0) { ESP_LOGI(tag, format, ##__VA_ARGS__); } } while (0)
+#endif
+
 // Initialize the UART Communication
 void uartInitialize(void);
 
+// Send data to the host PC
+int sendUartData(const char* data, uint32_t length);
+
 #endif
\ No newline at end of file
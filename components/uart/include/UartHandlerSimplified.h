@@ -26,14 +26,7 @@
 #define UART_HANDLER_SIMPLIFIED_H
 
 #include <stdio.h>
-
-
-//-----------------------------------------------------------------------------
-//  Define simplified protocol version variables
-//-----------------------------------------------------------------------------
-#define SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE		3   // in bytes
-#define SIMPLIFIED_UART_PROTOCOL_OVERHEAD_SIZE		2   // in bytes ($ and #)
-#define SIMPLIFIED_UART_PROTOCOL_MIN_PACKET_SIZE	(SIMPLIFIED_UART_PROTOCOL_COMMAND_SIZE + SIMPLIFIED_UART_PROTOCOL_OVERHEAD_SIZE)
+#include <Protocol.h>
 
 
 //-----------------------------------------------------------------------------
@@ -56,8 +49,7 @@ void handleRadarTriggerCommand(void);
 //-----------------------------------------------------------------------------
 // handle the set desired number of radar trigger command
 //-----------------------------------------------------------------------------
-void handleSetDesiredNumberOfTriggerCommand(const uint8_t* pCommand,
-                                		uint32_t postSizeInBytes);
+void handleSetDesiredNumberOfTriggerCommand(const protocol_frame_t* pFrame);
 
 //-----------------------------------------------------------------------------
 // handle the clear number of radar trigger command
@@ -67,8 +59,7 @@ void handleClearNumberOfTriggerCommand(void);
 //-----------------------------------------------------------------------------
 // handle the set pulse count command
 //-----------------------------------------------------------------------------
-void handleSetPulseCountCommand(const uint8_t* pCommand,
-                                uint32_t postSizeInBytes);
+void handleSetPulseCountCommand(const protocol_frame_t* pFrame);
 
 //-----------------------------------------------------------------------------
 // handle the reset command
@@ -88,7 +79,176 @@ void handleResumePcntCommand(void);
 //-----------------------------------------------------------------------------
 // handle the set number of measurements command
 //-----------------------------------------------------------------------------
-void handleSetNumMeasurementCommand(const uint8_t* pCommand,
-                                	uint32_t postSizeInBytes);
+void handleSetNumMeasurementCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the pulse generator start/stop command
+//-----------------------------------------------------------------------------
+void handlePulseGeneratorCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the pulse generator configuration command
+//-----------------------------------------------------------------------------
+void handlePulseGeneratorConfigCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the pulse generator clear profile command
+//-----------------------------------------------------------------------------
+void handlePulseGeneratorClearCommand(void);
+
+//-----------------------------------------------------------------------------
+// handle the pulse generator add segment command
+//-----------------------------------------------------------------------------
+void handlePulseGeneratorAddSegmentCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the loopback self-test command
+//-----------------------------------------------------------------------------
+void handleSelfTestCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the trigger source command
+//-----------------------------------------------------------------------------
+void handleTriggerSourceCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the move start/stop command
+//-----------------------------------------------------------------------------
+void handleMoveCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the move configuration command
+//-----------------------------------------------------------------------------
+void handleMoveConfigCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the move clear profile command
+//-----------------------------------------------------------------------------
+void handleMoveClearCommand(void);
+
+//-----------------------------------------------------------------------------
+// handle the move add segment command
+//-----------------------------------------------------------------------------
+void handleMoveAddSegmentCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the read trigger log command
+//-----------------------------------------------------------------------------
+void handleReadTriggerLogCommand(void);
+
+//-----------------------------------------------------------------------------
+// handle the scan plan command
+//-----------------------------------------------------------------------------
+void handleScanPlanCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the scan row direction command
+//-----------------------------------------------------------------------------
+void handleScanRowDirectionCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the scan start/abort command
+//-----------------------------------------------------------------------------
+void handleScanStartCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the read health command
+//-----------------------------------------------------------------------------
+void handleReadHealthCommand(void);
+
+//-----------------------------------------------------------------------------
+// handle the glitch filter command
+//-----------------------------------------------------------------------------
+void handleGlitchFilterCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the analyze signal command
+//-----------------------------------------------------------------------------
+void handleAnalyzeSignalCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the counter mode command
+//-----------------------------------------------------------------------------
+void handleCounterModeCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the drift test command
+//-----------------------------------------------------------------------------
+void handleDriftTestCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the trigger burst command
+//-----------------------------------------------------------------------------
+void handleTriggerBurstCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the time sync command
+//-----------------------------------------------------------------------------
+void handleTimeSyncCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the trigger log stream command
+//-----------------------------------------------------------------------------
+void handleStreamTriggerLogCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the physical spacing command
+//-----------------------------------------------------------------------------
+void handlePhysicalSpacingCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the index code command
+//-----------------------------------------------------------------------------
+void handleIndexCodeCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the gate command
+//-----------------------------------------------------------------------------
+void handleGateCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the gate window command
+//-----------------------------------------------------------------------------
+void handleGateWindowCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the clock exchange command
+//-----------------------------------------------------------------------------
+void handleClockExchangeCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the trigger grid command
+//-----------------------------------------------------------------------------
+void handleTriggerGridCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the Y axis reset command
+//-----------------------------------------------------------------------------
+void handleResetYCommand(void);
+
+//-----------------------------------------------------------------------------
+// handle the flash log record command
+//-----------------------------------------------------------------------------
+void handleFlashLogRecordCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the flash log list command
+//-----------------------------------------------------------------------------
+void handleFlashLogListCommand(void);
+
+//-----------------------------------------------------------------------------
+// handle the flash log dump command
+//-----------------------------------------------------------------------------
+void handleFlashLogDumpCommand(const protocol_frame_t* pFrame);
+
+//-----------------------------------------------------------------------------
+// handle the flash log erase command
+//-----------------------------------------------------------------------------
+void handleFlashLogEraseCommand(void);
+
+//-----------------------------------------------------------------------------
+// handle the multi-pass configuration command
+//-----------------------------------------------------------------------------
+void handlePassConfigCommand(const protocol_frame_t* pFrame);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+/*
+  Module Name:
+
+	protocol_fuzz.cpp
+
+  Abstract:
+
+	The libFuzzer harness of the packet parser, it checks that every accepted packet
+	names its command and parses again to the same frame when it is written back
+	Usage: sarsync_protocol_fuzz [libFuzzer options] fuzz/corpus
+	Built without libFuzzer (SARSYNC_FUZZ_REPLAY), it runs the given files or directories once
+*/
+
+#include <Protocol.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef SARSYNC_FUZZ_REPLAY
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#endif
+
+static void check(bool condition)
+{
+    if (!condition) {
+        __builtin_trap();
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    protocol_frame_t frame;
+    uint32_t sizeInBytes = (size > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(size);
+    if (protocolParseFrame(data, sizeInBytes, &frame) != PROTOCOL_OK) {
+        return 0;
+    }
+
+    /* the frame names a command of the table with its parameters */
+    check(static_cast<unsigned>(frame.command) < PROTOCOL_COMMAND_COUNT);
+    check(frame.numParameters >= 0 && frame.numParameters <= PROTOCOL_MAX_PARAMETERS);
+    check(std::memcmp(data + 1, protocolCommandName(frame.command), PROTOCOL_COMMAND_SIZE) == 0);
+
+    /* written back without leading zeros it is the same frame */
+    std::string packet = std::string(1, PROTOCOL_START_SYMBOL) + protocolCommandName(frame.command);
+    for (int i = 0; i < frame.numParameters; i++) {
+        packet += ((i == 0) ? "" : ",") + std::to_string(frame.parameters[i]);
+    }
+    packet += PROTOCOL_STOP_SYMBOL;
+
+    protocol_frame_t again;
+    check(protocolParseFrame(reinterpret_cast<const uint8_t*>(packet.data()), packet.size(), &again) == PROTOCOL_OK);
+    check(again.command == frame.command && again.numParameters == frame.numParameters);
+    check(std::memcmp(again.parameters, frame.parameters, frame.numParameters * sizeof(int32_t)) == 0);
+    return 0;
+}
+
+#ifdef SARSYNC_FUZZ_REPLAY
+static int replayFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    int numInputs = 0;
+    for (int i = 1; i < argc; i++) {
+        std::filesystem::path path(argv[i]);
+        if (std::filesystem::is_directory(path)) {
+            for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                if (entry.is_regular_file()) {
+                    numInputs += replayFile(entry.path());
+                }
+            }
+        }
+        else {
+            numInputs += replayFile(path);
+        }
+    }
+    std::printf("%d inputs replayed\n", numInputs);
+    return 0;
+}
+#endif
\ No newline at end of file
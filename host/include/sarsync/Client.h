@@ -0,0 +1,141 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	Client.h
+
+  Abstract:
+
+	The asynchronous host client of the synchronizer
+*/
+
+#ifndef SARSYNC_CLIENT_H
+#define SARSYNC_CLIENT_H
+
+#include <sarsync/Frame.h>
+#include <sarsync/SerialPort.h>
+#include <sarsync/TriggerLog.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace sarsync {
+
+/* Traffic counters of a client */
+struct ClientStatistics {
+	uint64_t bytesSent = 0;
+	uint64_t bytesReceived = 0;
+	uint64_t bytesSkipped = 0;		// ROM boot message and malformed frames
+	uint64_t replyFrames = 0;
+	uint64_t eventFrames = 0;
+};
+
+/*
+	A client owns an I/O thread that writes the queued commands and splits the received bytes into frames.
+	Commands are pipelined: send() and query() only queue the frame and return at once.
+	The device answers the queries in order, so every reply frame belongs to the oldest open query;
+	every other frame is an event ($MVD, $ROC, $STR, $DRP, ...) and goes to the event handler.
+	The handlers run on the I/O thread and must not block.
+*/
+class Client {
+public:
+	using Reply = std::vector<Frame>;
+	using ReplyHandler = std::function<void(Reply)>;
+	using EventHandler = std::function<void(const Frame&)>;
+	using QueryId = uint64_t;
+
+	/* Open the device and start the I/O thread, throws std::system_error */
+	explicit Client(const std::string& devicePath, int baudRate = 115200);
+	~Client();
+
+	Client(const Client&) = delete;
+	Client& operator=(const Client&) = delete;
+
+	/* Set the handler of the asynchronous events (before the first command) */
+	void setEventHandler(EventHandler handler);
+
+	/* Queue a command without a reply */
+	void send(const std::string& command, std::initializer_list<int64_t> parameters = {});
+
+	/* Queue a command whose reply is made of replyCommands frames and ends with an endCommand frame */
+	QueryId query(const std::string& command, std::initializer_list<int64_t> parameters,
+			std::vector<std::string> replyCommands, std::string endCommand, ReplyHandler handler);
+	std::future<Reply> query(const std::string& command, std::initializer_list<int64_t> parameters,
+			std::vector<std::string> replyCommands, std::string endCommand);
+
+	/*
+		Drop an open query whose reply did not come in time, so the next replies go to the next queries.
+		Its handler is not called; returns false when the query has already completed.
+		A reply that comes after all the same goes to the next query with the same endCommand
+	*/
+	bool cancel(QueryId id);
+
+	/* Wait until every queued byte is written */
+	void flush();
+
+	/* Frequently used commands */
+	void trigger()								{ send("RTG"); }
+	void clearTriggers()						{ send("CTG"); }
+	void setPulseCount(int32_t pulses)			{ send("PLS", {pulses}); }
+	void resetCounter()							{ send("RST"); }
+	void pauseCounter()							{ send("PAU"); }
+	void resumeCounter()						{ send("RES"); }
+	void streamTriggerLog(bool enable)			{ send("LGS", {enable ? 1 : 0}); }
+	std::future<TriggerLog> readTriggerLog();
+	std::future<Reply> readHealth();
+	void recordFlashLog(bool enable)			{ send("FLR", {enable ? 1 : 0}); }
+	std::future<Reply> listFlashLog();
+	std::future<TriggerLog> readFlashLog(uint16_t scanId);
+
+	ClientStatistics statistics() const;
+
+private:
+	struct PendingQuery {
+		QueryId id = 0;
+		std::vector<std::string> replyCommands;
+		std::string endCommand;
+		ReplyHandler handler;
+		Reply reply;
+	};
+
+	SerialPort port_;
+	int wakePipe_[2];
+	std::thread thread_;
+	std::atomic<bool> running_{true};
+
+	mutable std::mutex mutex_;
+	std::condition_variable flushed_;
+	std::string txBuffer_;
+	std::deque<PendingQuery> pending_;
+	EventHandler eventHandler_;
+	ClientStatistics statistics_;
+	QueryId nextQueryId_ = 1;
+	bool failed_ = false;
+
+	QueryId enqueue(const std::string& frame, PendingQuery* pQuery);
+	void wake();
+	void ioLoop();
+	void dispatch(Frame& frame);
+	void fail();
+};
+
+} // namespace sarsync
+
+#endif
\ No newline at end of file
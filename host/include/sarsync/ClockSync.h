@@ -0,0 +1,127 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	ClockSync.h
+
+  Abstract:
+
+	Maps the device time of the trigger records to the host wall clock
+	with an NTP style exchange over the command channel
+*/
+
+#ifndef SARSYNC_CLOCK_SYNC_H
+#define SARSYNC_CLOCK_SYNC_H
+
+#include <sarsync/Client.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace sarsync {
+
+/* A clock exchange: $HCK<tag># sent at hostSend, $HCR<tag>,<deviceReceive>,<deviceTransmit># received at hostReceive */
+struct ClockSample {
+	int64_t hostSend_us;		// host wall clock (system_clock) when the command was queued
+	int64_t deviceReceive_us;	// device time (esp_timer) when the command was received
+	int64_t deviceTransmit_us;	// device time when the reply was sent
+	int64_t hostReceive_us;		// host wall clock when the reply was received
+
+	/* The time on the link, without the time spent on the device */
+	int64_t roundTrip_us() const { return (hostReceive_us - hostSend_us) - (deviceTransmit_us - deviceReceive_us); }
+
+	/* Device time minus host time, exact if both directions take the same time */
+	double offset_us() const { return ((deviceReceive_us - hostSend_us) + (deviceTransmit_us - hostReceive_us)) / 2.0; }
+};
+
+/* The mapping of the device time to the host wall clock */
+struct ClockEstimate {
+	bool valid = false;
+	int64_t deviceReference_us = 0;		// device time of the newest sample
+	double offset_us = 0.0;				// device time minus host time at the reference
+	double drift_ppm = 0.0;				// rate of the device clock relative to the host (positive: runs fast)
+	int64_t maxError_us = 0;			// half of the shortest round trip, the error bound of an asymmetric link
+	size_t numSamples = 0;				// samples in the window
+};
+
+/*
+	Estimates the offset and the drift of the device clock from the clock exchanges.
+	The offset of a sample is off by at most half of its round trip (the delays of the two directions
+	are unknown), so only the samples with the shortest round trips of a window are used and a line
+	is fitted through their offsets over the device time; its slope is the drift.
+*/
+class ClockEstimator {
+public:
+	explicit ClockEstimator(size_t windowSize = 64) : windowSize_(windowSize) {}
+
+	/* Add an exchange and update the estimate */
+	void addSample(const ClockSample& sample);
+
+	const ClockEstimate& estimate() const { return estimate_; }
+
+	/* Map a device time to the host wall clock, returns false until the first sample */
+	bool toHostTime(int64_t deviceTime_us, int64_t& hostTime_us) const;
+
+	void reset();
+
+private:
+	size_t windowSize_;
+	std::deque<ClockSample> samples_;
+	ClockEstimate estimate_;
+};
+
+/*
+	Runs a clock exchange on a client every period, from its own thread, and keeps the estimate.
+	The exchanges are pipelined with the other commands like any query, so they can run during a scan.
+*/
+class ClockSync {
+public:
+	explicit ClockSync(Client& client, std::chrono::milliseconds period = std::chrono::milliseconds(1000), size_t windowSize = 64);
+	~ClockSync();
+
+	ClockSync(const ClockSync&) = delete;
+	ClockSync& operator=(const ClockSync&) = delete;
+
+	/* Run a single exchange and wait for it, returns false if the device did not answer in time */
+	bool exchange(std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+
+	ClockEstimate estimate() const;
+
+	/* Map a device time (time_us of a trigger record) to the host wall clock in us since the epoch */
+	bool toHostTime(int64_t deviceTime_us, int64_t& hostTime_us) const;
+
+private:
+	Client& client_;
+	std::chrono::milliseconds period_;
+	mutable std::mutex mutex_;
+	std::condition_variable stop_;
+	bool running_ = true;
+	uint32_t nextTag_ = 0;
+	ClockEstimator estimator_;
+	std::thread thread_;
+
+	void run();
+};
+
+/* The host wall clock in us since the epoch */
+int64_t hostNow_us();
+
+} // namespace sarsync
+
+#endif
\ No newline at end of file
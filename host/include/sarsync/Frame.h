@@ -0,0 +1,72 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	Frame.h
+
+  Abstract:
+
+	The host side framing of the simplified protocol
+*/
+
+#ifndef SARSYNC_FRAME_H
+#define SARSYNC_FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace sarsync {
+
+/* A frame of the simplified protocol: $<command><field>,<field>,...# */
+struct Frame {
+	std::string command;				// three upper case letters
+	std::vector<std::string> fields;	// comma separated fields (integers, task names)
+
+	/* A field as an integer, throws std::invalid_argument or std::out_of_range */
+	int64_t integer(size_t index) const;
+};
+
+/* Format a command frame, e.g. formatCommand("PLS", {10}) is "$PLS10#" */
+std::string formatCommand(const std::string& command, std::initializer_list<int64_t> parameters = {});
+
+/*
+	Splits a received byte stream into frames
+	Bytes outside of $...# (the diagnostic log of the firmware) and malformed frames are skipped
+*/
+class FrameParser {
+public:
+	explicit FrameParser(size_t maxFrameSize = 512);
+
+	/* Feed received bytes and append the complete frames */
+	void feed(const char* data, size_t size, std::vector<Frame>& frames);
+
+	/* Number of bytes skipped so far */
+	uint64_t skippedBytes() const { return skipped_; }
+
+private:
+	std::string buffer_;
+	bool inFrame_ = false;
+	size_t maxFrameSize_;
+	uint64_t skipped_ = 0;
+
+	void finishFrame(std::vector<Frame>& frames);
+};
+
+} // namespace sarsync
+
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SerialPort.h
+
+  Abstract:
+
+	A non-blocking raw serial port (a USB UART or a pseudo terminal)
+*/
+
+#ifndef SARSYNC_SERIAL_PORT_H
+#define SARSYNC_SERIAL_PORT_H
+
+#include <cstddef>
+#include <string>
+#include <sys/types.h>
+
+namespace sarsync {
+
+class SerialPort {
+public:
+	/* Open the device in raw 8N1 mode, throws std::system_error */
+	SerialPort(const std::string& devicePath, int baudRate);
+	~SerialPort();
+
+	SerialPort(const SerialPort&) = delete;
+	SerialPort& operator=(const SerialPort&) = delete;
+
+	/* The file descriptor to poll */
+	int fd() const { return fd_; }
+
+	/* Read or write what is possible without blocking, returns the number of bytes (0: would block) */
+	size_t readSome(char* data, size_t size);
+	size_t writeSome(const char* data, size_t size);
+
+private:
+	int fd_;
+};
+
+} // namespace sarsync
+
+#endif
\ No newline at end of file
@@ -0,0 +1,135 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+/*
+  Module Name:
+
+	Simulator.h
+
+  Abstract:
+
+	A synchronizer simulated on a pseudo terminal, for testing host software without a board
+*/
+
+#ifndef SARSYNC_SIMULATOR_H
+#define SARSYNC_SIMULATOR_H
+
+#include <sarsync/TriggerLog.h>
+
+#include <SyncDiscipline.h>
+#include <TriggerCodec.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sarsync {
+
+/* The sync pulse wire between simulated boards, the master posts the rising edges in real time */
+class SyncLine {
+public:
+	void post(std::chrono::steady_clock::time_point edge);
+
+	/* Append the edges after the first `from` ones, returns the number of edges posted so far */
+	size_t read(size_t from, std::vector<std::chrono::steady_clock::time_point>& edges) const;
+
+private:
+	mutable std::mutex mutex_;
+	std::vector<std::chrono::steady_clock::time_point> edges_;
+};
+
+/*
+	The simulator parses the commands with the firmware's protocol library and answers like the firmware:
+	RTG, DTG, CTG, PLS, RST, PAU, RES, GEN, PGF, SYN, LOG, LGS, HLT and HCK are modelled, the other commands are accepted silently.
+	The pulse generator advances the counter in real time, every spacing pulses make a trigger record.
+	Only the ROM boot message comes before the frames, the firmware's ESP log is on another UART.
+	SYN runs the time sync of the firmware on a shared sync line, each board with its own clock error,
+	and the trigger records carry the sync time.
+*/
+class Simulator {
+public:
+	/* Open the pseudo terminal and start the device thread, throws std::system_error */
+	explicit Simulator(std::shared_ptr<SyncLine> syncLine = nullptr, double clockDrift_ppm = 0.0, int64_t clockOffset_us = 0);
+	~Simulator();
+
+	Simulator(const Simulator&) = delete;
+	Simulator& operator=(const Simulator&) = delete;
+
+	/* The device path to open with Client or SerialPort */
+	const std::string& devicePath() const { return devicePath_; }
+
+private:
+	static constexpr size_t kLogCapacity = 256;
+
+	int master_;
+	int slave_;
+	std::string devicePath_;
+	std::thread thread_;
+	std::atomic<bool> running_{true};
+	std::chrono::steady_clock::time_point start_;
+
+	/* device state, only touched by the device thread */
+	std::string rxFrame_;
+	std::string txBuffer_;
+	int32_t spacing_ = 10;
+	int32_t count_ = 0;
+	bool counting_ = true;
+	int32_t position_ = 0;
+	uint32_t numberOfTrigger_ = 0;
+	std::deque<TriggerRecord> log_;
+	uint32_t dropped_ = 0;
+	bool generating_ = false;
+	uint32_t generatorHz_ = 100000;
+	double generatorNextPulse_us_ = 0.0;
+	uint32_t numIsr_ = 0;
+
+	/* time sync */
+	std::shared_ptr<SyncLine> syncLine_;
+	double clockRate_;
+	int64_t clockOffset_us_;
+	int syncMode_ = 0;
+	uint32_t syncRate_Hz_ = 10;
+	sync_discipline_t discipline_;
+	int64_t nextSyncPulse_us_ = 0;
+	size_t syncLineCursor_ = 0;
+	std::vector<std::chrono::steady_clock::time_point> syncEdges_;
+
+	/* live trigger log stream */
+	bool streaming_ = false;
+	uint32_t streamSequence_ = 0;
+	int64_t nextStream_us_ = 0;
+
+	void run();
+	void receive(const char* data, size_t size);
+	void handleFrame(const std::string& frame);
+	void advanceGenerator();
+	void countPulse(double edgeTime_us);
+	void addRecord(bool manual, double edgeTime_us);
+	void startTimeSync(int mode, uint32_t rate_Hz);
+	void advanceTimeSync();
+	void addSyncPulse(int64_t localTime_us);
+	void advanceStream();
+	void reply(const char* format, ...) __attribute__((format(printf, 2, 3)));
+	int64_t now_us() const;
+	int64_t toLocalTime_us(std::chrono::steady_clock::time_point time) const;
+	std::chrono::steady_clock::time_point fromLocalTime_us(int64_t localTime_us) const;
+};
+
+} // namespace sarsync
+
+#endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	TriggerLog.h
+
+  Abstract:
+
+	The host side decoder of the trigger log readout
+*/
+
+#ifndef SARSYNC_TRIGGER_LOG_H
+#define SARSYNC_TRIGGER_LOG_H
+
+#include <sarsync/Frame.h>
+
+namespace sarsync {
+
+/* A single trigger record, the same fields as trigger_record_t of the firmware */
+struct TriggerRecord {
+	uint32_t index;				// trigger number since the last clear
+	int32_t position;			// pulse position of the trigger
+	int64_t time_us;			// device time of the trigger
+	uint32_t edgeTicks;			// capture time of the counted edge (12.5 ns ticks)
+	uint32_t triggerTicks;		// capture time of the trigger edge (12.5 ns ticks)
+	uint32_t edgeToTrigger_ns;	// delay from the counted edge to the trigger edge
+	int64_t syncTime_us = -1;	// time of the trigger in the sync time of the board array (-1: not synchronized)
+	int32_t positionY = 0;		// Y axis position of the trigger
+};
+
+/* A complete trigger log readout */
+struct TriggerLog {
+	std::vector<TriggerRecord> records;
+	uint32_t dropped = 0;		// records lost on the device because the log was full
+};
+
+/*
+	Decodes the readout of $LOG# and the live stream of $LGS1#
+	$TRG<index>,<position>,<time_us>,<edgeTicks>,<triggerTicks>,<edgeToTrigger_ns>,<syncTime_us>,<positionY>#	(per record)
+	$TRE<numRecords>,<dropped>#																				(end)
+	$TRZ<sequence>,<numRecords>,<dropped>,<base64 payload>#													(stream block)
+	Records of firmware without the time sync have no sync time, records of firmware without the Y axis no Y position.
+	A stream block holds delta and zigzag varint coded records, see TriggerCodec.h of the firmware.
+*/
+class TriggerLogDecoder {
+public:
+	/* Feed a frame, returns true when the readout is complete (never for stream blocks) */
+	bool feed(const Frame& frame);
+
+	/* The decoded log, valid when feed returned true */
+	const TriggerLog& log() const { return log_; }
+
+	/* Records that were announced by the end frame but not received */
+	uint32_t missingRecords() const { return missing_; }
+
+	/* Stream blocks lost in transport (gaps in the block sequence) */
+	uint32_t lostBlocks() const { return lostBlocks_; }
+
+	/* Start over for the next readout or stream */
+	void reset();
+
+private:
+	TriggerLog log_;
+	uint32_t missing_ = 0;
+	uint32_t lostBlocks_ = 0;
+	uint32_t nextSequence_ = 0;
+
+	void decodeBlock(const Frame& frame);
+};
+
+/* Decode the frames of a complete readout, throws std::invalid_argument on malformed records */
+TriggerLog decodeTriggerLog(const std::vector<Frame>& frames);
+
+/*
+	Decode a word of the index code output ($IDC1,<baud>#), the 5 bytes received by a UART decoder:
+	the trigger index (little endian) and a CRC-8 of the index bytes.
+	Returns false if the CRC does not match.
+*/
+bool decodeIndexCode(const uint8_t word[5], uint32_t& index);
+
+} // namespace sarsync
+
+#endif
\ No newline at end of file
@@ -0,0 +1,287 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	Client.cpp
+
+  Abstract:
+
+	The implementation file of the asynchronous host client
+*/
+
+#include <sarsync/Client.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace sarsync {
+
+Client::Client(const std::string& devicePath, int baudRate)
+    : port_(devicePath, baudRate)
+{
+    if (::pipe2(wakePipe_, O_NONBLOCK | O_CLOEXEC) != 0) {
+        throw std::system_error(errno, std::generic_category(), "pipe");
+    }
+    thread_ = std::thread(&Client::ioLoop, this);
+}
+
+Client::~Client()
+{
+    running_ = false;
+    wake();
+    thread_.join();
+    ::close(wakePipe_[0]);
+    ::close(wakePipe_[1]);
+}
+
+void Client::setEventHandler(EventHandler handler)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    eventHandler_ = std::move(handler);
+}
+
+void Client::send(const std::string& command, std::initializer_list<int64_t> parameters)
+{
+    enqueue(formatCommand(command, parameters), nullptr);
+}
+
+Client::QueryId Client::query(const std::string& command, std::initializer_list<int64_t> parameters,
+                std::vector<std::string> replyCommands, std::string endCommand, ReplyHandler handler)
+{
+    PendingQuery query;
+    query.replyCommands = std::move(replyCommands);
+    query.endCommand = std::move(endCommand);
+    query.handler = std::move(handler);
+    return enqueue(formatCommand(command, parameters), &query);
+}
+
+std::future<Client::Reply> Client::query(const std::string& command, std::initializer_list<int64_t> parameters,
+                std::vector<std::string> replyCommands, std::string endCommand)
+{
+    auto promise = std::make_shared<std::promise<Reply>>();
+    std::future<Reply> future = promise->get_future();
+    query(command, parameters, std::move(replyCommands), std::move(endCommand),
+        [promise](Reply reply) { promise->set_value(std::move(reply)); });
+    return future;
+}
+
+std::future<TriggerLog> Client::readTriggerLog()
+{
+    auto promise = std::make_shared<std::promise<TriggerLog>>();
+    std::future<TriggerLog> future = promise->get_future();
+    query("LOG", {}, {"TRG"}, "TRE", [promise](Reply reply) {
+        try {
+            promise->set_value(decodeTriggerLog(reply));
+        }
+        catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+
+std::future<Client::Reply> Client::readHealth()
+{
+    return query("HLT", {}, {"HQU", "HIS", "HTK", "HHP"}, "HLE");
+}
+
+std::future<Client::Reply> Client::listFlashLog()
+{
+    return query("FLL", {}, {"FLI"}, "FLE");
+}
+
+std::future<TriggerLog> Client::readFlashLog(uint16_t scanId)
+{
+    /* the scan comes back as blocks of the live stream, stop the stream first */
+    auto promise = std::make_shared<std::promise<TriggerLog>>();
+    std::future<TriggerLog> future = promise->get_future();
+    query("FLD", {scanId}, {"TRZ"}, "FDE", [promise](Reply reply) {
+        try {
+            promise->set_value(decodeTriggerLog(reply));
+        }
+        catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+
+bool Client::cancel(QueryId id)
+{
+    /* the handler is dropped outside of the lock, it may own a promise */
+    PendingQuery cancelled;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(pending_.begin(), pending_.end(), [id](const PendingQuery& query) { return query.id == id; });
+    if (it == pending_.end()) {
+        return false;
+    }
+    cancelled = std::move(*it);
+    pending_.erase(it);
+    return true;
+}
+
+void Client::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    flushed_.wait(lock, [this] { return txBuffer_.empty() || failed_; });
+}
+
+ClientStatistics Client::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+Client::QueryId Client::enqueue(const std::string& frame, PendingQuery* pQuery)
+{
+    QueryId id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (failed_) {
+            throw std::system_error(EIO, std::generic_category(), "the device is gone");
+        }
+
+        /* the query is queued with its frame, so the replies come back in the same order */
+        txBuffer_ += frame;
+        if (pQuery != nullptr) {
+            id = nextQueryId_++;
+            pQuery->id = id;
+            pending_.push_back(std::move(*pQuery));
+        }
+    }
+    wake();
+    return id;
+}
+
+void Client::wake()
+{
+    char c = 0;
+    (void)!::write(wakePipe_[1], &c, 1);
+}
+
+void Client::ioLoop()
+{
+    FrameParser parser;
+    std::vector<Frame> frames;
+    char rxBuffer[1024];
+
+    try {
+        while (running_) {
+            bool txPending;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                txPending = !txBuffer_.empty();
+            }
+
+            struct pollfd fds[2] = {
+                { port_.fd(), static_cast<short>(POLLIN | (txPending ? POLLOUT : 0)), 0 },
+                { wakePipe_[0], POLLIN, 0 },
+            };
+            if (::poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "poll");
+            }
+
+            /* drain the wake ups */
+            if (fds[1].revents & POLLIN) {
+                while (::read(wakePipe_[0], rxBuffer, sizeof(rxBuffer)) > 0) {
+                }
+            }
+
+            /* write as much as the device takes */
+            if (fds[0].revents & POLLOUT) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                size_t written = port_.writeSome(txBuffer_.data(), txBuffer_.size());
+                txBuffer_.erase(0, written);
+                statistics_.bytesSent += written;
+                if (txBuffer_.empty()) {
+                    flushed_.notify_all();
+                }
+            }
+
+            if (fds[0].revents & POLLIN) {
+                size_t received = port_.readSome(rxBuffer, sizeof(rxBuffer));
+                frames.clear();
+                parser.feed(rxBuffer, received, frames);
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    statistics_.bytesReceived += received;
+                    statistics_.bytesSkipped = parser.skippedBytes();
+                }
+                for (Frame& frame : frames) {
+                    dispatch(frame);
+                }
+            }
+            else if (fds[0].revents & (POLLHUP | POLLERR)) {
+                throw std::system_error(EIO, std::generic_category(), "the device is gone");
+            }
+        }
+    }
+    catch (const std::exception&) {
+        fail();
+    }
+}
+
+void Client::dispatch(Frame& frame)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!pending_.empty()) {
+        PendingQuery& query = pending_.front();
+        if (frame.command == query.endCommand) {
+            /* complete the query outside of the lock, the handler may queue the next one */
+            query.reply.push_back(std::move(frame));
+            PendingQuery done = std::move(query);
+            pending_.pop_front();
+            statistics_.replyFrames++;
+            lock.unlock();
+            done.handler(std::move(done.reply));
+            return;
+        }
+        if (std::find(query.replyCommands.begin(), query.replyCommands.end(), frame.command) != query.replyCommands.end()) {
+            query.reply.push_back(std::move(frame));
+            statistics_.replyFrames++;
+            return;
+        }
+    }
+
+    statistics_.eventFrames++;
+    EventHandler handler = eventHandler_;
+    lock.unlock();
+    if (handler) {
+        handler(frame);
+    }
+}
+
+void Client::fail()
+{
+    /* dropping the open queries breaks their promises */
+    std::deque<PendingQuery> open;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        failed_ = true;
+        open.swap(pending_);
+        txBuffer_.clear();
+    }
+    flushed_.notify_all();
+}
+
+} // namespace sarsync
\ No newline at end of file
@@ -0,0 +1,214 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	ClockSync.cpp
+
+  Abstract:
+
+	The implementation file of the host clock sync
+*/
+
+#include <sarsync/ClockSync.h>
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace sarsync {
+
+/* Samples whose round trip is below this margin above the shortest one are as good as the shortest */
+static constexpr int64_t kRoundTripMargin_us = 100;
+
+/* The drift needs samples at least this far apart */
+static constexpr double kMinDriftSpan_us = 1e6;
+
+int64_t hostNow_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void ClockEstimator::addSample(const ClockSample& sample)
+{
+    /* a reply to a lost or repeated command */
+    if (sample.roundTrip_us() < 0) {
+        return;
+    }
+    samples_.push_back(sample);
+    while (samples_.size() > windowSize_) {
+        samples_.pop_front();
+    }
+
+    /* the shortest round trips: at least half of the window and every sample close to the shortest */
+    std::vector<ClockSample> best(samples_.begin(), samples_.end());
+    std::sort(best.begin(), best.end(), [](const ClockSample& a, const ClockSample& b) {
+        return a.roundTrip_us() < b.roundTrip_us();
+    });
+    int64_t minRoundTrip_us = best.front().roundTrip_us();
+    size_t numBest = (best.size() + 1) / 2;
+    while (numBest < best.size() && best[numBest].roundTrip_us() <= minRoundTrip_us + kRoundTripMargin_us) {
+        numBest++;
+    }
+    best.resize(numBest);
+
+    /* fit the offset over the device time, relative to the newest sample */
+    const ClockSample& newest = samples_.back();
+    int64_t reference_us = newest.deviceReceive_us + (newest.deviceTransmit_us - newest.deviceReceive_us) / 2;
+    double sumX = 0.0, sumY = 0.0, minX = 0.0, maxX = 0.0;
+    for (size_t i = 0; i < best.size(); i++) {
+        double x = static_cast<double>(best[i].deviceReceive_us + (best[i].deviceTransmit_us - best[i].deviceReceive_us) / 2 - reference_us);
+        sumX += x;
+        sumY += best[i].offset_us();
+        minX = (i == 0) ? x : std::min(minX, x);
+        maxX = (i == 0) ? x : std::max(maxX, x);
+    }
+    double meanX = sumX / best.size();
+    double meanY = sumY / best.size();
+    double slope = 0.0;
+    if (maxX - minX >= kMinDriftSpan_us) {
+        double sumXX = 0.0, sumXY = 0.0;
+        for (const ClockSample& s : best) {
+            double x = static_cast<double>(s.deviceReceive_us + (s.deviceTransmit_us - s.deviceReceive_us) / 2 - reference_us) - meanX;
+            sumXX += x * x;
+            sumXY += x * (s.offset_us() - meanY);
+        }
+        slope = sumXY / sumXX;
+    }
+    else if (estimate_.valid) {
+        /* too short to measure, keep the last drift */
+        slope = estimate_.drift_ppm * 1e-6;
+    }
+
+    estimate_.valid = true;
+    estimate_.deviceReference_us = reference_us;
+    estimate_.offset_us = meanY - slope * meanX;
+    estimate_.drift_ppm = slope * 1e6;
+    estimate_.maxError_us = minRoundTrip_us / 2;
+    estimate_.numSamples = samples_.size();
+}
+
+bool ClockEstimator::toHostTime(int64_t deviceTime_us, int64_t& hostTime_us) const
+{
+    if (!estimate_.valid) {
+        return false;
+    }
+    double elapsed_us = static_cast<double>(deviceTime_us - estimate_.deviceReference_us);
+    double offset_us = estimate_.offset_us + elapsed_us * estimate_.drift_ppm * 1e-6;
+    hostTime_us = deviceTime_us - static_cast<int64_t>(offset_us + (offset_us >= 0 ? 0.5 : -0.5));
+    return true;
+}
+
+void ClockEstimator::reset()
+{
+    samples_.clear();
+    estimate_ = ClockEstimate();
+}
+
+ClockSync::ClockSync(Client& client, std::chrono::milliseconds period, size_t windowSize)
+    : client_(client), period_(period), estimator_(windowSize)
+{
+    thread_ = std::thread(&ClockSync::run, this);
+}
+
+ClockSync::~ClockSync()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    stop_.notify_all();
+    thread_.join();
+}
+
+bool ClockSync::exchange(std::chrono::milliseconds timeout)
+{
+    uint32_t tag;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tag = nextTag_;
+        nextTag_ = (nextTag_ + 1) & 0x7FFFFFFF;
+    }
+
+    /* the receive time is taken on the I/O thread as soon as the reply is split off */
+    auto promise = std::make_shared<std::promise<ClockSample>>();
+    std::future<ClockSample> future = promise->get_future();
+    int64_t hostSend_us = hostNow_us();
+    Client::QueryId id;
+    try {
+        id = client_.query("HCK", {static_cast<int64_t>(tag)}, {}, "HCR", [promise, tag, hostSend_us](Client::Reply reply) {
+            int64_t hostReceive_us = hostNow_us();
+            try {
+                const Frame& frame = reply.back();
+                if (frame.fields.size() != 3 || frame.integer(0) != static_cast<int64_t>(tag)) {
+                    throw std::invalid_argument("malformed clock exchange");
+                }
+                ClockSample sample;
+                sample.hostSend_us = hostSend_us;
+                sample.deviceReceive_us = frame.integer(1);
+                sample.deviceTransmit_us = frame.integer(2);
+                sample.hostReceive_us = hostReceive_us;
+                promise->set_value(sample);
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+
+    if (future.wait_for(timeout) != std::future_status::ready) {
+        /* a lost exchange must not hold the replies of the next queries */
+        client_.cancel(id);
+        return false;
+    }
+    try {
+        ClockSample sample = future.get();
+        std::lock_guard<std::mutex> lock(mutex_);
+        estimator_.addSample(sample);
+        return true;
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+ClockEstimate ClockSync::estimate() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return estimator_.estimate();
+}
+
+bool ClockSync::toHostTime(int64_t deviceTime_us, int64_t& hostTime_us) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return estimator_.toHostTime(deviceTime_us, hostTime_us);
+}
+
+void ClockSync::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        lock.unlock();
+        exchange();
+        lock.lock();
+        stop_.wait_for(lock, period_, [this] { return !running_; });
+    }
+}
+
+} // namespace sarsync
\ No newline at end of file
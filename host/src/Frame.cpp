@@ -0,0 +1,131 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	Frame.cpp
+
+  Abstract:
+
+	The implementation file of the host side framing
+*/
+
+#include <sarsync/Frame.h>
+
+#include <cctype>
+#include <stdexcept>
+
+namespace sarsync {
+
+static const char START_SYMBOL = '$';
+static const char STOP_SYMBOL = '#';
+static const size_t COMMAND_SIZE = 3;
+
+int64_t Frame::integer(size_t index) const
+{
+    const std::string& field = fields.at(index);
+    size_t end = 0;
+    int64_t value = std::stoll(field, &end, 10);
+    if (end != field.size()) {
+        throw std::invalid_argument("not an integer: " + field);
+    }
+    return value;
+}
+
+std::string formatCommand(const std::string& command, std::initializer_list<int64_t> parameters)
+{
+    std::string frame(1, START_SYMBOL);
+    frame += command;
+
+    const char* separator = "";
+    for (int64_t parameter : parameters) {
+        frame += separator;
+        frame += std::to_string(parameter);
+        separator = ",";
+    }
+    frame += STOP_SYMBOL;
+    return frame;
+}
+
+FrameParser::FrameParser(size_t maxFrameSize)
+    : maxFrameSize_(maxFrameSize)
+{
+    buffer_.reserve(maxFrameSize);
+}
+
+void FrameParser::feed(const char* data, size_t size, std::vector<Frame>& frames)
+{
+    for (size_t i = 0; i < size; i++) {
+        char c = data[i];
+
+        if (c == START_SYMBOL) {
+            /* a start symbol always starts over, the broken frame before it is lost */
+            skipped_ += buffer_.size();
+            buffer_.clear();
+            inFrame_ = true;
+        }
+        else if (!inFrame_) {
+            skipped_++;
+        }
+        else if (c == STOP_SYMBOL) {
+            finishFrame(frames);
+        }
+        else if (buffer_.size() >= maxFrameSize_ || c == '\r' || c == '\n') {
+            /* too long or interrupted by a line end */
+            skipped_ += buffer_.size() + 1;
+            buffer_.clear();
+            inFrame_ = false;
+        }
+        else {
+            buffer_ += c;
+        }
+    }
+}
+
+void FrameParser::finishFrame(std::vector<Frame>& frames)
+{
+    inFrame_ = false;
+
+    bool valid = buffer_.size() >= COMMAND_SIZE;
+    for (size_t i = 0; valid && i < COMMAND_SIZE; i++) {
+        valid = std::isupper(static_cast<unsigned char>(buffer_[i])) != 0;
+    }
+    if (!valid) {
+        skipped_ += buffer_.size() + 2;
+        buffer_.clear();
+        return;
+    }
+
+    Frame frame;
+    frame.command = buffer_.substr(0, COMMAND_SIZE);
+
+    /* split the fields, an empty parameter list has no fields */
+    size_t start = COMMAND_SIZE;
+    if (start < buffer_.size()) {
+        while (true) {
+            size_t comma = buffer_.find(',', start);
+            if (comma == std::string::npos) {
+                frame.fields.push_back(buffer_.substr(start));
+                break;
+            }
+            frame.fields.push_back(buffer_.substr(start, comma - start));
+            start = comma + 1;
+        }
+    }
+
+    frames.push_back(std::move(frame));
+    buffer_.clear();
+}
+
+} // namespace sarsync
\ No newline at end of file
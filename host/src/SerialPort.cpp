@@ -0,0 +1,106 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	SerialPort.cpp
+
+  Abstract:
+
+	The implementation file of the non-blocking serial port
+*/
+
+#include <sarsync/SerialPort.h>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <system_error>
+#include <termios.h>
+#include <unistd.h>
+
+namespace sarsync {
+
+static speed_t toSpeed(int baudRate)
+{
+    switch (baudRate) {
+        case 9600:      return B9600;
+        case 19200:     return B19200;
+        case 38400:     return B38400;
+        case 57600:     return B57600;
+        case 115200:    return B115200;
+        case 230400:    return B230400;
+        case 460800:    return B460800;
+        case 921600:    return B921600;
+        default:
+            throw std::system_error(EINVAL, std::generic_category(), "unsupported baud rate");
+    }
+}
+
+SerialPort::SerialPort(const std::string& devicePath, int baudRate)
+{
+    fd_ = ::open(devicePath.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot open " + devicePath);
+    }
+
+    /* raw 8N1, no flow control, no echo */
+    struct termios tty;
+    if (tcgetattr(fd_, &tty) != 0) {
+        int err = errno;
+        ::close(fd_);
+        throw std::system_error(err, std::generic_category(), "not a terminal: " + devicePath);
+    }
+    cfmakeraw(&tty);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tty.c_cflag &= ~CRTSCTS;
+    cfsetispeed(&tty, toSpeed(baudRate));
+    cfsetospeed(&tty, toSpeed(baudRate));
+    if (tcsetattr(fd_, TCSANOW, &tty) != 0) {
+        int err = errno;
+        ::close(fd_);
+        throw std::system_error(err, std::generic_category(), "cannot configure " + devicePath);
+    }
+    tcflush(fd_, TCIOFLUSH);
+}
+
+SerialPort::~SerialPort()
+{
+    ::close(fd_);
+}
+
+size_t SerialPort::readSome(char* data, size_t size)
+{
+    ssize_t n = ::read(fd_, data, size);
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return 0;
+        }
+        throw std::system_error(errno, std::generic_category(), "serial read");
+    }
+    return static_cast<size_t>(n);
+}
+
+size_t SerialPort::writeSome(const char* data, size_t size)
+{
+    ssize_t n = ::write(fd_, data, size);
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return 0;
+        }
+        throw std::system_error(errno, std::generic_category(), "serial write");
+    }
+    return static_cast<size_t>(n);
+}
+
+} // namespace sarsync
\ No newline at end of file
@@ -0,0 +1,433 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+/*
+  Module Name:
+
+	Simulator.cpp
+
+  Abstract:
+
+	The implementation file of the pseudo terminal simulator
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <sarsync/Simulator.h>
+
+#include <Protocol.h>
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <system_error>
+#include <termios.h>
+#include <unistd.h>
+
+namespace sarsync {
+
+/* The capture timer of the firmware runs at 80 MHz, the trigger follows the edge by 2 us */
+static constexpr uint32_t kTicksPerMicrosecond = 80;
+static constexpr uint32_t kEdgeToTriggerTicks = 160;
+static constexpr uint32_t kTickPeriod_ps = 12500;
+static constexpr int64_t kTaskLatency_us = 5;
+
+/* The live stream sends the new records every 20 ms like the firmware */
+static constexpr int64_t kStreamPeriod_us = 20000;
+
+/* The ROM boot message is the only text on the protocol UART, the ESP log is on UART1 */
+static constexpr const char* kRomBootMessage =
+    "ets Jun  8 2016 00:22:57\r\n\r\nrst:0x1 (POWERON_RESET),boot:0x13 (SPI_FAST_FLASH_BOOT)\r\n";
+
+void SyncLine::post(std::chrono::steady_clock::time_point edge)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    edges_.push_back(edge);
+}
+
+size_t SyncLine::read(size_t from, std::vector<std::chrono::steady_clock::time_point>& edges) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = from; i < edges_.size(); i++) {
+        edges.push_back(edges_[i]);
+    }
+    return edges_.size();
+}
+
+Simulator::Simulator(std::shared_ptr<SyncLine> syncLine, double clockDrift_ppm, int64_t clockOffset_us)
+    : start_(std::chrono::steady_clock::now()),
+      syncLine_(std::move(syncLine)), clockRate_(1.0 + clockDrift_ppm * 1e-6), clockOffset_us_(clockOffset_us)
+{
+    syncDisciplineReset(&discipline_, 0);
+
+    master_ = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if (master_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "posix_openpt");
+    }
+    if (::grantpt(master_) != 0 || ::unlockpt(master_) != 0) {
+        int err = errno;
+        ::close(master_);
+        throw std::system_error(err, std::generic_category(), "grantpt");
+    }
+    devicePath_ = ::ptsname(master_);
+
+    /*
+        Keep the slave side open in raw mode, otherwise the line discipline echoes and rewrites the frames
+        and the master reports a hang up between two clients
+    */
+    slave_ = ::open(devicePath_.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (slave_ < 0) {
+        int err = errno;
+        ::close(master_);
+        throw std::system_error(err, std::generic_category(), "cannot open " + devicePath_);
+    }
+    struct termios tty;
+    tcgetattr(slave_, &tty);
+    cfmakeraw(&tty);
+    tcsetattr(slave_, TCSANOW, &tty);
+
+    ::fcntl(master_, F_SETFL, ::fcntl(master_, F_GETFL) | O_NONBLOCK);
+    thread_ = std::thread(&Simulator::run, this);
+}
+
+Simulator::~Simulator()
+{
+    running_ = false;
+    thread_.join();
+    ::close(slave_);
+    ::close(master_);
+}
+
+void Simulator::run()
+{
+    char rxBuffer[1024];
+    txBuffer_ += kRomBootMessage;
+
+    while (running_) {
+        struct pollfd fds = { master_, static_cast<short>(POLLIN | (txBuffer_.empty() ? 0 : POLLOUT)), 0 };
+        if (::poll(&fds, 1, 1) < 0 && errno != EINTR) {
+            break;
+        }
+
+        if (fds.revents & POLLIN) {
+            ssize_t n = ::read(master_, rxBuffer, sizeof(rxBuffer));
+            if (n > 0) {
+                receive(rxBuffer, static_cast<size_t>(n));
+            }
+        }
+
+        advanceGenerator();
+        advanceTimeSync();
+        advanceStream();
+
+        if (!txBuffer_.empty()) {
+            ssize_t n = ::write(master_, txBuffer_.data(), txBuffer_.size());
+            if (n > 0) {
+                txBuffer_.erase(0, static_cast<size_t>(n));
+            }
+        }
+    }
+}
+
+void Simulator::receive(const char* data, size_t size)
+{
+    /* Collect the bytes from $ to # like the Uart task */
+    for (size_t i = 0; i < size; i++) {
+        char symbol = data[i];
+        if (symbol == PROTOCOL_START_SYMBOL) {
+            rxFrame_.clear();
+        }
+        else if (rxFrame_.empty()) {
+            continue;
+        }
+
+        if (rxFrame_.size() >= PROTOCOL_MIN_PACKET_SIZE + PROTOCOL_MAX_PARAMETER_SIZE) {
+            rxFrame_.clear();
+            continue;
+        }
+        rxFrame_ += symbol;
+
+        if (symbol == PROTOCOL_STOP_SYMBOL) {
+            handleFrame(rxFrame_);
+            rxFrame_.clear();
+        }
+    }
+}
+
+void Simulator::handleFrame(const std::string& packet)
+{
+    protocol_frame_t frame;
+    protocol_status_t status = protocolParseFrame(reinterpret_cast<const uint8_t*>(packet.data()),
+                                    static_cast<uint32_t>(packet.size()), &frame);
+    if (status != PROTOCOL_OK) {
+        /* an invalid packet is dropped without a reply */
+        return;
+    }
+
+    const int64_t receiveTime_us = now_us();
+    const int32_t* values = frame.parameters;
+    switch (frame.command) {
+        case PROTOCOL_COMMAND_RADAR_TRIGGER:
+            addRecord(true, static_cast<double>(now_us()));
+            break;
+
+        case PROTOCOL_COMMAND_CLEAR_NUM_TRIGGER:
+            numberOfTrigger_ = 0;
+            position_ = 0;
+            log_.clear();
+            dropped_ = 0;
+            break;
+
+        case PROTOCOL_COMMAND_SET_PULSE_COUNT:
+            if (values[0] > 0) {
+                spacing_ = values[0];
+            }
+            break;
+
+        case PROTOCOL_COMMAND_RESET_PCNT:
+            count_ = 0;
+            position_ = 0;
+            break;
+
+        case PROTOCOL_COMMAND_PAUSE_PCNT:
+            counting_ = false;
+            break;
+
+        case PROTOCOL_COMMAND_RESUME_PCNT:
+            counting_ = true;
+            break;
+
+        case PROTOCOL_COMMAND_PULSE_GENERATOR:
+            generating_ = (values[0] != 0);
+            generatorNextPulse_us_ = static_cast<double>(now_us());
+            break;
+
+        case PROTOCOL_COMMAND_PULSE_GENERATOR_CONFIG:
+            if (values[0] > 0) {
+                generatorHz_ = static_cast<uint32_t>(values[0]);
+            }
+            break;
+
+        case PROTOCOL_COMMAND_TIME_SYNC:
+            if (values[0] >= 0 && values[0] <= 2 && values[1] > 0 && values[1] <= 100) {
+                startTimeSync(values[0], static_cast<uint32_t>(values[1]));
+            }
+            break;
+
+        case PROTOCOL_COMMAND_STREAM_TRIGGER_LOG:
+            if (values[0] == 1 && !streaming_) {
+                streamSequence_ = 0;
+                nextStream_us_ = now_us();
+            }
+            streaming_ = (values[0] == 1);
+            break;
+
+        case PROTOCOL_COMMAND_READ_TRIGGER_LOG:
+            /* the log is taken by the live stream */
+            if (streaming_) {
+                reply("$TRE0,%u#\r\n", dropped_);
+                break;
+            }
+            for (const TriggerRecord& record : log_) {
+                reply("$TRG%u,%d,%lld,%u,%u,%u,%lld,%d#\r\n", record.index, record.position,
+                    static_cast<long long>(record.time_us), record.edgeTicks, record.triggerTicks, record.edgeToTrigger_ns,
+                    static_cast<long long>(record.syncTime_us), record.positionY);
+            }
+            reply("$TRE%u,%u#\r\n", static_cast<unsigned>(log_.size()), dropped_);
+            log_.clear();
+            break;
+
+        case PROTOCOL_COMMAND_READ_HEALTH:
+            reply("$HQU0,32,0,0#\r\n");
+            reply("$HIS0,%u#\r\n", numIsr_);
+            reply("$HTKUartTask,2048,1#\r\n");
+            reply("$HHP%u,%u,%u#\r\n", 120000u, 110000u, 90000u);
+            reply("$HLE#\r\n");
+            break;
+
+        case PROTOCOL_COMMAND_CLOCK_EXCHANGE:
+            reply("$HCR%d,%lld,%lld#\r\n", values[0], static_cast<long long>(receiveTime_us), static_cast<long long>(now_us()));
+            break;
+
+        default:
+            /* accepted without a model */
+            break;
+    }
+}
+
+void Simulator::advanceGenerator()
+{
+    if (!generating_) {
+        return;
+    }
+
+    /* the pulses of the elapsed time, each at its exact time */
+    double now = static_cast<double>(now_us());
+    while (generatorNextPulse_us_ <= now) {
+        countPulse(generatorNextPulse_us_);
+        generatorNextPulse_us_ += 1e6 / generatorHz_;
+    }
+}
+
+void Simulator::countPulse(double edgeTime_us)
+{
+    if (!counting_) {
+        return;
+    }
+    if (++count_ >= spacing_) {
+        count_ = 0;
+        numIsr_++;
+        addRecord(false, edgeTime_us);
+    }
+}
+
+void Simulator::addRecord(bool manual, double edgeTime_us)
+{
+    numberOfTrigger_++;
+    if (!manual) {
+        position_ += spacing_;
+    }
+
+    TriggerRecord record;
+    record.index = numberOfTrigger_;
+    record.position = position_;
+    /* the capture ticks are exact, the task reads the time a few microseconds after the edge */
+    uint32_t edgeTicks = static_cast<uint32_t>(static_cast<int64_t>(edgeTime_us * kTicksPerMicrosecond));
+    record.time_us = static_cast<int64_t>(edgeTime_us) + kTaskLatency_us;
+    record.edgeTicks = manual ? 0 : edgeTicks;
+    record.triggerTicks = edgeTicks + kEdgeToTriggerTicks;
+    record.edgeToTrigger_ns = manual ? 0 : kEdgeToTriggerTicks * kTickPeriod_ps / 1000;
+    if (!syncDisciplineToSyncTime(&discipline_, record.time_us, &record.syncTime_us)) {
+        record.syncTime_us = -1;
+    }
+
+    /* the records the host has not read yet are kept, the new one is dropped */
+    if (log_.size() == kLogCapacity) {
+        dropped_++;
+        return;
+    }
+    log_.push_back(record);
+}
+
+void Simulator::startTimeSync(int mode, uint32_t rate_Hz)
+{
+    syncMode_ = mode;
+    syncRate_Hz_ = rate_Hz;
+    syncDisciplineReset(&discipline_, SYNC_TICKS_PER_US * 1000000u / rate_Hz);
+
+    /* the master starts its pulse train one period later, a slave only takes the edges from now on */
+    nextSyncPulse_us_ = now_us() + 1000000 / rate_Hz;
+    if (syncLine_) {
+        syncEdges_.clear();
+        syncLineCursor_ = syncLine_->read(0, syncEdges_);
+        syncEdges_.clear();
+    }
+}
+
+void Simulator::advanceTimeSync()
+{
+    if (syncMode_ == 1) {
+        /* the hardware pulse train of the master, captured in loop back */
+        int64_t now = now_us();
+        while (nextSyncPulse_us_ <= now) {
+            if (syncLine_) {
+                syncLine_->post(fromLocalTime_us(nextSyncPulse_us_));
+            }
+            addSyncPulse(nextSyncPulse_us_);
+            nextSyncPulse_us_ += 1000000 / syncRate_Hz_;
+        }
+    }
+    else if (syncMode_ == 2 && syncLine_) {
+        syncEdges_.clear();
+        syncLineCursor_ = syncLine_->read(syncLineCursor_, syncEdges_);
+        for (auto edge : syncEdges_) {
+            addSyncPulse(toLocalTime_us(edge));
+        }
+    }
+}
+
+void Simulator::addSyncPulse(int64_t localTime_us)
+{
+    /* the capture is exact, the interrupt comes a few microseconds later */
+    uint32_t captureTicks = static_cast<uint32_t>(localTime_us * SYNC_TICKS_PER_US);
+    syncDisciplineAddPulse(&discipline_, captureTicks, localTime_us + 3);
+
+    if (discipline_.numPulses == 2 || (discipline_.numPulses % syncRate_Hz_) == 0) {
+        reply("$SYS%d,%u,%u,%u,%lld,%d#\r\n", syncMode_, discipline_.numPulses, discipline_.numMissed,
+            discipline_.numRejected, static_cast<long long>(syncDisciplineGetOffset(&discipline_)), discipline_.drift_ppb);
+    }
+}
+
+void Simulator::advanceStream()
+{
+    int64_t now = now_us();
+    if (!streaming_ || now < nextStream_us_) {
+        return;
+    }
+    nextStream_us_ = now + kStreamPeriod_us;
+
+    /* encode the log into blocks with the encoder of the firmware */
+    trigger_encoder_t encoder;
+    char frame[TRIGGER_CODEC_FRAME_SIZE];
+    triggerEncoderReset(&encoder);
+    while (!log_.empty()) {
+        const TriggerRecord& logged = log_.front();
+        trigger_record_t record = { logged.index, logged.position, logged.time_us,
+                                    logged.edgeTicks, logged.triggerTicks, logged.syncTime_us, logged.positionY };
+        if (!triggerEncoderAdd(&encoder, &record)) {
+            txBuffer_.append(frame, triggerEncoderFormat(&encoder, streamSequence_++, dropped_, frame, sizeof(frame)));
+            triggerEncoderReset(&encoder);
+            continue;
+        }
+        log_.pop_front();
+    }
+    if (encoder.numRecords > 0) {
+        txBuffer_.append(frame, triggerEncoderFormat(&encoder, streamSequence_++, dropped_, frame, sizeof(frame)));
+    }
+}
+
+void Simulator::reply(const char* format, ...)
+{
+    char buffer[128];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length > 0) {
+        txBuffer_.append(buffer, static_cast<size_t>(length) < sizeof(buffer) ? static_cast<size_t>(length) : sizeof(buffer) - 1);
+    }
+}
+
+int64_t Simulator::now_us() const
+{
+    return toLocalTime_us(std::chrono::steady_clock::now());
+}
+
+int64_t Simulator::toLocalTime_us(std::chrono::steady_clock::time_point time) const
+{
+    /* the local clock of the board runs off by its drift and started at its offset */
+    double elapsed_us = std::chrono::duration<double, std::micro>(time - start_).count();
+    return clockOffset_us_ + static_cast<int64_t>(elapsed_us * clockRate_);
+}
+
+std::chrono::steady_clock::time_point Simulator::fromLocalTime_us(int64_t localTime_us) const
+{
+    double elapsed_us = static_cast<double>(localTime_us - clockOffset_us_) / clockRate_;
+    return start_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::micro>(elapsed_us));
+}
+
+} // namespace sarsync
\ No newline at end of file
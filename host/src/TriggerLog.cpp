@@ -0,0 +1,202 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	TriggerLog.cpp
+
+  Abstract:
+
+	The implementation file of the trigger log decoder
+*/
+
+#include <sarsync/TriggerLog.h>
+
+#include <stdexcept>
+
+namespace sarsync {
+
+/* Decode base64 without padding */
+static std::vector<uint8_t> decodeBase64(const std::string& text)
+{
+    std::vector<uint8_t> data;
+    uint32_t group = 0;
+    int bits = 0;
+    for (char c : text) {
+        int value;
+        if (c >= 'A' && c <= 'Z')       value = c - 'A';
+        else if (c >= 'a' && c <= 'z')  value = c - 'a' + 26;
+        else if (c >= '0' && c <= '9')  value = c - '0' + 52;
+        else if (c == '+')              value = 62;
+        else if (c == '/')              value = 63;
+        else throw std::invalid_argument("malformed trigger stream block");
+
+        group = (group << 6) | static_cast<uint32_t>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            data.push_back(static_cast<uint8_t>(group >> bits));
+        }
+    }
+    return data;
+}
+
+/* Read a zigzag varint */
+static int64_t getVarint(const std::vector<uint8_t>& data, size_t& offset)
+{
+    uint64_t zigzag = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (offset >= data.size()) {
+            throw std::invalid_argument("truncated trigger stream block");
+        }
+        uint8_t byte = data[offset++];
+        zigzag |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        }
+    }
+    throw std::invalid_argument("malformed trigger stream block");
+}
+
+bool TriggerLogDecoder::feed(const Frame& frame)
+{
+    if (frame.command == "TRG") {
+        if (frame.fields.size() < 6 || frame.fields.size() > 8) {
+            throw std::invalid_argument("malformed trigger record");
+        }
+        TriggerRecord record;
+        record.index = static_cast<uint32_t>(frame.integer(0));
+        record.position = static_cast<int32_t>(frame.integer(1));
+        record.time_us = frame.integer(2);
+        record.edgeTicks = static_cast<uint32_t>(frame.integer(3));
+        record.triggerTicks = static_cast<uint32_t>(frame.integer(4));
+        record.edgeToTrigger_ns = static_cast<uint32_t>(frame.integer(5));
+        if (frame.fields.size() >= 7) {
+            record.syncTime_us = frame.integer(6);
+        }
+        if (frame.fields.size() == 8) {
+            record.positionY = static_cast<int32_t>(frame.integer(7));
+        }
+        log_.records.push_back(record);
+        return false;
+    }
+
+    if (frame.command == "TRZ") {
+        decodeBlock(frame);
+        return false;
+    }
+
+    if (frame.command == "TRE") {
+        if (frame.fields.size() != 2) {
+            throw std::invalid_argument("malformed trigger log end");
+        }
+        uint32_t numRecords = static_cast<uint32_t>(frame.integer(0));
+        log_.dropped = static_cast<uint32_t>(frame.integer(1));
+        missing_ = (numRecords > log_.records.size()) ? numRecords - static_cast<uint32_t>(log_.records.size()) : 0;
+        return true;
+    }
+
+    return false;
+}
+
+void TriggerLogDecoder::decodeBlock(const Frame& frame)
+{
+    if (frame.fields.size() != 4) {
+        throw std::invalid_argument("malformed trigger stream block");
+    }
+    uint32_t sequence = static_cast<uint32_t>(frame.integer(0));
+    uint32_t numRecords = static_cast<uint32_t>(frame.integer(1));
+    log_.dropped = static_cast<uint32_t>(frame.integer(2));
+    if (sequence > nextSequence_) {
+        lostBlocks_ += sequence - nextSequence_;
+    }
+    nextSequence_ = sequence + 1;
+
+    /* undo the predictions of the encoder, they start at zero in every block */
+    std::vector<uint8_t> data = decodeBase64(frame.fields[3]);
+    size_t offset = 0;
+    TriggerRecord last{};
+    last.syncTime_us = 0;
+    int64_t positionStep = 0, timeStep = 0, syncStep = 0, positionYStep = 0;
+    uint32_t edgeStep = 0, edgeToTrigger = 0;
+    for (uint32_t i = 0; i < numRecords; i++) {
+        /* the mask of the mispredicted fields, then their residuals */
+        if (offset >= data.size()) {
+            throw std::invalid_argument("truncated trigger stream block");
+        }
+        uint8_t mask = data[offset++];
+        int64_t residuals[7];
+        for (int field = 0; field < 7; field++) {
+            residuals[field] = (mask & (1 << field)) ? getVarint(data, offset) : 0;
+        }
+
+        TriggerRecord record;
+        record.index = static_cast<uint32_t>(last.index + 1 + residuals[0]);
+        record.position = static_cast<int32_t>(last.position + positionStep + residuals[1]);
+        record.time_us = last.time_us + timeStep + residuals[2];
+        record.edgeTicks = last.edgeTicks + edgeStep + static_cast<uint32_t>(residuals[3]);
+        record.triggerTicks = record.edgeTicks + edgeToTrigger + static_cast<uint32_t>(residuals[4]);
+        record.syncTime_us = last.syncTime_us + syncStep + residuals[5];
+        record.positionY = static_cast<int32_t>(last.positionY + positionYStep + residuals[6]);
+        record.edgeToTrigger_ns = (record.edgeTicks != 0) ? (record.triggerTicks - record.edgeTicks) * 25ull / 2 : 0;
+
+        positionStep = static_cast<int64_t>(record.position) - last.position;
+        timeStep = record.time_us - last.time_us;
+        edgeStep = record.edgeTicks - last.edgeTicks;
+        edgeToTrigger = record.triggerTicks - record.edgeTicks;
+        syncStep = record.syncTime_us - last.syncTime_us;
+        positionYStep = static_cast<int64_t>(record.positionY) - last.positionY;
+        last = record;
+        log_.records.push_back(record);
+    }
+    if (offset != data.size()) {
+        throw std::invalid_argument("malformed trigger stream block");
+    }
+}
+
+void TriggerLogDecoder::reset()
+{
+    log_ = TriggerLog();
+    missing_ = 0;
+    lostBlocks_ = 0;
+    nextSequence_ = 0;
+}
+
+bool decodeIndexCode(const uint8_t word[5], uint32_t& index)
+{
+    /* CRC-8, polynomial 0x07, initial value 0 */
+    uint8_t crc = 0;
+    for (int i = 0; i < 4; i++) {
+        crc ^= word[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+    if (crc != word[4]) {
+        return false;
+    }
+    index = word[0] | (word[1] << 8) | (word[2] << 16) | (static_cast<uint32_t>(word[3]) << 24);
+    return true;
+}
+
+TriggerLog decodeTriggerLog(const std::vector<Frame>& frames)
+{
+    TriggerLogDecoder decoder;
+    for (const Frame& frame : frames) {
+        decoder.feed(frame);
+    }
+    return decoder.log();
+}
+
+} // namespace sarsync
\ No newline at end of file
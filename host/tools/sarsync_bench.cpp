@@ -0,0 +1,151 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	sarsync_bench.cpp
+
+  Abstract:
+
+	Measures the command round trip latency, the pipelined command throughput
+	and the link bandwidth per trigger of the text log and of the compressed stream
+	Usage: sarsync_bench [device [baud rate]]
+	Without a device the benchmark runs against the simulator
+*/
+
+#include <sarsync/Client.h>
+#include <sarsync/Simulator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr int kRoundTrips = 200;
+static constexpr int kPipelinedTriggers = 2000;
+static constexpr int kStreamDuration_ms = 1000;
+
+static double percentile(std::vector<double>& samples, double p)
+{
+    std::sort(samples.begin(), samples.end());
+    size_t index = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+    return samples[index];
+}
+
+int main(int argc, char** argv)
+{
+    std::unique_ptr<sarsync::Simulator> simulator;
+    std::string device;
+    int baudRate = 115200;
+    if (argc > 1) {
+        device = argv[1];
+        if (argc > 2) {
+            baudRate = std::atoi(argv[2]);
+        }
+    }
+    else {
+        simulator.reset(new sarsync::Simulator());
+        device = simulator->devicePath();
+    }
+
+    sarsync::Client client(device, baudRate);
+    std::mutex streamMutex;
+    sarsync::TriggerLogDecoder stream;
+    uint64_t numEvents = 0;
+    uint64_t streamBytes = 0;
+    client.setEventHandler([&](const sarsync::Frame& frame) {
+        numEvents++;
+        if (frame.command == "TRZ") {
+            std::lock_guard<std::mutex> lock(streamMutex);
+            stream.feed(frame);
+            streamBytes += 7;     // $TRZ, #, CR, LF
+            for (const std::string& field : frame.fields) {
+                streamBytes += field.size() + 1;
+            }
+        }
+    });
+
+    /* Round trip: an empty trigger log is the shortest query with a reply */
+    client.clearTriggers();
+    client.readTriggerLog().get();
+    std::vector<double> latencies_us;
+    for (int i = 0; i < kRoundTrips; i++) {
+        Clock::time_point start = Clock::now();
+        client.readTriggerLog().get();
+        latencies_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    std::printf("round trip (%d queries): p50 %.0f us, p90 %.0f us, p99 %.0f us, max %.0f us\n", kRoundTrips,
+        percentile(latencies_us, 0.50), percentile(latencies_us, 0.90),
+        percentile(latencies_us, 0.99), percentile(latencies_us, 1.0));
+
+    /* Throughput: queue the triggers back to back, the log query is the barrier */
+    client.clearTriggers();
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < kPipelinedTriggers; i++) {
+        client.trigger();
+    }
+    sarsync::TriggerLog log = client.readTriggerLog().get();
+    double elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+    uint32_t received = static_cast<uint32_t>(log.records.size()) + log.dropped;
+    std::printf("pipelined (%d triggers): %.0f commands/s, %u triggers seen, %u records kept\n",
+        kPipelinedTriggers, kPipelinedTriggers / elapsed_s, received, static_cast<unsigned>(log.records.size()));
+
+    /* Bandwidth per trigger: periodic triggers from the pulse generator, read as text and as a stream */
+    uint64_t textBytes = 0;
+    size_t textRecords = 0;
+    client.setPulseCount(100);
+    client.send("GEN", {1});
+    for (int i = 0; i < kStreamDuration_ms / 100; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        uint64_t before = client.statistics().bytesReceived;
+        textRecords += client.readTriggerLog().get().records.size();
+        textBytes += client.statistics().bytesReceived - before;
+    }
+    client.streamTriggerLog(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(kStreamDuration_ms));
+    client.send("GEN", {0});
+    client.streamTriggerLog(false);
+    client.readTriggerLog().get();
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        /* the streamed triggers are consecutive and 100 pulses apart */
+        const std::vector<sarsync::TriggerRecord>& records = stream.log().records;
+        size_t streamRecords = records.size();
+        size_t gaps = 0;
+        for (size_t i = 1; i < streamRecords; i++) {
+            if (records[i].index != records[i - 1].index + 1 || records[i].position != records[i - 1].position + 100) {
+                gaps++;
+            }
+        }
+        if (textRecords > 0 && streamRecords > 0) {
+            double textPerRecord = static_cast<double>(textBytes) / textRecords;
+            double streamPerRecord = static_cast<double>(streamBytes) / streamRecords;
+            std::printf("log bandwidth: %.1f bytes per trigger as text, %.1f compressed (%.1fx, %zu streamed, %zu gaps, %u blocks lost)\n",
+                textPerRecord, streamPerRecord, textPerRecord / streamPerRecord, streamRecords, gaps, stream.lostBlocks());
+        }
+    }
+
+    sarsync::ClientStatistics stats = client.statistics();
+    std::printf("traffic: %llu bytes sent, %llu received, %llu skipped, %llu events\n",
+        static_cast<unsigned long long>(stats.bytesSent), static_cast<unsigned long long>(stats.bytesReceived),
+        static_cast<unsigned long long>(stats.bytesSkipped), static_cast<unsigned long long>(numEvents));
+
+    return (received == static_cast<uint32_t>(kPipelinedTriggers)) ? 0 : 1;
+}
\ No newline at end of file
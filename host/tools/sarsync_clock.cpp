@@ -0,0 +1,107 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+
+/*
+  Module Name:
+
+	sarsync_clock.cpp
+
+  Abstract:
+
+	Checks the mapping of the trigger times to the host wall clock: the board is triggered
+	at known host times and the mapped times of the trigger records are compared
+	Usage: sarsync_clock [device [baud rate]]
+	Without a device the check runs against a simulator whose clock is off by 40 ppm
+*/
+
+#include <sarsync/Client.h>
+#include <sarsync/ClockSync.h>
+#include <sarsync/Simulator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static constexpr int kNumTriggers = 20;
+static constexpr int kSettle_ms = 3000;
+static constexpr int64_t kMaxError_us = 1000;
+
+int main(int argc, char** argv)
+{
+    std::unique_ptr<sarsync::Simulator> simulator;
+    std::string device;
+    int baudRate = 115200;
+    if (argc > 1) {
+        device = argv[1];
+        if (argc > 2) {
+            baudRate = std::atoi(argv[2]);
+        }
+    }
+    else {
+        simulator.reset(new sarsync::Simulator(nullptr, 40.0, 123456789));
+        device = simulator->devicePath();
+    }
+
+    sarsync::Client client(device, baudRate);
+    sarsync::ClockSync clockSync(client, std::chrono::milliseconds(100));
+    client.clearTriggers();
+    std::this_thread::sleep_for(std::chrono::milliseconds(kSettle_ms));
+
+    sarsync::ClockEstimate estimate = clockSync.estimate();
+    std::printf("%zu exchanges: offset %.0f us, drift %.2f ppm, error bound %lld us\n", estimate.numSamples,
+        estimate.offset_us, estimate.drift_ppm, static_cast<long long>(estimate.maxError_us));
+
+    /* each trigger command is sent between two host times */
+    std::vector<int64_t> sent_us, written_us;
+    for (int i = 0; i < kNumTriggers; i++) {
+        sent_us.push_back(sarsync::hostNow_us());
+        client.trigger();
+        client.flush();
+        written_us.push_back(sarsync::hostNow_us());
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    sarsync::TriggerLog log = client.readTriggerLog().get();
+    if (log.records.size() != static_cast<size_t>(kNumTriggers)) {
+        std::printf("FAIL: %zu records\n", log.records.size());
+        return 1;
+    }
+
+    /* the distance of the mapped trigger time from the window of its command */
+    int64_t maxError_us = 0;
+    for (size_t i = 0; i < log.records.size(); i++) {
+        int64_t mapped_us;
+        if (!clockSync.toHostTime(log.records[i].time_us, mapped_us)) {
+            std::printf("FAIL: no clock estimate\n");
+            return 1;
+        }
+        int64_t error_us = 0;
+        if (mapped_us < sent_us[i]) {
+            error_us = sent_us[i] - mapped_us;
+        }
+        else if (mapped_us > written_us[i]) {
+            error_us = mapped_us - written_us[i];
+        }
+        maxError_us = std::max(maxError_us, error_us);
+    }
+
+    /* the error includes the time the device takes to handle the trigger command */
+    std::printf("%zu triggers: mapped host time outside of the command window by up to %lld us\n",
+        log.records.size(), static_cast<long long>(maxError_us));
+    bool passed = (maxError_us <= kMaxError_us);
+    std::printf("%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
\ No newline at end of file
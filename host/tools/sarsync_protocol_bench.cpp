@@ -0,0 +1,124 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+/*
+  Module Name:
+
+	sarsync_protocol_bench.cpp
+
+  Abstract:
+
+	Measures the packet parser in frames per second and ns per frame, for one valid
+	packet of every command and for a set of malformed packets
+	Usage: sarsync_protocol_bench [iterations [max ns per frame]]
+	With a limit, the exit code is 1 when either set parses slower
+*/
+
+#include <Protocol.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr long kDefaultIterations = 20000;
+
+/* One packet of every command, the number of parameters is found by trying */
+static std::vector<std::string> validPackets()
+{
+    std::vector<std::string> packets;
+    protocol_frame_t frame;
+
+    for (int command = 0; command < PROTOCOL_COMMAND_COUNT; command++) {
+        std::string parameters;
+        for (int i = 0; i <= PROTOCOL_MAX_PARAMETERS; i++) {
+            std::string packet = std::string("$") + protocolCommandName(static_cast<protocol_command_t>(command)) + parameters + "#";
+            if (protocolParseFrame(reinterpret_cast<const uint8_t*>(packet.data()), packet.size(), &frame) == PROTOCOL_OK) {
+                packets.push_back(packet);
+                break;
+            }
+            parameters += ((i == 0) ? "" : ",") + std::to_string(12345 * (i + 1));
+        }
+    }
+    return packets;
+}
+
+static std::vector<std::string> malformedPackets()
+{
+    return {
+        "$RT#",
+        "RTG##",
+        "$RTG$",
+        "$XYZ1#",
+        "$PLS#",
+        "$SCD3,#",
+        "$PLS2147483648#",
+        "$GRD1,2,3,4,5,6,7,8,9#",
+        "$SCP10,200,50,300,1,x#",
+    };
+}
+
+/* The parse time per packet in ns, over all packets of the set */
+static double measure(const std::vector<std::string>& packets, long iterations, int* pNumOk)
+{
+    protocol_frame_t frame;
+    int numOk = 0;
+
+    Clock::time_point start = Clock::now();
+    for (long n = 0; n < iterations; n++) {
+        for (const std::string& packet : packets) {
+            numOk += (protocolParseFrame(reinterpret_cast<const uint8_t*>(packet.data()), packet.size(), &frame) == PROTOCOL_OK);
+        }
+    }
+    double elapsed_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    *pNumOk = numOk;
+    return elapsed_ns / (static_cast<double>(iterations) * packets.size());
+}
+
+int main(int argc, char** argv)
+{
+    long iterations = (argc > 1) ? std::atol(argv[1]) : kDefaultIterations;
+    double limit_ns = (argc > 2) ? std::atof(argv[2]) : 0.0;
+    if (iterations <= 0) {
+        std::fprintf(stderr, "Usage: %s [iterations [max ns per frame]]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<std::string> valid = validPackets();
+    std::vector<std::string> malformed = malformedPackets();
+    int numOk;
+    bool failed = false;
+
+    double valid_ns = measure(valid, iterations, &numOk);
+    std::printf("valid:     %zu packets, %.1f ns/frame, %.2f Mframes/s\n", valid.size(), valid_ns, 1000.0 / valid_ns);
+    if (valid.size() != PROTOCOL_COMMAND_COUNT || numOk != iterations * static_cast<long>(valid.size())) {
+        std::printf("a valid packet was rejected\n");
+        failed = true;
+    }
+
+    double malformed_ns = measure(malformed, iterations, &numOk);
+    std::printf("malformed: %zu packets, %.1f ns/frame, %.2f Mframes/s\n", malformed.size(), malformed_ns, 1000.0 / malformed_ns);
+    if (numOk != 0) {
+        std::printf("a malformed packet was accepted\n");
+        failed = true;
+    }
+
+    if (limit_ns > 0.0 && (valid_ns > limit_ns || malformed_ns > limit_ns)) {
+        std::printf("slower than %.1f ns/frame\n", limit_ns);
+        failed = true;
+    }
+    return failed ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+/*
+  Module Name:
+
+	sarsync_sim.cpp
+
+  Abstract:
+
+	Runs the simulated synchronizer on a pseudo terminal until Ctrl-C
+	Usage: sarsync_sim
+*/
+
+#include <sarsync/Simulator.h>
+
+#include <csignal>
+#include <cstdio>
+#include <unistd.h>
+
+static volatile sig_atomic_t sStop = 0;
+
+static void onSignal(int)
+{
+    sStop = 1;
+}
+
+int main()
+{
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    sarsync::Simulator simulator;
+    std::printf("%s\n", simulator.devicePath().c_str());
+    std::fflush(stdout);
+
+    while (!sStop) {
+        ::pause();
+    }
+    return 0;
+}
\ No newline at end of file
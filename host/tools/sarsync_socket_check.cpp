@@ -0,0 +1,141 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+/*
+  Module Name:
+
+	sarsync_socket_check.cpp
+
+  Abstract:
+
+	Runs the socket server of the firmware against a loopback TCP/UDP client: packets split
+	over several segments, junk and an oversized packet between them, a reply, the events
+	before, during and after the connection
+	Usage: sarsync_socket_check, the exit code is 1 when a check fails
+*/
+
+#include <SocketServer.h>
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static bool failed = false;
+
+static void check(bool condition, const char* what)
+{
+    std::printf("%s: %s\n", condition ? "ok  " : "FAIL", what);
+    failed = failed || !condition;
+}
+
+static void collectFrame(const uint8_t* pFrame, uint32_t sizeInBytes, void* pContext)
+{
+    static_cast<std::vector<std::string>*>(pContext)->emplace_back(reinterpret_cast<const char*>(pFrame), sizeInBytes);
+}
+
+/* Read what arrives on a socket within the timeout */
+static std::string receive(int socketFd, int timeout_ms)
+{
+    struct pollfd fd = { socketFd, POLLIN, 0 };
+    char buffer[256];
+    if (::poll(&fd, 1, timeout_ms) <= 0) {
+        return std::string();
+    }
+    ssize_t received = ::recv(socketFd, buffer, sizeof(buffer), 0);
+    return (received > 0) ? std::string(buffer, received) : std::string();
+}
+
+static uint16_t localPort(int socketFd)
+{
+    struct sockaddr_in address;
+    socklen_t addressLength = sizeof(address);
+    ::getsockname(socketFd, reinterpret_cast<struct sockaddr*>(&address), &addressLength);
+    return ntohs(address.sin_port);
+}
+
+int main()
+{
+    /* the host side: a UDP socket for the events, its port is given to the server */
+    struct sockaddr_in loopback = {};
+    loopback.sin_family = AF_INET;
+    loopback.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int eventSocket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (eventSocket < 0 || ::bind(eventSocket, reinterpret_cast<struct sockaddr*>(&loopback), sizeof(loopback)) != 0) {
+        std::perror("udp");
+        return 1;
+    }
+
+    /* the command port is picked by the system */
+    socket_server_t server;
+    if (socketServerOpen(&server, 0, localPort(eventSocket)) != 0) {
+        std::perror("socketServerOpen");
+        return 1;
+    }
+    check(socketServerSendEvent(&server, "$MVD1#\r\n", 8) == 0, "an event without a host is dropped");
+
+    std::vector<std::string> frames;
+    int acceptResult = -1;
+    std::thread serverThread([&] {
+        acceptResult = socketServerAccept(&server);
+        if (acceptResult == 0) {
+            socketServerReceive(&server, collectFrame, &frames);
+        }
+    });
+
+    int commandSocket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    loopback.sin_port = htons(localPort(server.listenSocket));
+    if (::connect(commandSocket, reinterpret_cast<struct sockaddr*>(&loopback), sizeof(loopback)) != 0) {
+        std::perror("connect");
+        return 1;
+    }
+    int noDelay = 1;
+    ::setsockopt(commandSocket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    /* every piece is its own segment, the pause lets the server receive them one by one */
+    const std::string oversized = "$" + std::string(2 * SOCKET_SERVER_FRAME_SIZE, 'A') + "#";
+    const std::vector<std::string> segments = {
+        "junk$RT", "G#", "$PLS1", "00#$CT", "G#\r\n", oversized, "$", "RST", "#",
+    };
+    for (const std::string& segment : segments) {
+        ::send(commandSocket, segment.data(), segment.size(), 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    /* the accept has set the event destination by now */
+    check(socketServerSendEvent(&server, "$MVD1#\r\n", 8) == 8, "an event is sent to the connected host");
+    check(receive(eventSocket, 1000) == "$MVD1#\r\n", "the event arrives on the event port");
+    check(socketServerSendReply(&server, "$SPR100,0#\r\n", 12) == 12, "a reply is sent");
+    check(receive(commandSocket, 1000) == "$SPR100,0#\r\n", "the reply arrives on the command connection");
+
+    /* the receive returns when the host disconnects */
+    ::close(commandSocket);
+    serverThread.join();
+
+    check(acceptResult == 0, "the host is accepted");
+    check(frames == std::vector<std::string>({ "$RTG#", "$PLS100#", "$CTG#", "$RST#" }),
+        "split packets are joined, junk and the oversized packet are dropped");
+    check(server.clientSocket < 0 && socketServerSendEvent(&server, "$MVD1#\r\n", 8) == 0,
+        "an event after the disconnect is dropped");
+
+    socketServerClose(&server);
+    ::close(eventSocket);
+    return failed ? 1 : 0;
+}
\ No newline at end of file
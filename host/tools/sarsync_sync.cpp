@@ -0,0 +1,114 @@
+/*
+	Copyright(C) 2018 The University of Texas at Dallas
+	Developed By: Muhammet Emin Yanik
+	Advisor: Prof. Murat Torlak
+	Department of Electrical and Computer Engineering
+
+	This work was supported by the Semiconductor Research Corporation (SRC) task 2712.029
+	through The University of Texas at Dallas' Texas Analog Center of Excellence (TxACE).
+
+	Redistributions and use of source must retain the above copyright notice
+	Redistributions in binary form must reproduce the above copyright notice
+*/
+/*
+  Module Name:
+
+	sarsync_sync.cpp
+
+  Abstract:
+
+	Checks the time sync of two boards: both are triggered at the same moment
+	and the sync times of the two trigger records are compared
+	Usage: sarsync_sync [master device slave device [rate Hz]]
+	Without devices the check runs against two simulators, the slave clock is off by 40 ppm
+*/
+
+#include <sarsync/Client.h>
+#include <sarsync/Simulator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+
+static constexpr int kNumTriggers = 20;
+static constexpr int64_t kMaxError_us = 1000;
+
+int main(int argc, char** argv)
+{
+    std::unique_ptr<sarsync::Simulator> master, slave;
+    std::string masterDevice, slaveDevice;
+    int rate_Hz = 10;
+    if (argc > 2) {
+        masterDevice = argv[1];
+        slaveDevice = argv[2];
+        if (argc > 3) {
+            rate_Hz = std::atoi(argv[3]);
+        }
+    }
+    else {
+        auto line = std::make_shared<sarsync::SyncLine>();
+        master.reset(new sarsync::Simulator(line));
+        slave.reset(new sarsync::Simulator(line, 40.0, 123456789));
+        masterDevice = master->devicePath();
+        slaveDevice = slave->devicePath();
+    }
+
+    sarsync::Client masterClient(masterDevice);
+    sarsync::Client slaveClient(slaveDevice);
+    slaveClient.setEventHandler([](const sarsync::Frame& frame) {
+        if (frame.command == "SYS" || frame.command == "SYL") {
+            std::printf("slave  $%s", frame.command.c_str());
+            for (const std::string& field : frame.fields) {
+                std::printf(" %s", field.c_str());
+            }
+            std::printf("\n");
+        }
+    });
+
+    /* the slave listens before the master sends its first pulse */
+    slaveClient.send("SYN", {2, rate_Hz});
+    slaveClient.flush();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    masterClient.send("SYN", {1, rate_Hz});
+    masterClient.clearTriggers();
+    slaveClient.clearTriggers();
+    std::this_thread::sleep_for(std::chrono::milliseconds(3000));
+
+    /* trigger both boards at (nearly) the same moment */
+    for (int i = 0; i < kNumTriggers; i++) {
+        masterClient.trigger();
+        slaveClient.trigger();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    sarsync::TriggerLog masterLog = masterClient.readTriggerLog().get();
+    sarsync::TriggerLog slaveLog = slaveClient.readTriggerLog().get();
+
+    if (masterLog.records.size() != slaveLog.records.size() || masterLog.records.empty()) {
+        std::printf("FAIL: %zu master and %zu slave records\n", masterLog.records.size(), slaveLog.records.size());
+        return 1;
+    }
+
+    int64_t maxError_us = 0;
+    int64_t maxLocalError_us = 0;
+    for (size_t i = 0; i < masterLog.records.size(); i++) {
+        const sarsync::TriggerRecord& m = masterLog.records[i];
+        const sarsync::TriggerRecord& s = slaveLog.records[i];
+        if (m.syncTime_us < 0 || s.syncTime_us < 0) {
+            std::printf("FAIL: record %zu is not synchronized\n", i);
+            return 1;
+        }
+        maxError_us = std::max<int64_t>(maxError_us, std::llabs(s.syncTime_us - m.syncTime_us));
+        maxLocalError_us = std::max<int64_t>(maxLocalError_us, std::llabs(s.time_us - m.time_us));
+    }
+
+    /* the error includes the delay between the two trigger commands */
+    std::printf("%zu trigger pairs: local time difference up to %lld us, sync time difference up to %lld us\n",
+        masterLog.records.size(), static_cast<long long>(maxLocalError_us), static_cast<long long>(maxError_us));
+    bool passed = (maxError_us <= kMaxError_us);
+    std::printf("%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
\ No newline at end of file
@@ -23,12 +23,21 @@
 
 #include "Config.h"
 #include "Uart.h"
+#include "Transport.h"
+#include "SocketTransport.h"
+#include "Health.h"
 #include "RadarTrigger.h"
 #include "PulseCounter.h"
-
-#ifdef INTERNAL_TEST_MODE
-    #include "LedControl.h"
-#endif
+#include "PulseGenerator.h"
+#include "SelfTest.h"
+#include "MotionControl.h"
+#include "EdgeCapture.h"
+#include "ScanPlan.h"
+#include "SignalAnalyzer.h"
+#include "TimeSync.h"
+#include "TriggerLog.h"
+#include "IndexCode.h"
+#include "FlashLog.h"
 
 
 
@@ -40,7 +49,20 @@
      GPIO0 - pulse input pin,
      GPIO4 - radar trigger output pin.
 
-	 GPIO2 - LEDC output for internal test
+	 GPIO2 - RMT pulse generator output for internal test,
+	 GPIO21 - RMT pulse generator direction output for internal test.
+
+	 GPIO18 - step output of the built-in motion generator,
+	 GPIO19 - direction output of the built-in motion generator.
+
+	 GPIO25 - sync pulse output of the master board,
+	 GPIO26 - sync pulse input of a slave board.
+
+	 GPIO23 - serial index code of every trigger (optional).
+	 GPIO27 - gate input, e.g. the constant velocity output of the motion controller (optional).
+	 GPIO32 - Y axis pulse input, GPIO33 - Y axis direction input (optional).
+	 GPIO22 - diagnostic console output (UART1 TX), the protocol has UART0 to itself.
+	 GPIO13 - pass boundary input of multi-pass measurements, a home switch or a direction line (optional).
     
 	To use this code, you should connect the pulse output of the Motion Controller to GPIO4.
   
@@ -51,25 +73,103 @@
 void app_main(void)
 {
 	//-----------------------------------------------------
-	// Initialize LEDC to generate sample pulse signal
+	// Initialize the transport layer before any event
+	// can be sent to the host
+	//-----------------------------------------------------
+	transportInitialize();
+
+	//-----------------------------------------------------
+	// Initialize the health counters and the drop reporter
+	//-----------------------------------------------------
+	healthInitialize();
+
+	//-----------------------------------------------------
+	// Initialize the internal test pulse generator
+	// (idle until started by the Uart interface)
+	//-----------------------------------------------------
+	pulseGeneratorInitialize();
+
+	//-----------------------------------------------------
+	// Initialize the trigger index code output
+	// (off until enabled by the Uart interface)
 	//-----------------------------------------------------
-    #ifdef INTERNAL_TEST_MODE
-		ledcInitialize();
-	#endif
+	indexCodeInitialize();
 
 	//-----------------------------------------------------
 	// Initialize Radar Trigger to generate trigger signal
 	//-----------------------------------------------------
     radarTriggerInitialize();
 
+	//-----------------------------------------------------
+	// Initialize the Y axis counter before the trigger
+	// counter, its interrupt samples the Y position
+	//-----------------------------------------------------
+	pcntYInitialize();
+
 	//-----------------------------------------------------
 	// Initialize Pulse Counter to count pulses
 	//-----------------------------------------------------
 	pcntInitialize();
 
+	//-----------------------------------------------------
+	// Initialize the edge capture to timestamp the counted
+	// and the trigger edges
+	//-----------------------------------------------------
+	edgeCaptureInitialize();
+
+	//-----------------------------------------------------
+	// Initialize the encoder signal quality analyzer
+	//-----------------------------------------------------
+	signalAnalyzerInitialize();
+
+	//-----------------------------------------------------
+	// Initialize the multi-board time sync on the spare
+	// channels of the analyzer group (off until started)
+	//-----------------------------------------------------
+	timeSyncInitialize();
+
+	//-----------------------------------------------------
+	// Initialize the live trigger log stream
+	// (off until started by the host)
+	//-----------------------------------------------------
+	triggerStreamInitialize();
+
+	//-----------------------------------------------------
+	// Initialize the trigger log persistence on the
+	// triglog partition (off until started by the host)
+	//-----------------------------------------------------
+	flashLogInitialize();
+
+	//-----------------------------------------------------
+	// Initialize the loopback self-test
+	//-----------------------------------------------------
+	selfTestInitialize();
+
+	//-----------------------------------------------------
+	// Initialize the built-in step/direction motion generator
+	//-----------------------------------------------------
+	motionControlInitialize();
+
+	//-----------------------------------------------------
+	// Initialize the autonomous raster scan sequencer
+	//-----------------------------------------------------
+	scanPlanInitialize();
+
 	//-----------------------------------------------------
 	// Initialize Uart interface
 	//-----------------------------------------------------
     uartInitialize();
+
+#ifdef SOCKET_TRANSPORT_MODE
+	//-----------------------------------------------------
+	// Initialize the Wi-Fi socket interface
+	//-----------------------------------------------------
+	socketTransportInitialize();
+#endif
+
+	//-----------------------------------------------------
+	// Log the memory left after every task is created
+	//-----------------------------------------------------
+	healthLogMemory();
 	
 }
\ No newline at end of file
@@ -32,16 +32,50 @@
 #include <stdio.h>
 
 //-----------------------------------------------------------------------------
-// Common thread/task parameters
+// Task stack budget (bytes)
+// Every task stack, queue and semaphore is allocated statically, so the budget is part of
+// the static RAM of the build (see the memory report after each build) and cannot fail at runtime.
+// The stacks are sized from the local buffers and the deepest call of each task
+// (snprintf with 64-bit values and ESP_LOG take about 1 KB) plus at least 512 bytes of margin.
+// $HLT# reports the unused bytes of every stack ($HTK), check them after a change;
+// the health task reports a stack whose unused bytes fall below HEALTH_STACK_FLOOR_BYTES.
 //-----------------------------------------------------------------------------
-#define DEFAULT_TASK_STACK_SIZE_WORDS       1 * 1024
-#define DEFAULT_TASK_STACK_SIZE_BYTES       DEFAULT_TASK_STACK_SIZE_WORDS * sizeof(uint32_t)
+#define FLASH_LOG_TASK_STACK_SIZE_BYTES         3072
+#define HEALTH_TASK_STACK_SIZE_BYTES            2048
+#define MOTION_CONTROL_TASK_STACK_SIZE_BYTES    2560
+#define PULSE_GENERATOR_TASK_STACK_SIZE_BYTES   2048    // per generator instance (test and motion)
+#define RADAR_TRIGGER_TASK_STACK_SIZE_BYTES     3072
+#define SCAN_PLAN_TASK_STACK_SIZE_BYTES         2560
+#define SELF_TEST_TASK_STACK_SIZE_BYTES         3072
+#define SIGNAL_ANALYZER_TASK_STACK_SIZE_BYTES   3072
+#define SOCKET_TRANSPORT_TASK_STACK_SIZE_BYTES  4096    // lwIP socket calls (SOCKET_TRANSPORT_MODE only)
+#define TIME_SYNC_TASK_STACK_SIZE_BYTES         2560
+#define TRIGGER_STREAM_TASK_STACK_SIZE_BYTES    2560
+#define UART_TASK_STACK_SIZE_BYTES              4096    // runs the command handlers and their driver calls
 
-//-----------------------------------------------------------------------------
-// If the test mode is active, comment out this line
-// Then the pulse counter will work based on the internally created pulses
-//-----------------------------------------------------------------------------
-// #define INTERNAL_TEST_MODE
+/* The total of the application task stacks */
+#define TASK_STACK_BUDGET_BYTES     (FLASH_LOG_TASK_STACK_SIZE_BYTES + HEALTH_TASK_STACK_SIZE_BYTES + \
+                                    MOTION_CONTROL_TASK_STACK_SIZE_BYTES + \
+                                    2 * PULSE_GENERATOR_TASK_STACK_SIZE_BYTES + RADAR_TRIGGER_TASK_STACK_SIZE_BYTES + \
+                                    SCAN_PLAN_TASK_STACK_SIZE_BYTES + SELF_TEST_TASK_STACK_SIZE_BYTES + \
+                                    SIGNAL_ANALYZER_TASK_STACK_SIZE_BYTES + SOCKET_TRANSPORT_TASK_STACK_SIZE_BYTES + \
+                                    TIME_SYNC_TASK_STACK_SIZE_BYTES + TRIGGER_STREAM_TASK_STACK_SIZE_BYTES + \
+                                    UART_TASK_STACK_SIZE_BYTES)
+
+/* The data type to pass events from the PCNT interrupt to the radar trigger task */
+typedef struct {
+    int watchPoint;     // the watch point value that is reached
+    int spacing;        // the pulses since the previous trigger
+    int64_t time_us;    // the time when the watch point is reached
+    uint32_t edgeTicks; // the capture time of the counted edge
+    bool gateClosed;    // the gate input was inactive at the watch point
+    int32_t positionY;  // the Y axis position at the watch point
+    bool fired;         // the trigger handler has sent the pulse (false: gated)
+    uint32_t index;     // the trigger index of the pulse
+    int32_t position;   // the trigger position of the watch point
+    uint32_t unsent;    // the pulses of the previous burst that are cut short
+    int32_t latency_us; // from the watch point to the pulse
+} pcnt_evt_t;
 
 /* The data type to pass events from the Uart task to the radar trigger task */
 typedef struct {
@@ -49,10 +83,22 @@ typedef struct {
     uint32_t data; 	// the data for the Radar trigger task
 } uart_evt_t;
 
+/*
+	Notification value of the radar trigger task
+	The PCNT interrupt increments the pending watch point count in the lower bits,
+	the Uart task sets the top bit after queueing a command and
+	the pass boundary interrupt sets the bit below it
+*/
+#define RADAR_TRIGGER_NOTIFY_UART_BIT		(1UL << 31)
+#define RADAR_TRIGGER_NOTIFY_PASS_BIT		(1UL << 30)
+#define RADAR_TRIGGER_NOTIFY_COUNT_MASK		(RADAR_TRIGGER_NOTIFY_PASS_BIT - 1)
+
 enum eUART_RADAR_TRIGGER_COMMAND_SET {
 	UART_RADAR_TRIGGER_COMMAND = 1,
 	UART_DESIRED_NUM_TRIGGER_COMMAND,
 	UART_CLEAR_NUM_TRIGGER_COMMAND,
+	UART_NUM_MEASUREMENT_COMMAND,
+	UART_PASS_OFFSET_COMMAND,
 };
 
 #endif
\ No newline at end of file
@@ -21,19 +21,29 @@ classdef SarSyncApi
     
     %% Properties
     properties
-        serialPort   % Serial port object
+        serialPort   % Serial port object (or TCP client of the socket transport)
+        eventPort    % UDP port receiving the events of the socket transport
         uartQueueDelay_s = 0.1; % Extra 100 ms delay to process Uart command in the FW
     end
     
     %% Methods
     methods
         %% Constructor
-        function obj = SarSyncApi(port)
+        % SarSyncApi("COM3") connects over the UART
+        % SarSyncApi("192.168.1.50", "tcp") connects over Wi-Fi (TCP commands, UDP events)
+        function obj = SarSyncApi(port, transport)
             if nargin == 1
                 obj.serialPort = serialport(port,115200);
                 configureTerminator(obj.serialPort,"CR/LF")
                 flush(obj.serialPort)
                 configureCallback(obj.serialPort,"terminator",@readSerialData)
+            elseif nargin == 2 && transport == "tcp"
+                obj.serialPort = tcpclient(port,3333);
+                configureTerminator(obj.serialPort,"CR/LF")
+                configureCallback(obj.serialPort,"terminator",@readSerialData)
+                obj.eventPort = udpport("byte","LocalPort",3334);
+                configureTerminator(obj.eventPort,"CR/LF")
+                configureCallback(obj.eventPort,"terminator",@readSerialData)
             end
         end
         
@@ -55,12 +65,20 @@ classdef SarSyncApi
             pause(obj.uartQueueDelay_s)
         end
         
-        %% Set Pulse Count Command
+        %% Set Pulse Count Command (takes effect at the next trigger)
         function setPulseCount(obj, numPulses)
             write(obj.serialPort, "$PLS" + num2str(numPulses) + "#", "char")
             pause(obj.uartQueueDelay_s)
         end
         
+        %% Set Physical Spacing Command (absolute counter mode only)
+        % Replies $SPR<spacing in 1/1000 pulses>,<worst-case position error in nm>#,
+        % or $SPX1# (spacing out of range) / $SPX2# (not in the absolute mode) when rejected
+        function setPhysicalSpacing(obj, pulsesPerMeter, spacing_um)
+            write(obj.serialPort, "$SPU" + num2str(pulsesPerMeter) + "," + num2str(spacing_um) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
         %% Reset Pulse Counter Command
         function resetPcnt(obj)
             write(obj.serialPort, "$RST#", "char")
@@ -79,10 +97,243 @@ classdef SarSyncApi
             pause(obj.uartQueueDelay_s)
         end
         
-        %% Set Number of Measurement Command
+        %% Set Number of Measurement Command (passes over the same aperture, 0: end the sequence)
+        % Every pass boundary edge on GPIO13 starts the next pass from position zero, reported as
+        % $PSE<pass>,<firstIndex>,<triggers>,<lastPosition>,<duration_ms># and finally $MPE<completedPasses>,<aborted>#
+        % Set the pass boundary first, the command is rejected with $MPX2# otherwise
         function setNumMeasurement(obj, numMeasurement)
             write(obj.serialPort, "$MSR" + num2str(numMeasurement) + "#", "char")
             pause(obj.uartQueueDelay_s)
         end
+        
+        %% Set Multi-Pass Configuration Command
+        % Pass boundary (0: off, 1: rising edge, 2: falling edge, 3: every reversal) and
+        % the trigger offset added per pass in pulses (absolute mode only), rejected with $MPX1#
+        % when the last pass would move the first trigger beyond the counter range
+        function setPassConfig(obj, boundary, offset)
+            write(obj.serialPort, "$MPC" + num2str(boundary) + "," + num2str(offset) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Start/Stop Internal Pulse Generator Command
+        function pulseGenerator(obj, enable)
+            write(obj.serialPort, "$GEN" + num2str(enable) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Configure Internal Pulse Generator Command
+        function configurePulseGenerator(obj, maxFrequencyHz, jitterPercent, repeatCount)
+            write(obj.serialPort, "$PGF" + num2str(maxFrequencyHz) + "," + num2str(jitterPercent) + "," + num2str(repeatCount) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Clear Internal Pulse Generator Profile Command
+        function clearPulseProfile(obj)
+            write(obj.serialPort, "$PGC#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Add Internal Pulse Generator Profile Segment Command
+        % type: 0 = trapezoid (parameter: acceleration in Hz/s)
+        %       1 = burst     (parameter: gap after the burst in us)
+        %       2 = reversal  (parameter: dwell in us)
+        function addPulseSegment(obj, type, numPulses, frequencyHz, parameter)
+            write(obj.serialPort, "$PGA" + num2str(type) + "," + num2str(numPulses) + "," + num2str(frequencyHz) + "," + num2str(parameter) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Loopback Self-Test Command (short GPIO2 and GPIO0)
+        % Replies $STR<freq>,<expected>,<counted>,<handled>,<meanLatency_us>,<maxLatency_us>,<passed>#
+        % for each frequency and $STC<maxSustainableFreq># at the end
+        function selfTest(obj, startHz, stopHz, stepHz, numPulses)
+            write(obj.serialPort, "$STS" + num2str(startHz) + "," + num2str(stopHz) + "," + num2str(stepHz) + "," + num2str(numPulses) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Loopback Drift Test Command (mode 0: relative, 1: absolute)
+        % Replies $SDR<mode>,<expected>,<counted>,<handled>,<pulses>,<driftPulses>,<passed>#
+        function driftTest(obj, mode, spacing, numTriggers, frequencyHz)
+            write(obj.serialPort, "$SDT" + num2str(mode) + "," + num2str(spacing) + "," + num2str(numTriggers) + "," + num2str(frequencyHz) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Set Trigger Burst Command (pulses per position, interval in us; 1: no burst)
+        function setTriggerBurst(obj, numPulses, interval_us)
+            write(obj.serialPort, "$BST" + num2str(numPulses) + "," + num2str(interval_us) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Time Sync Command (0: off, 1: master, 2: slave; sync pulse rate in Hz)
+        % Start the slaves before the master, every board then reports
+        % $SYS<mode>,<pulses>,<missed>,<rejected>,<offset_us>,<drift_ppb>#
+        function timeSync(obj, mode, rateHz)
+            write(obj.serialPort, "$SYN" + num2str(mode) + "," + num2str(rateHz) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Set Counter Mode Command (0: relative, cleared at every trigger, 1: absolute)
+        function setCounterMode(obj, mode)
+            write(obj.serialPort, "$PCM" + num2str(mode) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Set Trigger Source Command (0: external encoder, 1: built-in step generator)
+        function setTriggerSource(obj, source)
+            write(obj.serialPort, "$MOD" + num2str(source) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Read Trigger Log Command
+        % Replies $TRG<index>,<position>,<time_us>,<edgeTicks>,<triggerTicks>,<edgeToTrigger_ns>,<syncTime_us>,<positionY>#
+        % for each trigger since the last read, followed by $TRE<numRecords>,<dropped>#
+        function readTriggerLog(obj)
+            write(obj.serialPort, "$LOG#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Stream Trigger Log Command (1: start, 0: stop)
+        % The new records are sent every 20 ms as compressed blocks
+        % $TRZ<sequence>,<numRecords>,<dropped>,<base64 payload>#, see TriggerCodec.h
+        function streamTriggerLog(obj, enable)
+            write(obj.serialPort, "$LGS" + num2str(enable) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Trigger Index Code Command (1: enable, 0: disable, baud rate)
+        % Every trigger index is sent on GPIO23 as 5 bytes in UART framing (8N1):
+        % the index (uint32, little endian) and a CRC-8 (polynomial 0x07)
+        function setIndexCode(obj, enable, baudRate)
+            write(obj.serialPort, "$IDC" + num2str(enable) + "," + num2str(baudRate) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Set Trigger Gate Command (0: off, 1: hold the count, 2: suppress the triggers)
+        function setGate(obj, mode, activeLevel)
+            write(obj.serialPort, "$GAT" + num2str(mode) + "," + num2str(activeLevel) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Set Trigger Window Command (positions in pulses, 0,0: no window)
+        function setGateWindow(obj, startPosition, endPosition)
+            write(obj.serialPort, "$GWN" + num2str(startPosition) + "," + num2str(endPosition) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Set 2D Trigger Grid Command (positions in pulses, 0 points: no grid)
+        function setTriggerGrid(obj, originX, originY, pitchX, pitchY, numX, numY, toleranceY)
+            write(obj.serialPort, "$GRD" + num2str(originX) + "," + num2str(originY) + "," + num2str(pitchX) + "," + ...
+                num2str(pitchY) + "," + num2str(numX) + "," + num2str(numY) + "," + num2str(toleranceY) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Reset Y Axis Position Command
+        function resetY(obj)
+            write(obj.serialPort, "$YRS#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Flash Log Record Command (1: start a new scan, 0: stop)
+        % The trigger records are kept in the triglog flash partition for scans without a host
+        function recordFlashLog(obj, enable)
+            write(obj.serialPort, "$FLR" + num2str(enable) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Flash Log List Command
+        % Replies $FLI<scanId>,<blocks>,<records># lines, oldest first,
+        % followed by $FLE<scans>,<usedSlots>,<totalSlots>,<dropped>#
+        function listFlashLog(obj)
+            write(obj.serialPort, "$FLL#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Flash Log Dump Command
+        % Sends the scan as $TRZ blocks (like streamTriggerLog), followed by $FDE<scanId>,<blocks>,<records>#
+        function dumpFlashLog(obj, scanId)
+            write(obj.serialPort, "$FLD" + num2str(scanId) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Flash Log Erase Command (not while recording)
+        % Sends $FLX<erasedSectors># when done, takes up to a few seconds
+        function eraseFlashLog(obj)
+            write(obj.serialPort, "$FLX#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Clock Exchange Command
+        % Replies $HCR<tag>,<receiveTime_us>,<transmitTime_us># in device time,
+        % take the host time before the write and after the reply
+        function exchangeClock(obj, tag)
+            write(obj.serialPort, "$HCK" + num2str(tag) + "#", "char")
+        end
+        
+        %% Read Runtime Health Command
+        % Replies $HQU<queue>,<capacity>,<highWater>,<dropped>#, $HIS<isr>,<count>#
+        % and $HTK<task>,<stackFree>,<cpuPermille># lines and
+        % $HHP<freeBytes>,<minFreeBytes>,<largestBlock>#, followed by $HLE#
+        function readHealth(obj)
+            write(obj.serialPort, "$HLT#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Set Input Glitch Filter Command (ns, 0: disabled)
+        function setGlitchFilter(obj, maxGlitch_ns)
+            write(obj.serialPort, "$FLT" + num2str(maxGlitch_ns) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Analyze Input Signal Command (0 edges: stop)
+        % Replies $ANS<edges>,<shortWidths>,<missedEdges>,<minHigh_ns>,<minLow_ns>,<minPeriod_ns>#
+        % and $ANW<histogram>,<bin0>,...,<bin19># lines
+        function analyzeSignal(obj, numEdges, shortThreshold_ns)
+            write(obj.serialPort, "$ANA" + num2str(numEdges) + "," + num2str(shortThreshold_ns) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Upload Raster Scan Plan Command
+        function setScanPlan(obj, numRows, numColumns, spacing, settle_ms, serpentine)
+            write(obj.serialPort, "$SCP" + num2str(numRows) + "," + num2str(numColumns) + "," + num2str(spacing) + "," + num2str(settle_ms) + "," + num2str(serpentine) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Set Raster Scan Row Direction Command (0: forward, 1: reverse)
+        function setScanRowDirection(obj, row, direction)
+            write(obj.serialPort, "$SCD" + num2str(row) + "," + num2str(direction) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Start/Abort Raster Scan Command
+        % Replies $ROS<row>,<direction># and $ROC<row>,<triggers>,<duration_ms># per row
+        % and $SCE<completedRows>,<aborted># at the end
+        function scan(obj, enable)
+            write(obj.serialPort, "$SCS" + num2str(enable) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Start/Stop Built-in Motion Command
+        % Replies $MVD<steps>,<encoderPulses># when the move is finished
+        function move(obj, enable)
+            write(obj.serialPort, "$MOV" + num2str(enable) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Configure Built-in Motion Profile Command
+        function configureMotion(obj, maxFrequencyHz, repeatCount)
+            write(obj.serialPort, "$MVF" + num2str(maxFrequencyHz) + ",0," + num2str(repeatCount) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Clear Built-in Motion Profile Command
+        function clearMotionProfile(obj)
+            write(obj.serialPort, "$MVC#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
+        
+        %% Add Built-in Motion Profile Segment Command (see addPulseSegment)
+        function addMotionSegment(obj, type, numSteps, frequencyHz, parameter)
+            write(obj.serialPort, "$MVA" + num2str(type) + "," + num2str(numSteps) + "," + num2str(frequencyHz) + "," + num2str(parameter) + "#", "char")
+            pause(obj.uartQueueDelay_s)
+        end
     end
 end
\ No newline at end of file